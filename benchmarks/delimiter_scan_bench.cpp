@@ -0,0 +1,98 @@
+// 帧分隔符扫描微基准
+// 在含大量 0xAB 干扰字节但没有完整帧头的缓冲区上扫描 (失步后的最坏情况)，
+// 对比编译期选定的实现与逐字节参考实现的吞吐量 (GB/s)
+
+#include "DelimiterScan.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace WhtsProtocol;
+
+namespace {
+
+constexpr uint8_t DELIMITER_1 = 0xAB;
+constexpr uint8_t DELIMITER_2 = 0xCD;
+
+// 生成噪声缓冲区: 随机字节，约 1/16 为 0xAB，但 0xAB 之后从不跟 0xCD
+std::vector<uint8_t> makeNoise(size_t size, std::mt19937 &rng) {
+    std::vector<uint8_t> buffer(size);
+    for (size_t i = 0; i < size; ++i) {
+        uint8_t value = static_cast<uint8_t>(rng());
+        if ((rng() & 0x0F) == 0)
+            value = DELIMITER_1;
+        if (i > 0 && buffer[i - 1] == DELIMITER_1 && value == DELIMITER_2)
+            value = 0;
+        buffer[i] = value;
+    }
+    return buffer;
+}
+
+using ScanFn = size_t (*)(const uint8_t *, size_t, uint8_t, uint8_t);
+
+// 返回 GB/s
+double measure(ScanFn scan, const std::vector<uint8_t> &buffer,
+               size_t iterations) {
+    volatile size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        sink = sink + scan(buffer.data(), buffer.size(), DELIMITER_1,
+                           DELIMITER_2);
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return static_cast<double>(buffer.size()) * iterations / seconds / 1e9;
+}
+
+// 随机缓冲区与随机起点上两种实现结果必须一致
+bool crossCheck(std::mt19937 &rng) {
+    for (int round = 0; round < 100000; ++round) {
+        size_t size = rng() % 200;
+        std::vector<uint8_t> buffer(size);
+        for (auto &byte : buffer) {
+            uint32_t r = rng() % 8;
+            byte = r == 0   ? DELIMITER_1
+                   : r == 1 ? DELIMITER_2
+                            : static_cast<uint8_t>(rng());
+        }
+        size_t offset = size ? rng() % size : 0;
+        const uint8_t *data = buffer.data() + offset;
+        if (Scan::findBytePair(data, size - offset, DELIMITER_1,
+                               DELIMITER_2) !=
+            Scan::findBytePairScalar(data, size - offset, DELIMITER_1,
+                                     DELIMITER_2)) {
+            std::printf("Mismatch at round %d (size %zu, offset %zu)\n",
+                        round, size, offset);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240601);
+
+    if (!crossCheck(rng))
+        return EXIT_FAILURE;
+
+    std::printf("Delimiter scan implementation: %s\n", Scan::implementation());
+    std::printf("%10s %14s %14s %8s\n", "buffer", "scalar GB/s",
+                "selected GB/s", "speedup");
+
+    // 单个小帧、典型数据报、接收缓冲区、大块失步数据
+    const size_t sizes[] = {64, 1472, 4096, 1 << 20};
+    for (size_t size : sizes) {
+        std::vector<uint8_t> buffer = makeNoise(size, rng);
+        size_t iterations = (size_t(1) << 30) / size;
+
+        double scalar = measure(Scan::findBytePairScalar, buffer, iterations);
+        double selected = measure(Scan::findBytePair, buffer, iterations);
+        std::printf("%10zu %14.2f %14.2f %7.1fx\n", size, scalar, selected,
+                    selected / scalar);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+// ProtocolProcessor 吞吐量基准
+// 覆盖三条热路径:
+//   decode     processReceivedData + getNextCompleteFrame，按载荷长度与
+//              帧间垃圾字节比例组合
+//   pack       packSlave2BackendMessage (含分片)，按载荷长度与 MTU 组合
+//   reassemble 分片帧的接收与重组，按载荷长度与 MTU 组合
+// 输出每秒帧数 (或消息数) 与 MB/s；可用第一个参数过滤场景名
+
+#include "Logger.h"
+#include "WhtsProtocol.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace WhtsProtocol;
+
+namespace {
+
+constexpr double MIN_SECONDS = 0.3;
+constexpr size_t DATAGRAM_SIZE = 1472; // 以太网 MTU 下的 UDP 载荷上限
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    double itemsPerSecond;
+    double megabytesPerSecond;
+};
+
+// 重复执行 round 直到累计时间超过 MIN_SECONDS
+// round 返回本轮处理的条目数，bytesPerRound 为每轮字节数
+template <typename Round>
+Result measure(Round round, size_t bytesPerRound) {
+    size_t items = 0;
+    size_t rounds = 0;
+    auto start = Clock::now();
+    double seconds = 0;
+    do {
+        items += round();
+        ++rounds;
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (seconds < MIN_SECONDS);
+
+    return {items / seconds, bytesPerRound * rounds / seconds / 1e6};
+}
+
+Slave2Backend::ConductionDataMessage makeMessage(size_t payloadSize,
+                                                 std::mt19937 &rng) {
+    Slave2Backend::ConductionDataMessage message;
+    message.conductionData.resize(payloadSize);
+    for (auto &byte : message.conductionData)
+        byte = static_cast<uint8_t>(rng());
+    message.conductionLength = static_cast<uint16_t>(payloadSize);
+    return message;
+}
+
+// 帧之间插入垃圾字节 (不含帧头分隔符)，garbageRatio 为垃圾占总字节的比例
+std::vector<uint8_t> makeStream(const std::vector<uint8_t> &frame,
+                                size_t frameCount, double garbageRatio,
+                                std::mt19937 &rng) {
+    size_t garbagePerFrame =
+        static_cast<size_t>(frame.size() * garbageRatio / (1 - garbageRatio));
+    std::vector<uint8_t> stream;
+    stream.reserve((frame.size() + garbagePerFrame) * frameCount);
+    for (size_t i = 0; i < frameCount; ++i) {
+        for (size_t j = 0; j < garbagePerFrame; ++j) {
+            uint8_t value = static_cast<uint8_t>(rng());
+            stream.push_back(value == 0xAB ? 0 : value);
+        }
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    return stream;
+}
+
+// 按数据报大小切块送入接收端，返回取出的完整帧数
+size_t feed(ProtocolProcessor &processor, const std::vector<uint8_t> &stream,
+            Frame &frame) {
+    size_t frames = 0;
+    for (size_t offset = 0; offset < stream.size(); offset += DATAGRAM_SIZE) {
+        size_t size = std::min(DATAGRAM_SIZE, stream.size() - offset);
+        processor.processReceivedData(ByteView(stream.data() + offset, size),
+                                      1);
+        while (processor.getNextCompleteFrame(frame))
+            ++frames;
+    }
+    return frames;
+}
+
+void printHeader(const char *scenario) {
+    std::printf("\n[%s]\n%8s %6s %8s %14s %10s\n", scenario, "payload", "mtu",
+                "garbage", "items/s", "MB/s");
+}
+
+void printRow(size_t payload, size_t mtu, double garbage, const Result &r) {
+    std::printf("%8zu %6zu %7.0f%% %14.0f %10.1f\n", payload, mtu,
+                garbage * 100, r.itemsPerSecond, r.megabytesPerSecond);
+}
+
+void benchDecode(std::mt19937 &rng) {
+    printHeader("decode");
+    const size_t payloads[] = {16, 64, 256, 1024};
+    const double garbageRatios[] = {0.0, 0.1, 0.5};
+    for (size_t payload : payloads) {
+        ProtocolProcessor packer;
+        packer.setMTU(DATAGRAM_SIZE);
+        auto frames = packer.packSlave2BackendMessage(
+            1, DeviceStatus(), makeMessage(payload, rng));
+        for (double garbage : garbageRatios) {
+            size_t frameCount = (1 << 20) / frames[0].size() + 1;
+            auto stream = makeStream(frames[0], frameCount, garbage, rng);
+
+            ProtocolProcessor receiver;
+            Frame frame;
+            Result r = measure([&] { return feed(receiver, stream, frame); },
+                               stream.size());
+            printRow(payload, DATAGRAM_SIZE, garbage, r);
+        }
+    }
+}
+
+void benchPack(std::mt19937 &rng) {
+    printHeader("pack");
+    const size_t payloads[] = {64, 256, 1024, 4096};
+    const size_t mtus[] = {100, 512, DATAGRAM_SIZE};
+    for (size_t payload : payloads) {
+        auto message = makeMessage(payload, rng);
+        for (size_t mtu : mtus) {
+            ProtocolProcessor packer;
+            packer.setMTU(mtu);
+            size_t bytes = 0;
+            for (const auto &f :
+                 packer.packSlave2BackendMessage(1, DeviceStatus(), message))
+                bytes += f.size();
+
+            const size_t batch = 256;
+            Result r = measure(
+                [&] {
+                    for (size_t i = 0; i < batch; ++i) {
+                        auto out = packer.packSlave2BackendMessage(
+                            1, DeviceStatus(), message);
+                        if (out.empty())
+                            std::abort();
+                    }
+                    return batch;
+                },
+                bytes * batch);
+            printRow(payload, mtu, 0, r);
+        }
+    }
+}
+
+void benchReassemble(std::mt19937 &rng) {
+    printHeader("reassemble");
+    const size_t payloads[] = {256, 1024, 4096};
+    const size_t mtus[] = {100, 512};
+    for (size_t payload : payloads) {
+        auto message = makeMessage(payload, rng);
+        for (size_t mtu : mtus) {
+            ProtocolProcessor packer;
+            packer.setMTU(mtu);
+            auto fragments =
+                packer.packSlave2BackendMessage(1, DeviceStatus(), message);
+            size_t bytes = 0;
+            for (const auto &f : fragments)
+                bytes += f.size();
+
+            // 每个分片作为一个数据报送入
+            ProtocolProcessor receiver;
+            Frame frame;
+            const size_t batch = 64;
+            Result r = measure(
+                [&] {
+                    size_t messages = 0;
+                    for (size_t i = 0; i < batch; ++i) {
+                        for (const auto &f : fragments)
+                            receiver.processReceivedData(ByteView(f), 1);
+                        while (receiver.getNextCompleteFrame(frame))
+                            ++messages;
+                    }
+                    if (messages != batch)
+                        std::abort();
+                    return messages;
+                },
+                bytes * batch);
+            printRow(payload, mtu, 0, r);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    // 垃圾数据与重同步会产生大量告警，基准中只保留错误日志
+    Log::setLogLevel(LogLevel::ERR);
+
+    const char *filter = argc > 1 ? argv[1] : nullptr;
+    auto enabled = [filter](const char *name) {
+        return filter == nullptr || std::strstr(name, filter) != nullptr;
+    };
+
+    std::mt19937 rng(20240601);
+    if (enabled("decode"))
+        benchDecode(rng);
+    if (enabled("pack"))
+        benchPack(rng);
+    if (enabled("reassemble"))
+        benchReassemble(rng);
+    return EXIT_SUCCESS;
+}
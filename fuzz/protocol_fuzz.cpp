@@ -0,0 +1,157 @@
+// ProtocolProcessor 模糊测试入口 (libFuzzer / AFL)
+// 输入第一个字节选择目标，其余字节为数据:
+//   0 接收路径: 按选择字节的高位切成数据报送入 processReceivedData 与
+//     processDatagram，取出的每个帧再按 PacketId 解析并重新序列化
+//   1 载荷解析: 把数据当作帧载荷交给所有 parse*Packet 重载
+//   2 单帧解析: FrameView::parse / Frame::deserialize
+//   3 采集数据解码: DataCodec::decode 与 DeltaDecoder
+// 任何输入都不应导致崩溃、越界或未定义行为
+
+#include "Logger.h"
+#include "WhtsProtocol.h"
+#include "utils/DataCodec.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace WhtsProtocol;
+
+namespace {
+
+// 序列化解码得到的消息，检查 serializedSize 与 serializeInto 一致
+template <typename Variant> void reserialize(const Variant &message) {
+    const Message *decoded = asMessage(message);
+    if (!decoded)
+        return;
+    std::vector<uint8_t> buffer(decoded->serializedSize());
+    if (decoded->serializeInto(buffer.data(), buffer.size()) != buffer.size())
+        std::abort();
+}
+
+void parsePayload(ProtocolProcessor &processor, ByteView payload) {
+    uint32_t id;
+    DeviceStatus status;
+    std::unique_ptr<Message> message;
+
+    Master2SlaveVariant master2Slave;
+    if (processor.parseMaster2SlavePacket(payload, id, master2Slave))
+        reserialize(master2Slave);
+    processor.parseMaster2SlavePacket(payload, id, message);
+
+    Slave2MasterVariant slave2Master;
+    if (processor.parseSlave2MasterPacket(payload, id, slave2Master))
+        reserialize(slave2Master);
+    processor.parseSlave2MasterPacket(payload, id, message);
+
+    Slave2BackendVariant slave2Backend;
+    if (processor.parseSlave2BackendPacket(payload, id, status, slave2Backend))
+        reserialize(slave2Backend);
+    processor.parseSlave2BackendPacket(payload, id, status, message);
+
+    Backend2MasterVariant backend2Master;
+    if (processor.parseBackend2MasterPacket(payload, backend2Master))
+        reserialize(backend2Master);
+    processor.parseBackend2MasterPacket(payload, message);
+
+    Master2BackendVariant master2Backend;
+    if (processor.parseMaster2BackendPacket(payload, master2Backend))
+        reserialize(master2Backend);
+    processor.parseMaster2BackendPacket(payload, message);
+}
+
+void fuzzReceive(uint8_t selector, ByteView data) {
+    ProtocolProcessor processor;
+    processor.setMTU(100);
+
+    // 数据报长度 1~64 字节，最后一段可以更短
+    size_t chunk = (selector >> 2) + 1;
+    Frame frame;
+    for (size_t offset = 0; offset < data.size(); offset += chunk) {
+        processor.processReceivedData(data.subview(offset, chunk),
+                                      offset & 1);
+        while (processor.getNextCompleteFrame(frame))
+            parsePayload(processor, ByteView(frame.payload));
+    }
+    // 空数据也必须安全处理
+    processor.processReceivedData(ByteView());
+    while (processor.getNextCompleteFrame(frame))
+        parsePayload(processor, ByteView(frame.payload));
+
+    // 数据报路径: 同样的切块交给两个发送方的独立解码器
+    PeerDecoders peers(2);
+    for (size_t offset = 0; offset < data.size(); offset += chunk) {
+        FrameDecoder &decoder = peers.get(offset & 1, offset);
+        decoder.processDatagram(data.subview(offset, chunk), offset & 1);
+        while (decoder.getNextCompleteFrame(frame))
+            parsePayload(processor, ByteView(frame.payload));
+    }
+}
+
+void fuzzFrame(ByteView data) {
+    FrameView view;
+    if (FrameView::parse(data, view) && view.totalSize() > data.size())
+        std::abort();
+
+    Frame frame;
+    if (Frame::deserialize(data, frame)) {
+        std::vector<uint8_t> serialized = frame.serialize();
+        Frame again;
+        if (!Frame::deserialize(ByteView(serialized), again))
+            std::abort();
+    }
+}
+
+void fuzzDataCodec(ByteView data) {
+    if (data.size() < 3)
+        return;
+    auto method = static_cast<DataCodec::Method>(data[0] & 0x03);
+    size_t length = data[1] | ((data[2] & 0x07) << 8);
+    std::vector<uint8_t> out(length);
+    DataCodec::decode(method, data.subview(3), out.data(), length);
+
+    // 先建立参考周期，再以同一载荷做差分解码
+    DataCodec::DeltaDecoder decoder;
+    DataCodec::EncodedHeader header;
+    header.encoding = static_cast<uint8_t>(data[0] & ~DataCodec::DELTA_FLAG);
+    header.sequence = data[1];
+    std::vector<uint8_t> decoded;
+    decoder.decode(header, data.subview(3), length, decoded);
+
+    header.encoding = static_cast<uint8_t>(data[0] | DataCodec::DELTA_FLAG);
+    header.baseSequence = data[1];
+    header.sequence = data[2];
+    decoder.decode(header, data.subview(3), length, decoded);
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    // 非法输入会产生大量告警，只保留错误日志
+    static const bool quiet = (Log::setLogLevel(LogLevel::ERR), true);
+    (void)quiet;
+
+    if (size == 0)
+        return 0;
+
+    uint8_t selector = data[0];
+    ByteView input(data + 1, size - 1);
+    switch (selector & 0x03) {
+    case 0:
+        fuzzReceive(selector, input);
+        break;
+    case 1: {
+        ProtocolProcessor processor;
+        parsePayload(processor, input);
+        break;
+    }
+    case 2:
+        fuzzFrame(input);
+        break;
+    default:
+        fuzzDataCodec(input);
+        break;
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+// 不使用 libFuzzer 时的入口: 依次以每个文件 (无参数时为标准输入) 的内容
+// 调用 LLVMFuzzerTestOneInput，可用于 AFL (afl-fuzz ... -- protocol_fuzz @@)
+// 或回放崩溃用例
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+namespace {
+
+void runInput(std::istream &in) {
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)),
+                              std::istreambuf_iterator<char>());
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        runInput(std::cin);
+        return 0;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "Cannot open %s\n", argv[i]);
+            return 1;
+        }
+        runInput(file);
+    }
+    return 0;
+}
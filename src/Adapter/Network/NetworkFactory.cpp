@@ -4,6 +4,10 @@
 #include "WindowsUdpSocket.h"
 #include <iostream>
 
+#ifdef __linux__
+#include "LinuxUdpSocket.h"
+#endif
+
 namespace Adapter {
 
 PlatformType NetworkFactory::getCurrentPlatform() {
@@ -31,8 +35,14 @@ std::unique_ptr<IUdpSocketFactory>
 NetworkFactory::createUdpSocketFactory(PlatformType platform) {
     switch (platform) {
     case PlatformType::WINDOWS:
+        return std::make_unique<Platform::Windows::WindowsUdpSocketFactory>();
+
     case PlatformType::LINUX:
+#ifdef __linux__
+        return std::make_unique<Platform::Linux::LinuxUdpSocketFactory>();
+#else
         return std::make_unique<Platform::Windows::WindowsUdpSocketFactory>();
+#endif
 
     case PlatformType::WINDOWS_ASIO:
     case PlatformType::LINUX_ASIO:
@@ -92,7 +102,7 @@ std::string NetworkFactory::getPlatformName(PlatformType platform) {
     case PlatformType::WINDOWS_ASIO:
         return "Windows (ASIO)";
     case PlatformType::LINUX:
-        return "Linux (Native Socket)";
+        return "Linux (epoll)";
     case PlatformType::LINUX_ASIO:
         return "Linux (ASIO)";
     case PlatformType::EMBEDDED:
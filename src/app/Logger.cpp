@@ -27,7 +27,11 @@ Logger &Logger::getInstance() {
 
 ILogger &Logger::getLoggerImpl() { return LoggerFactory::getInstance(); }
 
-void Logger::setLogLevel(LogLevel level) { getLoggerImpl().setLogLevel(level); }
+void Logger::setLogLevel(LogLevel level) {
+    Log::runtimeLevel_.store(static_cast<int>(level),
+                             std::memory_order_relaxed);
+    getLoggerImpl().setLogLevel(level);
+}
 
 void Logger::enableFileLogging(const std::string &filename) {
     getLoggerImpl().enableFileLogging(filename);
@@ -61,6 +65,9 @@ void Logger::e(const std::string &tag, const std::string &message) {
 }
 
 void Logger::v(const std::string &tag, const char *format, ...) {
+    if (!Log::isEnabled(LogLevel::VERBOSE))
+        return;
+
     va_list args;
     va_start(args, format);
     getLoggerImpl().v(tag, formatString(format, args));
@@ -68,6 +75,9 @@ void Logger::v(const std::string &tag, const char *format, ...) {
 }
 
 void Logger::d(const std::string &tag, const char *format, ...) {
+    if (!Log::isEnabled(LogLevel::DEBUG))
+        return;
+
     va_list args;
     va_start(args, format);
     getLoggerImpl().d(tag, formatString(format, args));
@@ -75,6 +85,9 @@ void Logger::d(const std::string &tag, const char *format, ...) {
 }
 
 void Logger::i(const std::string &tag, const char *format, ...) {
+    if (!Log::isEnabled(LogLevel::INFO))
+        return;
+
     va_list args;
     va_start(args, format);
     getLoggerImpl().i(tag, formatString(format, args));
@@ -82,6 +95,9 @@ void Logger::i(const std::string &tag, const char *format, ...) {
 }
 
 void Logger::w(const std::string &tag, const char *format, ...) {
+    if (!Log::isEnabled(LogLevel::WARN))
+        return;
+
     va_list args;
     va_start(args, format);
     getLoggerImpl().w(tag, formatString(format, args));
@@ -89,6 +105,9 @@ void Logger::w(const std::string &tag, const char *format, ...) {
 }
 
 void Logger::e(const std::string &tag, const char *format, ...) {
+    if (!Log::isEnabled(LogLevel::ERR))
+        return;
+
     va_list args;
     va_start(args, format);
     getLoggerImpl().e(tag, formatString(format, args));
@@ -117,6 +136,9 @@ void Log::e(const std::string &tag, const std::string &message) {
 }
 
 void Log::v(const std::string &tag, const char *format, ...) {
+    if (!Log::isEnabled(LogLevel::VERBOSE))
+        return;
+
     va_list args;
     va_start(args, format);
     Logger::getInstance().v(tag, formatString(format, args));
@@ -124,6 +146,9 @@ void Log::v(const std::string &tag, const char *format, ...) {
 }
 
 void Log::d(const std::string &tag, const char *format, ...) {
+    if (!Log::isEnabled(LogLevel::DEBUG))
+        return;
+
     va_list args;
     va_start(args, format);
     Logger::getInstance().d(tag, formatString(format, args));
@@ -131,6 +156,9 @@ void Log::d(const std::string &tag, const char *format, ...) {
 }
 
 void Log::i(const std::string &tag, const char *format, ...) {
+    if (!Log::isEnabled(LogLevel::INFO))
+        return;
+
     va_list args;
     va_start(args, format);
     Logger::getInstance().i(tag, formatString(format, args));
@@ -138,6 +166,9 @@ void Log::i(const std::string &tag, const char *format, ...) {
 }
 
 void Log::w(const std::string &tag, const char *format, ...) {
+    if (!Log::isEnabled(LogLevel::WARN))
+        return;
+
     va_list args;
     va_start(args, format);
     Logger::getInstance().w(tag, formatString(format, args));
@@ -145,6 +176,9 @@ void Log::w(const std::string &tag, const char *format, ...) {
 }
 
 void Log::e(const std::string &tag, const char *format, ...) {
+    if (!Log::isEnabled(LogLevel::ERR))
+        return;
+
     va_list args;
     va_start(args, format);
     Logger::getInstance().e(tag, formatString(format, args));
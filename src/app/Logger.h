@@ -1,8 +1,16 @@
 #pragma once
 #include "../Adapter/Logger/LoggerFactory.h"
 #include "../interface/ILogger.h"
+#include <atomic>
 #include <string>
 
+// 编译期日志级别下限 (0=VERBOSE 1=DEBUG 2=INFO 3=WARN 4=ERR)
+// 低于该级别的 LOG_* 宏连同参数求值一起被编译器移除，由 CMake 的
+// WHTS_LOG_MIN_LEVEL 设置
+#ifndef WHTS_LOG_MIN_LEVEL
+#define WHTS_LOG_MIN_LEVEL 0
+#endif
+
 // Redefine LogLevel for compatibility
 using LogLevel = ::LogLevel;
 
@@ -67,4 +75,32 @@ class Log {
     static void setLogLevel(LogLevel level);
     static void enableFileLogging(const std::string &filename);
     static void disableFileLogging();
-};
\ No newline at end of file
+
+    // 该级别的日志是否会输出: 编译期下限在编译时折叠，运行时级别为一次原子读
+    // 在格式化参数 (如十六进制转储) 之前调用
+    static bool isEnabled(LogLevel level) {
+        return static_cast<int>(level) >= WHTS_LOG_MIN_LEVEL &&
+               static_cast<int>(level) >=
+                   runtimeLevel_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    friend class Logger;
+
+    // 运行时日志级别的副本，避免每次调用都经过日志实现的虚函数
+    static inline std::atomic<int> runtimeLevel_{
+        static_cast<int>(LogLevel::VERBOSE)};
+};
+
+// 按级别门控的日志宏: 级别未启用时不求值参数，也不格式化
+#define WHTS_LOG(level, method, ...)                                           \
+    do {                                                                       \
+        if (Log::isEnabled(level))                                             \
+            Log::method(__VA_ARGS__);                                          \
+    } while (0)
+
+#define LOG_V(...) WHTS_LOG(LogLevel::VERBOSE, v, __VA_ARGS__)
+#define LOG_D(...) WHTS_LOG(LogLevel::DEBUG, d, __VA_ARGS__)
+#define LOG_I(...) WHTS_LOG(LogLevel::INFO, i, __VA_ARGS__)
+#define LOG_W(...) WHTS_LOG(LogLevel::WARN, w, __VA_ARGS__)
+#define LOG_E(...) WHTS_LOG(LogLevel::ERR, e, __VA_ARGS__)
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <chrono>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 namespace App {
 
@@ -47,10 +48,10 @@ std::string NetworkManager::createUdpSocket(const std::string &socketId) {
         return "";
     }
 
-    socket->setReceiveCallback([this, id](const std::vector<uint8_t> &data,
-                                          const NetworkAddress &senderAddr) {
-        handleSocketReceive(id, data, senderAddr);
-    });
+    socket->setReceiveCallback(
+        [this, id](ReceiveBuffer &data, const NetworkAddress &senderAddr) {
+            handleSocketReceive(id, data, senderAddr);
+        });
 
     sockets[id] = std::move(socket);
     Log::i("NetworkManager", "Created UDP socket: " + id);
@@ -111,10 +112,20 @@ bool NetworkManager::sendTo(const std::string &socketId,
         return false;
     }
 
-    return it->second->sendTo(
-        data, targetAddr, [this, socketId](bool success, size_t bytesSent) {
-            handleSocketSend(socketId, success, bytesSent);
-        });
+    return it->second->sendTo(data, targetAddr, sendCallback(it->first));
+}
+
+bool NetworkManager::sendToOwned(const std::string &socketId,
+                                 std::vector<uint8_t> &&data,
+                                 const NetworkAddress &targetAddr) {
+    auto it = sockets.find(socketId);
+    if (it == sockets.end()) {
+        Log::e("NetworkManager", "Socket not found: " + socketId);
+        return false;
+    }
+
+    return it->second->sendToOwned(std::move(data), targetAddr,
+                                   sendCallback(it->first));
 }
 
 bool NetworkManager::broadcast(const std::string &socketId,
@@ -126,10 +137,59 @@ bool NetworkManager::broadcast(const std::string &socketId,
         return false;
     }
 
-    return it->second->broadcast(
-        data, port, [this, socketId](bool success, size_t bytesSent) {
-            handleSocketSend(socketId, success, bytesSent);
-        });
+    return it->second->broadcast(data, port, sendCallback(it->first));
+}
+
+bool NetworkManager::sendToGather(const std::string &socketId,
+                                  const ConstBuffer *buffers, size_t count,
+                                  const NetworkAddress &targetAddr) {
+    auto it = sockets.find(socketId);
+    if (it == sockets.end()) {
+        Log::e("NetworkManager", "Socket not found: " + socketId);
+        return false;
+    }
+
+    return it->second->sendToGather(buffers, count, targetAddr,
+                                    sendCallback(it->first));
+}
+
+bool NetworkManager::broadcastGather(const std::string &socketId,
+                                     const ConstBuffer *buffers, size_t count,
+                                     uint16_t port) {
+    auto it = sockets.find(socketId);
+    if (it == sockets.end()) {
+        Log::e("NetworkManager", "Socket not found: " + socketId);
+        return false;
+    }
+
+    return it->second->broadcastGather(buffers, count, port,
+                                       sendCallback(it->first));
+}
+
+bool NetworkManager::sendToBatch(const std::string &socketId,
+                                 const ConstBuffer *datagrams, size_t count,
+                                 const NetworkAddress &targetAddr) {
+    auto it = sockets.find(socketId);
+    if (it == sockets.end()) {
+        Log::e("NetworkManager", "Socket not found: " + socketId);
+        return false;
+    }
+
+    return it->second->sendToBatch(datagrams, count, targetAddr,
+                                   sendCallback(it->first));
+}
+
+bool NetworkManager::broadcastBatch(const std::string &socketId,
+                                    const ConstBuffer *datagrams, size_t count,
+                                    uint16_t port) {
+    auto it = sockets.find(socketId);
+    if (it == sockets.end()) {
+        Log::e("NetworkManager", "Socket not found: " + socketId);
+        return false;
+    }
+
+    return it->second->broadcastBatch(datagrams, count, port,
+                                      sendCallback(it->first));
 }
 
 int NetworkManager::receiveFrom(const std::string &socketId, uint8_t *buffer,
@@ -208,6 +268,29 @@ void NetworkManager::processEvents() {
     }
 }
 
+bool NetworkManager::waitForEvents(uint32_t timeoutMs) {
+    if (sockets.empty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return false;
+    }
+
+    // 单个套接字直接等待；多个套接字时先检查一遍，再平分等待时间轮流等待
+    if (sockets.size() > 1) {
+        for (auto &pair : sockets) {
+            if (pair.second->waitForEvents(0)) {
+                return true;
+            }
+        }
+    }
+    uint32_t slice = static_cast<uint32_t>(timeoutMs / sockets.size());
+    for (auto &pair : sockets) {
+        if (pair.second->waitForEvents(slice)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::vector<std::string> NetworkManager::getSocketIds() const {
     std::vector<std::string> ids;
     for (const auto &pair : sockets) {
@@ -226,16 +309,26 @@ void NetworkManager::cleanup() {
 }
 
 void NetworkManager::handleSocketReceive(const std::string &socketId,
-                                         const std::vector<uint8_t> &data,
+                                         ReceiveBuffer &data,
                                          const NetworkAddress &senderAddr) {
     if (eventCallback) {
+        // 缓冲区交换进事件，回调结束后把事件中的缓冲区 (回调可能已换走)
+        // 交还给套接字，数据不拷贝
         NetworkEvent event(NetworkEventType::DATA_RECEIVED, socketId);
-        event.data = data;
+        event.data.swap(data);
         event.remoteAddr = senderAddr;
         eventCallback(event);
+        data.swap(event.data);
     }
 }
 
+UdpSendCallback NetworkManager::sendCallback(const std::string &socketId) {
+    const std::string *id = &socketId;
+    return [this, id](bool success, size_t bytesSent) {
+        handleSocketSend(*id, success, bytesSent);
+    };
+}
+
 void NetworkManager::handleSocketSend(const std::string &socketId, bool success,
                                       size_t bytesSent) {
     if (eventCallback) {
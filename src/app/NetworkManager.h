@@ -25,11 +25,13 @@ class NetworkManager : public INetwork {
     std::string generateSocketId();
 
     // 内部事件处理
-    void handleSocketReceive(const std::string &socketId,
-                             const std::vector<uint8_t> &data,
+    void handleSocketReceive(const std::string &socketId, ReceiveBuffer &data,
                              const NetworkAddress &senderAddr);
     void handleSocketSend(const std::string &socketId, bool success,
                           size_t bytesSent);
+    // 发送完成回调只捕获 this 与表中套接字ID的地址 (关闭套接字前有效)，
+    // 可存放在 std::function 内部，每次发送不分配内存
+    UdpSendCallback sendCallback(const std::string &socketId);
 
   public:
     NetworkManager();
@@ -47,6 +49,18 @@ class NetworkManager : public INetwork {
                 const NetworkAddress &targetAddr) override;
     bool broadcast(const std::string &socketId,
                    const std::vector<uint8_t> &data, uint16_t port) override;
+    bool sendToOwned(const std::string &socketId, std::vector<uint8_t> &&data,
+                     const NetworkAddress &targetAddr) override;
+    bool sendToGather(const std::string &socketId, const ConstBuffer *buffers,
+                      size_t count, const NetworkAddress &targetAddr) override;
+    bool broadcastGather(const std::string &socketId,
+                         const ConstBuffer *buffers, size_t count,
+                         uint16_t port) override;
+    bool sendToBatch(const std::string &socketId, const ConstBuffer *datagrams,
+                     size_t count, const NetworkAddress &targetAddr) override;
+    bool broadcastBatch(const std::string &socketId,
+                        const ConstBuffer *datagrams, size_t count,
+                        uint16_t port) override;
     int receiveFrom(const std::string &socketId, uint8_t *buffer,
                     size_t bufferSize, NetworkAddress &senderAddr) override;
     bool closeSocket(const std::string &socketId) override;
@@ -57,6 +71,7 @@ class NetworkManager : public INetwork {
     void start() override;
     void stop() override;
     void processEvents() override;
+    bool waitForEvents(uint32_t timeoutMs) override;
     std::vector<std::string> getSocketIds() const override;
     void cleanup() override;
 };
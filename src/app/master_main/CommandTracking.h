@@ -1,8 +1,8 @@
 #pragma once
 
 #include "../../interface/IUdpSocket.h"
+#include "TimerQueue.h"
 #include "WhtsProtocol.h"
-#include <memory>
 
 using namespace WhtsProtocol;
 using namespace Interface;
@@ -10,16 +10,23 @@ using namespace Interface;
 // Command tracking for timeout and retry management
 struct PendingCommand {
     uint32_t slaveId;
-    std::unique_ptr<Message> command;
+    Master2SlaveVariant command; // 按值保存，重试时直接重新打包
     NetworkAddress clientAddr;
     uint32_t timestamp;
     uint8_t retryCount;
     uint8_t maxRetries;
+    TimerQueue::TimerId timerId; // 重试定时器，收到响应时取消
 
-    PendingCommand(uint32_t id, std::unique_ptr<Message> cmd,
+    PendingCommand(uint32_t id, const Master2SlaveVariant &cmd,
                    const NetworkAddress &addr, uint8_t maxRetry = 3)
-        : slaveId(id), command(std::move(cmd)), clientAddr(addr), timestamp(0),
-          retryCount(0), maxRetries(maxRetry) {}
+        : slaveId(id), command(cmd), clientAddr(addr), timestamp(0),
+          retryCount(0), maxRetries(maxRetry), timerId(0) {}
+};
+
+// 批量发送的单条从机命令
+struct SlaveCommand {
+    uint32_t slaveId;
+    Master2SlaveVariant command;
 };
 
 // Ping session tracking
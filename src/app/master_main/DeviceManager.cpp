@@ -1,5 +1,6 @@
 #include "DeviceManager.h"
 #include "../Logger.h"
+#include <algorithm>
 
 DeviceManager::DeviceManager()
     : currentMode(0), systemRunningStatus(0), dataCollectionActive(false),
@@ -37,6 +38,23 @@ uint8_t DeviceManager::getSlaveShortId(uint32_t slaveId) const {
     return it != slaveShortIds.end() ? it->second : 0;
 }
 
+uint8_t DeviceManager::assignShortId(uint32_t slaveId) {
+    uint8_t existing = getSlaveShortId(slaveId);
+    if (existing > 0)
+        return existing;
+
+    bool used[256] = {};
+    for (const auto &pair : slaveShortIds)
+        used[pair.second] = true;
+    for (int id = 1; id <= 255; ++id) {
+        if (!used[id]) {
+            slaveShortIds[slaveId] = static_cast<uint8_t>(id);
+            return static_cast<uint8_t>(id);
+        }
+    }
+    return 0;
+}
+
 // Configuration management
 void DeviceManager::setSlaveConfig(
     uint32_t slaveId,
@@ -56,6 +74,20 @@ bool DeviceManager::hasSlaveConfig(uint32_t slaveId) const {
     return slaveConfigs.find(slaveId) != slaveConfigs.end();
 }
 
+// Device status cache
+uint16_t DeviceManager::updateSlaveStatus(uint32_t slaveId,
+                                          DeviceStatus status) {
+    DeviceStatus &cached = slaveStatuses[slaveId];
+    uint16_t changed = cached.changedBits(status);
+    cached = status;
+    return changed;
+}
+
+DeviceStatus DeviceManager::getSlaveStatus(uint32_t slaveId) const {
+    auto it = slaveStatuses.find(slaveId);
+    return it != slaveStatuses.end() ? it->second : DeviceStatus();
+}
+
 // Mode management
 void DeviceManager::setCurrentMode(uint8_t mode) { currentMode = mode; }
 uint8_t DeviceManager::getCurrentMode() const { return currentMode; }
@@ -269,6 +301,47 @@ bool DeviceManager::shouldStartNewCycle(uint32_t currentTime) {
     return lastCycleTime == 0 || (currentTime - lastCycleTime >= cycleInterval);
 }
 
+uint32_t DeviceManager::msUntilNextCycleEvent(uint32_t currentTime) const {
+    if (!dataCollectionActive) {
+        return UINT32_MAX;
+    }
+
+    auto remaining = [currentTime](uint32_t since, uint32_t duration) {
+        uint32_t elapsed = currentTime - since;
+        return elapsed >= duration ? 0u : duration - elapsed;
+    };
+
+    switch (cycleState) {
+    case CollectionCycleState::IDLE:
+    case CollectionCycleState::COMPLETE:
+        if (systemRunningStatus != 1) {
+            return UINT32_MAX;
+        }
+        return lastCycleTime == 0 ? 0
+                                  : remaining(lastCycleTime, cycleInterval);
+
+    case CollectionCycleState::COLLECTING: {
+        if (!syncSent) {
+            return UINT32_MAX;
+        }
+        // 所有从机都采集完成时进入读取阶段
+        uint32_t latest = 0;
+        for (const auto &collection : activeCollections) {
+            if (collection.startTimestamp == 0) {
+                return UINT32_MAX;
+            }
+            latest = std::max(latest,
+                              remaining(collection.startTimestamp,
+                                        collection.estimatedDuration));
+        }
+        return latest;
+    }
+
+    default:
+        return UINT32_MAX;
+    }
+}
+
 // 获取当前采集周期状态
 CollectionCycleState DeviceManager::getCycleState() const { return cycleState; }
 
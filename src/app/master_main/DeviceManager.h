@@ -49,6 +49,8 @@ class DeviceManager {
     std::unordered_map<uint32_t, uint8_t> slaveShortIds;
     std::unordered_map<uint32_t, Backend2Master::SlaveConfigMessage::SlaveInfo>
         slaveConfigs;
+    // 各从机最近一次上报的设备状态
+    std::unordered_map<uint32_t, DeviceStatus> slaveStatuses;
     uint8_t currentMode;         // 0=Conduction, 1=Resistance, 2=Clip
     uint8_t systemRunningStatus; // 0=Stop, 1=Run, 2=Reset
 
@@ -69,6 +71,8 @@ class DeviceManager {
     bool isSlaveConnected(uint32_t slaveId) const;
     std::vector<uint32_t> getConnectedSlaves() const;
     uint8_t getSlaveShortId(uint32_t slaveId) const;
+    // 为从机分配短ID (已分配时返回原值)，1~255 用尽时返回0
+    uint8_t assignShortId(uint32_t slaveId);
 
     // Configuration management
     void
@@ -78,6 +82,11 @@ class DeviceManager {
     getSlaveConfig(uint32_t slaveId) const;
     bool hasSlaveConfig(uint32_t slaveId) const;
 
+    // 设备状态缓存: 保存最新状态，返回与上次相比变化的位
+    // 首次上报时以全0状态为基准
+    uint16_t updateSlaveStatus(uint32_t slaveId, DeviceStatus status);
+    DeviceStatus getSlaveStatus(uint32_t slaveId) const;
+
     // Mode management
     void setCurrentMode(uint8_t mode);
     uint8_t getCurrentMode() const;
@@ -106,4 +115,7 @@ class DeviceManager {
     void setCycleInterval(uint32_t interval);
     uint32_t getCycleInterval() const;
     bool isDataCollectionActive() const;
+    // 距下一次按时间触发的周期状态变化的毫秒数 (开始新周期或进入读取阶段)
+    // 已到期返回0，只等待网络消息时返回 UINT32_MAX
+    uint32_t msUntilNextCycleEvent(uint32_t currentTime) const;
 };
\ No newline at end of file
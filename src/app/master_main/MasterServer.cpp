@@ -4,9 +4,9 @@
 
 #include <algorithm>
 #include <chrono>
+#include <functional>
 #include <iomanip>
 #include <sstream>
-#include <thread>
 
 MasterServer::MasterServer(uint16_t listenPort) : port(listenPort) {
     // 创建网络管理器
@@ -45,7 +45,8 @@ MasterServer::MasterServer(uint16_t listenPort) : port(listenPort) {
         throw std::runtime_error("Failed to bind socket");
     }
 
-    initializeMessageHandlers();
+    commandCoalescer.setMaxDatagramSize(processor.getMinPeerMTU());
+
     Log::i("Master", "Master server listening on port %d", port);
     Log::i("Master", "Backend communication port: 8079");
     Log::i("Master", "Slave broadcast communication port: 8081");
@@ -58,32 +59,6 @@ MasterServer::~MasterServer() {
     }
 }
 
-void MasterServer::initializeMessageHandlers() {
-    registerMessageHandler(
-        static_cast<uint8_t>(Backend2MasterMessageId::SLAVE_CFG_MSG),
-        std::make_unique<SlaveConfigHandler>());
-    registerMessageHandler(
-        static_cast<uint8_t>(Backend2MasterMessageId::MODE_CFG_MSG),
-        std::make_unique<ModeConfigHandler>());
-    registerMessageHandler(
-        static_cast<uint8_t>(Backend2MasterMessageId::SLAVE_RST_MSG),
-        std::make_unique<ResetHandler>());
-    registerMessageHandler(
-        static_cast<uint8_t>(Backend2MasterMessageId::CTRL_MSG),
-        std::make_unique<ControlHandler>());
-    registerMessageHandler(
-        static_cast<uint8_t>(Backend2MasterMessageId::PING_CTRL_MSG),
-        std::make_unique<PingControlHandler>());
-    registerMessageHandler(
-        static_cast<uint8_t>(Backend2MasterMessageId::DEVICE_LIST_REQ_MSG),
-        std::make_unique<DeviceListHandler>());
-}
-
-void MasterServer::registerMessageHandler(
-    uint8_t messageId, std::unique_ptr<IMessageHandler> handler) {
-    messageHandlers[messageId] = std::move(handler);
-}
-
 std::vector<uint8_t> MasterServer::hexStringToBytes(const std::string &hex) {
     std::vector<uint8_t> bytes;
     for (size_t i = 0; i < hex.length(); i += 2) {
@@ -115,7 +90,7 @@ void MasterServer::printBytes(const std::vector<uint8_t> &data,
            ss.str().c_str());
 }
 
-std::string MasterServer::bytesToHexString(const std::vector<uint8_t> &bytes) {
+std::string MasterServer::bytesToHexString(ByteView bytes) {
     std::stringstream ss;
     for (uint8_t byte : bytes) {
         ss << std::hex << std::setw(2) << std::setfill('0')
@@ -124,12 +99,14 @@ std::string MasterServer::bytesToHexString(const std::vector<uint8_t> &bytes) {
     return ss.str();
 }
 
-void MasterServer::sendResponseToBackend(std::unique_ptr<Message> response,
-                                         const NetworkAddress &clientAddr) {
-    if (!response)
-        return;
+uint64_t MasterServer::senderKey(const NetworkAddress &addr) {
+    uint64_t ipHash = std::hash<std::string>{}(addr.ip);
+    return (ipHash << 16) ^ addr.port;
+}
 
-    auto responseData = processor.packMaster2BackendMessage(*response);
+void MasterServer::sendResponseToBackend(const Message &response,
+                                         const NetworkAddress &clientAddr) {
+    auto responseData = processor.packMaster2BackendMessage(response);
     Log::i("Master", "Sending Master2Backend response to port 8079:");
 
     for (const auto &fragment : responseData) {
@@ -141,306 +118,456 @@ void MasterServer::sendResponseToBackend(std::unique_ptr<Message> response,
     Log::i("Master", "Master2Backend response sent to backend (port 8079)");
 }
 
-void MasterServer::sendCommandToSlave(uint32_t slaveId,
-                                      std::unique_ptr<Message> command,
+void MasterServer::sendCommandToSlave(uint32_t slaveId, const Message &command,
                                       const NetworkAddress &clientAddr) {
-    if (!command)
+    if (!processor.packMaster2SlaveMessageGather(slaveId, command,
+                                                 commandFrames)) {
+        Log::e("Master", "Failed to pack Master2Slave command for 0x%08X",
+               slaveId);
         return;
+    }
 
-    auto commandData = processor.packMaster2SlaveMessage(slaveId, *command);
-    Log::i(
-        "Master",
-        "Broadcasting Master2Slave command to 0x%08X via port 8081:", slaveId);
+    // 未分片的小帧进入合并队列，与同一时段的其它命令共用数据报
+    if (commandFrames.fragments.size() == 1 &&
+        commandFrames.fragments[0].headerSize == 0) {
+        queueCommandDatagram(commandFrames.fragments[0].payload);
+        Log::i("Master",
+               "Queued Master2Slave command to 0x%08X for broadcast (%zu "
+               "bytes)",
+               slaveId, commandFrames.fragments[0].payload.size());
+        return;
+    }
 
-    for (const auto &fragment : commandData) {
-        printBytes(fragment, "Master2Slave command data");
+    Log::i("Master",
+           "Broadcasting Master2Slave command to 0x%08X via port 8081 "
+           "(%zu bytes, %zu datagrams)",
+           slaveId, commandFrames.buffer.size(),
+           commandFrames.fragments.size());
+
+    // 分片已占满 MTU，先发出排队的命令以保持顺序，再直接发送
+    flushCommands();
+    for (const auto &fragment : commandFrames.fragments) {
+        ConstBuffer buffers[] = {
+            {fragment.header, fragment.headerSize},
+            {fragment.payload.data(), fragment.payload.size()},
+            {fragment.trailer, fragment.trailerSize}};
         // Send to slaves on port 8081
-        networkManager->broadcast(mainSocketId, fragment,
-                                  slaveBroadcastAddr.port);
+        networkManager->broadcastGather(mainSocketId, buffers, 3,
+                                        slaveBroadcastAddr.port);
     }
 
     Log::i("Master", "Master2Slave command broadcasted to slaves (port 8081)");
 }
 
-void MasterServer::sendCommandToSlaveWithRetry(uint32_t slaveId,
-                                               std::unique_ptr<Message> command,
-                                               const NetworkAddress &clientAddr,
-                                               uint8_t maxRetries) {
-    // Create a pending command for retry management
-    PendingCommand pendingCmd(slaveId, std::move(command), clientAddr,
-                              maxRetries);
-    pendingCmd.timestamp = getCurrentTimestampMs();
-
-    // Send the command immediately - create a copy by serializing and
-    // deserializing
-    auto serialized = pendingCmd.command->serialize();
-    auto messageCopy = processor.createMessage(
-        PacketId::MASTER_TO_SLAVE, pendingCmd.command->getMessageId());
-    if (messageCopy && messageCopy->deserialize(serialized)) {
-        sendCommandToSlave(slaveId, std::move(messageCopy), clientAddr);
-    }
+void MasterServer::sendCommandToSlaveWithRetry(
+    uint32_t slaveId, const Master2SlaveVariant &command,
+    const NetworkAddress &clientAddr, uint8_t maxRetries) {
+    const Message *message = asMessage(command);
+    if (!message)
+        return;
+
+    // Send the command immediately
+    sendCommandToSlave(slaveId, *message, clientAddr);
 
-    // Add to pending commands list for retry management
-    pendingCommands.push_back(std::move(pendingCmd));
+    // Add to pending commands for retry management
+    trackPendingCommand(slaveId, command, clientAddr, maxRetries,
+                        getCurrentTimestampMs());
 
     Log::i("Master",
            "Command sent to slave 0x%08X with retry support (max retries: %d)",
            slaveId, maxRetries);
 }
 
-void MasterServer::processPendingCommands() {
-    uint32_t currentTime = getCurrentTimestampMs();
-    const uint32_t RETRY_TIMEOUT = 5000; // 5 seconds timeout
-
-    auto it = pendingCommands.begin();
-    while (it != pendingCommands.end()) {
-        if (currentTime - it->timestamp > RETRY_TIMEOUT) {
-            if (it->retryCount < it->maxRetries) {
-                // Retry the command
-                it->retryCount++;
-                it->timestamp = currentTime;
-
-                // Create a copy of the command by serializing and deserializing
-                auto serialized = it->command->serialize();
-                auto messageCopy = processor.createMessage(
-                    PacketId::MASTER_TO_SLAVE, it->command->getMessageId());
-                if (messageCopy && messageCopy->deserialize(serialized)) {
-                    sendCommandToSlave(it->slaveId, std::move(messageCopy),
-                                       it->clientAddr);
-                }
-
-                Log::i("Master",
-                       "Retrying command to slave 0x%08X (attempt %d/%d)",
-                       it->slaveId, it->retryCount, it->maxRetries);
-                ++it;
-            } else {
-                // Max retries reached, remove from pending list
-                Log::w("Master",
-                       "Command to slave 0x%08X failed after %d retries",
-                       it->slaveId, it->maxRetries);
-                it = pendingCommands.erase(it);
-            }
-        } else {
-            ++it;
-        }
+void MasterServer::sendCommandBatch(const std::vector<SlaveCommand> &commands) {
+    batchEntries.clear();
+    for (const auto &cmd : commands) {
+        if (const Message *message = asMessage(cmd.command))
+            batchEntries.push_back({cmd.slaveId, message});
     }
+    broadcastBatchEntries();
 }
 
-void MasterServer::addPingSession(uint32_t targetId, uint8_t pingMode,
-                                  uint16_t totalCount, uint16_t interval,
-                                  const NetworkAddress &clientAddr) {
-    // Create a new ping session
-    PingSession session(targetId, pingMode, totalCount, interval, clientAddr);
-    session.lastPingTime = getCurrentTimestampMs();
+void MasterServer::sendCommandBatchWithRetry(
+    const std::vector<SlaveCommand> &commands, const NetworkAddress &clientAddr,
+    uint8_t maxRetries) {
+    sendCommandBatch(commands);
 
-    activePingSessions.push_back(std::move(session));
+    uint32_t now = getCurrentTimestampMs();
+    for (const auto &cmd : commands)
+        trackPendingCommand(cmd.slaveId, cmd.command, clientAddr, maxRetries,
+                            now);
 
     Log::i("Master",
-           "Added ping session for target 0x%08X (mode=%d, count=%d, "
-           "interval=%dms)",
-           targetId, pingMode, totalCount, interval);
+           "%zu commands sent with retry support (max retries: %d)",
+           commands.size(), maxRetries);
 }
 
-void MasterServer::processPingSessions() {
-    uint32_t currentTime = getCurrentTimestampMs();
+void MasterServer::broadcastBatchEntries() {
+    if (batchEntries.empty())
+        return;
 
-    auto it = activePingSessions.begin();
-    while (it != activePingSessions.end()) {
-        if (currentTime - it->lastPingTime >= it->interval) {
-            if (it->currentCount < it->totalCount) {
-                // Send ping command
-                auto pingCmd = std::make_unique<Master2Slave::PingReqMessage>();
-                pingCmd->sequenceNumber = it->currentCount + 1;
-                pingCmd->timestamp = currentTime;
+    commandBatch.clear();
+    if (!processor.packMaster2SlaveBatch(batchEntries.data(),
+                                         batchEntries.size(), commandBatch)) {
+        Log::e("Master", "Failed to pack batch of %zu Master2Slave commands",
+               batchEntries.size());
+        return;
+    }
 
-                sendCommandToSlave(it->targetId, std::move(pingCmd),
-                                   it->clientAddr);
+    for (size_t i = 0; i < commandBatch.datagramCount(); ++i)
+        queueCommandDatagram(commandBatch.datagram(i));
 
-                it->currentCount++;
-                it->lastPingTime = currentTime;
+    Log::i("Master",
+           "Queued %zu Master2Slave commands (%zu bytes) for broadcast",
+           batchEntries.size(), commandBatch.arena.size());
+}
 
-                Log::i("Master", "Sent ping %d/%d to target 0x%08X",
-                       it->currentCount, it->totalCount, it->targetId);
-                ++it;
-            } else {
-                // Ping session completed
-                Log::i("Master",
-                       "Ping session completed for target 0x%08X (%d/%d "
-                       "successful)",
-                       it->targetId, it->successCount, it->totalCount);
-                it = activePingSessions.erase(it);
-            }
-        } else {
-            ++it;
-        }
-    }
+void MasterServer::queueCommandDatagram(ByteView datagram) {
+    commandCoalescer.append(datagram, getCurrentTimestampMs());
 }
 
-void MasterServer::processBackend2MasterMessage(
-    const Message &message, const NetworkAddress &clientAddr) {
-    uint8_t messageId = message.getMessageId();
-    Log::i("Master", "Processing Backend2Master message, ID: 0x%02X",
-           static_cast<int>(messageId));
-
-    auto handlerIt = messageHandlers.find(messageId);
-    if (handlerIt != messageHandlers.end()) {
-        // Process message and generate response
-        auto response = handlerIt->second->processMessage(message, this);
-
-        // Execute associated actions
-        handlerIt->second->executeActions(message, this);
-
-        // Send response if generated
-        if (response) {
-            sendResponseToBackend(std::move(response), clientAddr);
-        } else {
-            Log::i("Master",
-                   "No response needed for this Backend2Master message");
-        }
-    } else {
-        Log::w("Master", "Unknown Backend2Master message type: 0x%02X",
-               static_cast<int>(messageId));
-    }
+void MasterServer::updateCommandDatagramLimit() {
+    size_t limit = processor.getMinPeerMTU();
+    if (limit == commandCoalescer.getMaxDatagramSize())
+        return;
+
+    // 已合并的数据报按旧上限组装，先发送再切换
+    flushCommands();
+    commandCoalescer.setMaxDatagramSize(limit);
+    Log::i("Master", "Broadcast datagram limit set to %zu bytes", limit);
 }
 
-void MasterServer::processSlave2MasterMessage(
-    uint32_t slaveId, const Message &message,
-    const NetworkAddress &clientAddr) {
-    Log::i("Master", "Processing Slave2Master message from slave 0x%08X",
-           slaveId);
+void MasterServer::flushCommands() {
+    if (commandCoalescer.empty())
+        return;
 
-    switch (message.getMessageId()) {
-    case static_cast<uint8_t>(Slave2MasterMessageId::CONDUCTION_CFG_RSP_MSG): {
-        const auto *rspMsg =
-            dynamic_cast<const Slave2Master::ConductionConfigResponseMessage *>(
-                &message);
-        if (rspMsg) {
-            Log::i("Master",
-                   "Received conduction config response from slave 0x%08X",
-                   slaveId);
-            deviceManager.addSlave(slaveId);
-        }
-        break;
+    const PackedBatch &batch = commandCoalescer.batch();
+    batchDatagrams.clear();
+    for (size_t i = 0; i < batch.datagramCount(); ++i) {
+        ByteView datagram = batch.datagram(i);
+        batchDatagrams.push_back({datagram.data(), datagram.size()});
     }
 
-    case static_cast<uint8_t>(Slave2MasterMessageId::RESISTANCE_CFG_RSP_MSG): {
-        const auto *rspMsg =
-            dynamic_cast<const Slave2Master::ResistanceConfigResponseMessage *>(
-                &message);
-        if (rspMsg) {
-            Log::i("Master",
-                   "Received resistance config response from slave 0x%08X",
-                   slaveId);
-            deviceManager.addSlave(slaveId);
-        }
-        break;
+    // Send to slaves on port 8081
+    networkManager->broadcastBatch(mainSocketId, batchDatagrams.data(),
+                                   batchDatagrams.size(),
+                                   slaveBroadcastAddr.port);
+
+    Log::i("Master",
+           "Broadcast %zu Master2Slave frames as %zu datagrams (%zu bytes) "
+           "via port 8081",
+           commandCoalescer.frameCount(), batchDatagrams.size(),
+           batch.arena.size());
+    commandCoalescer.clear();
+}
+
+void MasterServer::trackPendingCommand(uint32_t slaveId,
+                                       const Master2SlaveVariant &command,
+                                       const NetworkAddress &clientAddr,
+                                       uint8_t maxRetries, uint32_t now) {
+    uint64_t key = nextTimerKey++;
+    auto &pending =
+        pendingCommands
+            .emplace(key, PendingCommand(slaveId, command, clientAddr,
+                                         maxRetries))
+            .first->second;
+    pending.timestamp = now;
+    pending.timerId = timers.schedule(now + COMMAND_RETRY_TIMEOUT_MS,
+                                      COMMAND_RETRY_TIMER, key);
+
+    if (const Message *message = asMessage(command))
+        pendingCommandIndex[pendingIndexKey(slaveId, message->getMessageId())]
+            .push_back(key);
+}
+
+void MasterServer::processTimers() {
+    uint32_t currentTime = getCurrentTimestampMs();
+
+    expiredTimers.clear();
+    if (timers.popExpired(currentTime, expiredTimers) == 0)
+        return;
+
+    // 到期的命令合并为一批重发，命令按值保存，直接重新打包
+    batchEntries.clear();
+    for (const auto &timer : expiredTimers) {
+        if (timer.type == COMMAND_RETRY_TIMER)
+            handleCommandTimeout(timer.key, currentTime);
+        else
+            handlePingTimer(timer.key, currentTime);
     }
+    broadcastBatchEntries();
+}
 
-    case static_cast<uint8_t>(Slave2MasterMessageId::PING_RSP_MSG): {
-        const auto *pingRsp =
-            dynamic_cast<const Slave2Master::PingRspMessage *>(&message);
-        if (pingRsp) {
-            Log::i("Master",
-                   "Received ping response from slave 0x%08X (seq=%d)", slaveId,
-                   pingRsp->sequenceNumber);
-
-            // Update ping session success count
-            for (auto &session : activePingSessions) {
-                if (session.targetId == slaveId) {
-                    session.successCount++;
-                    break;
-                }
-            }
-        }
-        break;
+void MasterServer::handleCommandTimeout(uint64_t key, uint32_t now) {
+    auto it = pendingCommands.find(key);
+    if (it == pendingCommands.end())
+        return;
+
+    PendingCommand &pending = it->second;
+    if (pending.retryCount >= pending.maxRetries) {
+        // Max retries reached, remove from pending commands
+        Log::w("Master", "Command to slave 0x%08X failed after %d retries",
+               pending.slaveId, pending.maxRetries);
+        erasePendingCommand(it);
+        return;
     }
 
-    case static_cast<uint8_t>(Slave2BackendMessageId::CONDUCTION_DATA_MSG): {
-        const auto *dataMsg =
-            dynamic_cast<const Slave2Backend::ConductionDataMessage *>(
-                &message);
-        if (dataMsg) {
-            Log::i("Master",
-                   "Received conduction data from slave 0x%08X - %zu bytes",
-                   slaveId, dataMsg->conductionData.size());
+    pending.retryCount++;
+    pending.timestamp = now;
+    if (const Message *command = asMessage(pending.command))
+        batchEntries.push_back({pending.slaveId, command});
+    pending.timerId = timers.schedule(now + COMMAND_RETRY_TIMEOUT_MS,
+                                      COMMAND_RETRY_TIMER, key);
 
-            // 标记从机的数据已接收
-            deviceManager.markDataReceived(slaveId);
+    Log::i("Master", "Retrying command to slave 0x%08X (attempt %d/%d)",
+           pending.slaveId, pending.retryCount, pending.maxRetries);
+}
 
-            // 将数据转发给后端
-            DeviceStatus status = {};
-            std::vector<std::vector<uint8_t>> packets =
-                processor.packSlave2BackendMessage(slaveId, status, *dataMsg);
+// 同一从机的同类命令按发送顺序响应，响应对应最早的未完成命令
+void MasterServer::completePendingCommand(uint32_t slaveId,
+                                          Master2SlaveMessageId commandId) {
+    auto indexIt = pendingCommandIndex.find(
+        pendingIndexKey(slaveId, static_cast<uint8_t>(commandId)));
+    if (indexIt == pendingCommandIndex.end())
+        return;
 
-            for (const auto &packet : packets) {
-                networkManager->sendTo(mainSocketId, packet, backendAddr);
+    auto it = pendingCommands.find(indexIt->second.front());
+    if (it == pendingCommands.end())
+        return;
 
-                Log::i("Master",
-                       "Forwarded conduction data to backend - %zu bytes",
-                       packet.size());
-            }
+    timers.cancel(it->second.timerId);
+    erasePendingCommand(it);
+}
+
+void MasterServer::erasePendingCommand(
+    std::unordered_map<uint64_t, PendingCommand>::iterator it) {
+    const PendingCommand &pending = it->second;
+    if (const Message *command = asMessage(pending.command)) {
+        auto indexIt = pendingCommandIndex.find(
+            pendingIndexKey(pending.slaveId, command->getMessageId()));
+        if (indexIt != pendingCommandIndex.end()) {
+            // 通常是最早的一条；重试次数不同的命令可能先于更早的命令放弃
+            std::deque<uint64_t> &keys = indexIt->second;
+            auto keyIt = std::find(keys.begin(), keys.end(), it->first);
+            if (keyIt != keys.end())
+                keys.erase(keyIt);
+            if (keys.empty())
+                pendingCommandIndex.erase(indexIt);
         }
-        break;
     }
+    pendingCommands.erase(it);
+}
 
-    case static_cast<uint8_t>(Slave2BackendMessageId::RESISTANCE_DATA_MSG): {
-        const auto *dataMsg =
-            dynamic_cast<const Slave2Backend::ResistanceDataMessage *>(
-                &message);
-        if (dataMsg) {
-            Log::i("Master",
-                   "Received resistance data from slave 0x%08X - %zu bytes",
-                   slaveId, dataMsg->resistanceData.size());
-
-            // 标记从机的数据已接收
-            deviceManager.markDataReceived(slaveId);
+void MasterServer::addPingSession(uint32_t targetId, uint8_t pingMode,
+                                  uint16_t totalCount, uint16_t interval,
+                                  const NetworkAddress &clientAddr) {
+    // Create a new ping session
+    uint64_t key = nextTimerKey++;
+    auto &session =
+        activePingSessions
+            .emplace(key, PingSession(targetId, pingMode, totalCount, interval,
+                                      clientAddr))
+            .first->second;
+    session.lastPingTime = getCurrentTimestampMs();
+    timers.schedule(session.lastPingTime + interval, PING_TIMER, key);
 
-            // 将数据转发给后端
-            DeviceStatus status = {};
-            std::vector<std::vector<uint8_t>> packets =
-                processor.packSlave2BackendMessage(slaveId, status, *dataMsg);
+    Log::i("Master",
+           "Added ping session for target 0x%08X (mode=%d, count=%d, "
+           "interval=%dms)",
+           targetId, pingMode, totalCount, interval);
+}
 
-            for (const auto &packet : packets) {
-                networkManager->sendTo(mainSocketId, packet, backendAddr);
+void MasterServer::handlePingTimer(uint64_t key, uint32_t now) {
+    auto it = activePingSessions.find(key);
+    if (it == activePingSessions.end())
+        return;
 
-                Log::i("Master",
-                       "Forwarded resistance data to backend - %zu bytes",
-                       packet.size());
-            }
-        }
-        break;
+    PingSession &session = it->second;
+    if (session.currentCount >= session.totalCount) {
+        // Ping session completed
+        Log::i("Master",
+               "Ping session completed for target 0x%08X (%d/%d successful)",
+               session.targetId, session.successCount, session.totalCount);
+        activePingSessions.erase(it);
+        return;
     }
 
-    case static_cast<uint8_t>(Slave2BackendMessageId::CLIP_DATA_MSG): {
-        const auto *dataMsg =
-            dynamic_cast<const Slave2Backend::ClipDataMessage *>(&message);
-        if (dataMsg) {
-            Log::i("Master",
-                   "Received clip data from slave 0x%08X - value: 0x%02X",
-                   slaveId, dataMsg->clipData);
+    // Send ping command
+    Master2Slave::PingReqMessage pingCmd;
+    pingCmd.sequenceNumber = session.currentCount + 1;
+    pingCmd.timestamp = now;
+
+    sendCommandToSlave(session.targetId, pingCmd, session.clientAddr);
+
+    session.currentCount++;
+    session.lastPingTime = now;
+    timers.schedule(now + session.interval, PING_TIMER, key);
+
+    Log::i("Master", "Sent ping %d/%d to target 0x%08X", session.currentCount,
+           session.totalCount, session.targetId);
+}
+
+void MasterServer::processBackend2MasterMessage(
+    const Backend2MasterVariant &message, const NetworkAddress &clientAddr) {
+    std::visit(
+        [this, &clientAddr](const auto &msg) {
+            using T = std::decay_t<decltype(msg)>;
+            if constexpr (std::is_same<T, std::monostate>::value) {
+                Log::w("Master", "Unknown Backend2Master message type");
+            } else {
+                Log::i("Master",
+                       "Processing Backend2Master message, ID: 0x%02X",
+                       static_cast<int>(msg.getMessageId()));
 
-            // 标记从机的数据已接收
-            deviceManager.markDataReceived(slaveId);
+                // 处理器在编译期按消息类型选定
+                auto &handler = handlerFor<T>(backendHandlers);
 
-            // 将数据转发给后端
-            DeviceStatus status = {};
-            std::vector<std::vector<uint8_t>> packets =
-                processor.packSlave2BackendMessage(slaveId, status, *dataMsg);
+                // Process message and generate response
+                Master2BackendVariant response =
+                    handler.processMessage(msg, this);
 
-            for (const auto &packet : packets) {
-                networkManager->sendTo(mainSocketId, packet, backendAddr);
+                // Execute associated actions
+                handler.executeActions(msg, this);
 
-                Log::i("Master", "Forwarded clip data to backend - %zu bytes",
-                       packet.size());
+                // Send response if generated
+                if (const Message *rsp = asMessage(response)) {
+                    sendResponseToBackend(*rsp, clientAddr);
+                } else {
+                    Log::i("Master", "No response needed for this "
+                                     "Backend2Master message");
+                }
             }
-        }
-        break;
+        },
+        message);
+}
+
+void MasterServer::processSlave2MasterMessage(
+    uint32_t slaveId, const Slave2MasterVariant &message,
+    const NetworkAddress &clientAddr) {
+    Log::i("Master", "Processing Slave2Master message from slave 0x%08X",
+           slaveId);
+
+    std::visit(
+        Overloaded{
+            [&](const Slave2Master::ConductionConfigResponseMessage &) {
+                Log::i("Master",
+                       "Received conduction config response from slave "
+                       "0x%08X",
+                       slaveId);
+                deviceManager.addSlave(slaveId);
+                completePendingCommand(
+                    slaveId, Master2SlaveMessageId::CONDUCTION_CFG_MSG);
+            },
+            [&](const Slave2Master::ResistanceConfigResponseMessage &) {
+                Log::i("Master",
+                       "Received resistance config response from slave "
+                       "0x%08X",
+                       slaveId);
+                deviceManager.addSlave(slaveId);
+                completePendingCommand(
+                    slaveId, Master2SlaveMessageId::RESISTANCE_CFG_MSG);
+            },
+            [&](const Slave2Master::ClipConfigResponseMessage &) {
+                Log::i("Master",
+                       "Received clip config response from slave 0x%08X",
+                       slaveId);
+                completePendingCommand(slaveId,
+                                       Master2SlaveMessageId::CLIP_CFG_MSG);
+            },
+            [&](const Slave2Master::RstResponseMessage &) {
+                Log::i("Master", "Received reset response from slave 0x%08X",
+                       slaveId);
+                completePendingCommand(slaveId, Master2SlaveMessageId::RST_MSG);
+            },
+            [&](const Slave2Master::AnnounceMessage &announce) {
+                handleAnnounce(slaveId, announce, clientAddr);
+            },
+            [&](const Slave2Master::ShortIdConfirmMessage &confirm) {
+                Log::i("Master",
+                       "Slave 0x%08X confirmed short ID %d (status=%d)",
+                       slaveId, static_cast<int>(confirm.shortId),
+                       static_cast<int>(confirm.status));
+            },
+            [&](const Slave2Master::PingRspMessage &pingRsp) {
+                Log::i("Master",
+                       "Received ping response from slave 0x%08X (seq=%d)",
+                       slaveId, pingRsp.sequenceNumber);
+
+                // Update ping session success count
+                for (auto &entry : activePingSessions) {
+                    PingSession &session = entry.second;
+                    if (session.targetId == slaveId) {
+                        session.successCount++;
+                        break;
+                    }
+                }
+            },
+            [&](const std::monostate &) {
+                Log::w("Master", "Unknown Slave2Master message type");
+            },
+            [&](const Message &other) {
+                Log::i("Master",
+                       "Unhandled Slave2Master message 0x%02X from slave "
+                       "0x%08X",
+                       static_cast<int>(other.getMessageId()), slaveId);
+            }},
+        message);
+}
+
+void MasterServer::processSlave2BackendMessage(
+    uint32_t slaveId, DeviceStatus status, const Slave2BackendVariant &message,
+    const NetworkAddress &clientAddr) {
+    const Message *dataMsg = asMessage(message);
+    if (!dataMsg) {
+        Log::w("Master", "Unknown Slave2Backend message type");
+        return;
     }
 
-    default:
-        Log::w("Master", "Unknown Slave2Master message type: 0x%02X",
-               static_cast<int>(message.getMessageId()));
-        break;
+    std::visit(Overloaded{
+                   [&](const Slave2Backend::ConductionDataMessage &msg) {
+                       Log::i("Master",
+                              "Received conduction data from slave 0x%08X - "
+                              "%zu bytes",
+                              slaveId, msg.conductionData.size());
+                   },
+                   [&](const Slave2Backend::ResistanceDataMessage &msg) {
+                       Log::i("Master",
+                              "Received resistance data from slave 0x%08X - "
+                              "%zu bytes",
+                              slaveId, msg.resistanceData.size());
+                   },
+                   [&](const Slave2Backend::ClipDataMessage &msg) {
+                       Log::i("Master",
+                              "Received clip data from slave 0x%08X - value: "
+                              "0x%02X",
+                              slaveId, msg.clipData);
+                   },
+                   [](const std::monostate &) {}},
+               message);
+
+    // 标记从机的数据已接收
+    deviceManager.markDataReceived(slaveId);
+
+    // 更新状态缓存，状态字异或得到变化的位
+    uint16_t changed = deviceManager.updateSlaveStatus(slaveId, status);
+    if (changed) {
+        Log::i("Master",
+               "Slave 0x%08X status changed: 0x%04X (changed bits 0x%04X)",
+               slaveId, status.raw(), changed);
+    }
+
+    // 将数据连同从机上报的状态字原样转发给后端
+    std::vector<std::vector<uint8_t>> packets =
+        processor.packSlave2BackendMessage(slaveId, status, *dataMsg);
+
+    for (auto &packet : packets) {
+        size_t packetSize = packet.size();
+        // 包不再使用，移交给网络层发送，异步实现无需拷贝
+        networkManager->sendToOwned(mainSocketId, std::move(packet),
+                                    backendAddr);
+
+        Log::i("Master", "Forwarded data message 0x%02X to backend - %zu bytes",
+               static_cast<int>(dataMsg->getMessageId()), packetSize);
     }
 }
 
@@ -450,64 +577,179 @@ void MasterServer::processFrame(Frame &frame,
            static_cast<int>(frame.packetId), frame.payload.size());
 
     if (frame.packetId == static_cast<uint8_t>(PacketId::BACKEND_TO_MASTER)) {
-        std::unique_ptr<Message> backendMessage;
         if (processor.parseBackend2MasterPacket(frame.payload,
                                                 backendMessage)) {
-            processBackend2MasterMessage(*backendMessage, clientAddr);
+            processBackend2MasterMessage(backendMessage, clientAddr);
         } else {
             Log::e("Master", "Failed to parse Backend2Master packet");
         }
     } else if (frame.packetId ==
                static_cast<uint8_t>(PacketId::SLAVE_TO_MASTER)) {
         uint32_t slaveId;
-        std::unique_ptr<Message> slaveMessage;
         if (processor.parseSlave2MasterPacket(frame.payload, slaveId,
                                               slaveMessage)) {
-            processSlave2MasterMessage(slaveId, *slaveMessage, clientAddr);
+            processSlave2MasterMessage(slaveId, slaveMessage, clientAddr);
         } else {
             Log::e("Master", "Failed to parse Slave2Master packet");
         }
+    } else if (frame.packetId ==
+               static_cast<uint8_t>(PacketId::SLAVE_TO_BACKEND)) {
+        // 从机数据消息，经主机转发给后端
+        uint32_t slaveId;
+        DeviceStatus deviceStatus;
+        if (!processor.parseSlave2BackendPacket(frame.payload, slaveId,
+                                                deviceStatus,
+                                                slaveDataMessage)) {
+            Log::e("Master", "Failed to parse Slave2Backend packet");
+        } else if (!decodeSlaveData(slaveId, slaveDataMessage)) {
+            Log::w("Master",
+                   "Dropping encoded data from slave 0x%08X: reference cycle "
+                   "unavailable",
+                   slaveId);
+        } else {
+            processSlave2BackendMessage(slaveId, deviceStatus,
+                                        slaveDataMessage, clientAddr);
+        }
     } else {
         Log::w("Master", "Unsupported packet type for Master: 0x%02X",
                static_cast<int>(frame.packetId));
     }
 }
 
+// 编码的数据消息在主机解码，转发给后端的始终是原始格式
+bool MasterServer::decodeSlaveData(uint32_t slaveId,
+                                   Slave2BackendVariant &message) {
+    using Slave2Backend::ConductionDataMessage;
+    using Slave2Backend::ResistanceDataMessage;
+
+    if (auto *msg = std::get_if<ConductionDataMessage>(&message)) {
+        if (!msg->encoded)
+            return true;
+        if (!conductionDecoders[slaveId].decode(msg->encoding,
+                                                ByteView(msg->conductionData),
+                                                msg->conductionLength,
+                                                msg->conductionData))
+            return false;
+        msg->encoded = false;
+    } else if (auto *msg = std::get_if<ResistanceDataMessage>(&message)) {
+        if (!msg->encoded)
+            return true;
+        if (!resistanceDecoders[slaveId].decode(msg->encoding,
+                                                ByteView(msg->resistanceData),
+                                                msg->resistanceLength,
+                                                msg->resistanceData))
+            return false;
+        msg->encoded = false;
+    }
+    return true;
+}
+
+// 从机上线: 协商能力并分配短ID
+// 不带扩展的旧版本从机按能力为0记录档案，继续使用默认格式且不启用数据编码
+void MasterServer::handleAnnounce(uint32_t slaveId,
+                                  const Slave2Master::AnnounceMessage &announce,
+                                  const NetworkAddress &clientAddr) {
+    Master2Slave::ShortIdAssignMessage assign;
+    assign.shortId = deviceManager.assignShortId(slaveId);
+    if (assign.shortId == 0) {
+        Log::e("Master", "No short ID available for slave 0x%08X", slaveId);
+        return;
+    }
+
+    PeerProfile profile = negotiateProfile(
+        Capability::SUPPORTED,
+        announce.hasExtension ? announce.capabilities : 0,
+        announce.hasExtension ? announce.maxReceiveMtu : 0);
+    processor.setPeerProfile(slaveId, profile);
+    updateCommandDatagramLimit();
+
+    Log::i("Master",
+           "Slave 0x%08X v%d.%d.%d announced%s: capabilities 0x%04X, MTU %zu",
+           slaveId, static_cast<int>(announce.versionMajor),
+           static_cast<int>(announce.versionMinor),
+           static_cast<int>(announce.versionPatch),
+           announce.hasExtension ? "" : " (legacy)", profile.capabilities,
+           profile.mtu ? profile.mtu : processor.getMTU());
+
+    // 只回复给携带扩展的从机，旧版本从机收到的仍是1字节的短ID
+    if (announce.hasExtension) {
+        assign.hasExtension = true;
+        assign.capabilities = profile.capabilities;
+        assign.maxReceiveMtu = MAX_RECEIVE_MTU;
+    }
+
+    deviceManager.addSlave(slaveId, assign.shortId);
+    sendCommandToSlave(slaveId, assign, clientAddr);
+}
+
+uint8_t MasterServer::getConductionAckSequence(uint32_t slaveId) const {
+    if (!supportsDataEncoding(slaveId))
+        return DataCodec::ACK_LEGACY;
+    auto it = conductionDecoders.find(slaveId);
+    return it != conductionDecoders.end() ? it->second.ackSequence()
+                                          : DataCodec::ACK_NONE;
+}
+
+uint8_t MasterServer::getResistanceAckSequence(uint32_t slaveId) const {
+    if (!supportsDataEncoding(slaveId))
+        return DataCodec::ACK_LEGACY;
+    auto it = resistanceDecoders.find(slaveId);
+    return it != resistanceDecoders.end() ? it->second.ackSequence()
+                                          : DataCodec::ACK_NONE;
+}
+
+// 协商时未声明数据编码能力的从机按原始格式上报；未通告的从机保持原有行为
+bool MasterServer::supportsDataEncoding(uint32_t slaveId) const {
+    PeerProfile profile;
+    return !processor.getPeerProfile(slaveId, profile) ||
+           profile.supports(Capability::DATA_ENCODING);
+}
+
 void MasterServer::onNetworkEvent(const NetworkEvent &event) {
     switch (event.type) {
     case NetworkEventType::DATA_RECEIVED: {
         Log::i("Master", "Received %zu bytes from %s:%d", event.data.size(),
                event.remoteAddr.ip.c_str(), event.remoteAddr.port);
 
-        // Convert to hex string for processing (maintaining compatibility)
-        std::string receivedStr = bytesToHexString(event.data);
-
-        // Remove spaces and line breaks
-        receivedStr.erase(
-            std::remove_if(receivedStr.begin(), receivedStr.end(),
-                           [](char c) { return std::isspace(c); }),
-            receivedStr.end());
-
-        std::vector<uint8_t> data;
-
-        // If it's a hexadecimal string, convert it to bytes
-        if (receivedStr.length() > 0 &&
-            std::all_of(receivedStr.begin(), receivedStr.end(),
-                        [](char c) { return std::isxdigit(c); })) {
-            data = hexStringToBytes(receivedStr);
-            Log::i("Master", "Received hexadecimal string: %s",
-                   receivedStr.c_str());
-        } else {
-            // Otherwise, treat it as binary data directly
-            data = event.data;
-            Log::i("Master", "Received binary data");
+        ByteView datagram(event.data.data(), event.data.size());
+        std::vector<uint8_t> decodedHex;
+        if (hexInputDebug) {
+            // 调试模式: 打印数据报；手工发送的十六进制文本先转换为字节
+            std::string text(event.data.begin(), event.data.end());
+            text.erase(std::remove_if(text.begin(), text.end(),
+                                      [](unsigned char c) {
+                                          return std::isspace(c);
+                                      }),
+                       text.end());
+
+            if (!text.empty() &&
+                std::all_of(text.begin(), text.end(), [](unsigned char c) {
+                    return std::isxdigit(c);
+                })) {
+                decodedHex = hexStringToBytes(text);
+                datagram = ByteView(decodedHex);
+                Log::i("Master", "Received hexadecimal string: %s",
+                       text.c_str());
+            } else {
+                Log::i("Master", "Received binary data: %s",
+                       bytesToHexString(datagram).c_str());
+            }
         }
 
-        if (!data.empty()) {
-            processor.processReceivedData(data);
-            Frame receivedFrame;
+        if (!datagram.empty()) {
+            // 按发送方选择解码上下文，UDP 数据报边界即帧边界，直接在数据报
+            // 上解析，不同发送方的数据不会互相拼接
+            uint64_t key = senderKey(event.remoteAddr);
+            uint64_t nowMs = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count());
+            peerDecoders.evictIdle(nowMs);
+            FrameDecoder &decoder = peerDecoders.get(key, nowMs);
+            decoder.processDatagram(datagram, key);
+
             int frameCount = 0;
-            while (processor.getNextCompleteFrame(receivedFrame)) {
+            while (decoder.getNextCompleteFrame(receivedFrame)) {
                 frameCount++;
                 Log::i("Master",
                        "Parsed frame %d: PacketId=%d, payload size=%zu",
@@ -543,19 +785,34 @@ void MasterServer::run() {
     networkManager->start();
 
     while (true) {
-        // Process pending commands, ping sessions, and data collection
-        processPendingCommands();
-        processPingSessions();
+        // Process command retries, ping sessions, and data collection
+        processTimers();
         processDataCollection();
 
         // Process network events
         networkManager->processEvents();
 
-        // Small delay to prevent busy waiting
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // 本轮产生的广播命令在截止时间到达后合并发送
+        if (commandCoalescer.due(getCurrentTimestampMs(),
+                                 commandCoalesceDeadlineMs))
+            flushCommands();
+
+        // 阻塞等待网络事件，最迟在下一个定时任务到期时醒来
+        networkManager->waitForEvents(nextTimerDelayMs());
     }
 }
 
+uint32_t MasterServer::nextTimerDelayMs() {
+    uint32_t currentTime = getCurrentTimestampMs();
+    uint32_t delay = MAX_IDLE_WAIT_MS;
+
+    delay = std::min(delay, timers.msUntilNext(currentTime));
+    delay = std::min(delay, deviceManager.msUntilNextCycleEvent(currentTime));
+    delay = std::min(delay, commandCoalescer.msUntilDue(
+                                currentTime, commandCoalesceDeadlineMs));
+    return delay;
+}
+
 // 数据采集管理
 void MasterServer::processDataCollection() {
     DeviceManager &dm = getDeviceManager();
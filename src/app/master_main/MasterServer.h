@@ -5,7 +5,10 @@
 #include "CommandTracking.h"
 #include "DeviceManager.h"
 #include "MessageHandlers.h"
+#include "TimerQueue.h"
 #include "WhtsProtocol.h"
+#include <deque>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -22,13 +25,51 @@ class MasterServer {
     NetworkAddress serverAddr;
     NetworkAddress backendAddr;        // Backend address (port 8079)
     NetworkAddress slaveBroadcastAddr; // Slave broadcast address (port 8081)
+    // 打包与解析 (const 成员)，主循环与网络线程 (ASIO) 可并发使用，无需加锁
     ProtocolProcessor processor;
+    // 每个发送方独立的接收缓冲区与分片重组状态，只由网络线程使用
+    PeerDecoders peerDecoders;
     uint16_t port;
     DeviceManager deviceManager;
-    std::unordered_map<uint8_t, std::unique_ptr<IMessageHandler>>
-        messageHandlers;
-    std::vector<PendingCommand> pendingCommands;
-    std::vector<PingSession> activePingSessions;
+    Backend2MasterHandlers backendHandlers;
+
+    // 复用的解码目标，避免每帧分配消息对象
+    Frame receivedFrame; // 与解码器的帧队列交换，载荷容量循环复用
+    Backend2MasterVariant backendMessage;
+    Slave2MasterVariant slaveMessage;
+    Slave2BackendVariant slaveDataMessage;
+
+    // 复用的命令打包缓冲区，分片以分散-聚集方式发送，不逐片拷贝
+    GatherFrames commandFrames;
+
+    // 复用的批量命令打包区: 所有命令的数据报写入同一 arena 后一次批量发送
+    PackedBatch commandBatch;
+    std::vector<Master2SlaveBatchEntry> batchEntries;
+    std::vector<ConstBuffer> batchDatagrams;
+
+    // 发往广播端口的小帧先合并，截止时间到达后在主循环中一次发送
+    // 合并后的数据报不超过所有从机中最小的MTU (从机档案变化时更新)
+    FrameCoalescer commandCoalescer;
+    uint32_t commandCoalesceDeadlineMs = 0; // 0: 每轮主循环结束时发送
+
+    // 调试: 打印接收的数据报并接受十六进制文本输入
+    bool hexInputDebug = false;
+
+    // 各从机数据消息的差分解码器
+    std::unordered_map<uint32_t, DataCodec::DeltaDecoder> conductionDecoders;
+    std::unordered_map<uint32_t, DataCodec::DeltaDecoder> resistanceDecoders;
+
+    // 命令重试与 ping 会话的截止时间由 timers 统一调度，定时器的 key 为
+    // 下面两个表的键
+    enum TimerType : uint8_t { COMMAND_RETRY_TIMER, PING_TIMER };
+    TimerQueue timers;
+    std::vector<TimerQueue::Expired> expiredTimers; // 复用的到期列表
+    uint64_t nextTimerKey = 1;
+    std::unordered_map<uint64_t, PendingCommand> pendingCommands;
+    std::map<uint64_t, PingSession> activePingSessions; // 按创建顺序
+    // 按 (从机ID, 命令Message ID) 索引的待响应命令 key，按发送顺序排列，
+    // 收到响应时完成最早的一条
+    std::unordered_map<uint64_t, std::deque<uint64_t>> pendingCommandIndex;
 
   public:
     MasterServer(uint16_t listenPort = 8080);
@@ -40,46 +81,107 @@ class MasterServer {
     uint32_t getCurrentTimestampMs();
     void printBytes(const std::vector<uint8_t> &data,
                     const std::string &description);
-    std::string bytesToHexString(const std::vector<uint8_t> &bytes);
+    std::string bytesToHexString(ByteView bytes);
+    // 由发送方地址生成分片重组使用的发送方标识
+    static uint64_t senderKey(const NetworkAddress &addr);
 
     // Core processing methods
-    void processBackend2MasterMessage(const Message &message,
+    void processBackend2MasterMessage(const Backend2MasterVariant &message,
                                       const NetworkAddress &clientAddr);
-    void processSlave2MasterMessage(uint32_t slaveId, const Message &message,
+    void processSlave2MasterMessage(uint32_t slaveId,
+                                    const Slave2MasterVariant &message,
                                     const NetworkAddress &clientAddr);
+    void processSlave2BackendMessage(uint32_t slaveId, DeviceStatus status,
+                                     const Slave2BackendVariant &message,
+                                     const NetworkAddress &clientAddr);
     void processFrame(Frame &frame, const NetworkAddress &clientAddr);
     void run();
 
     // Message sending methods
-    void sendResponseToBackend(std::unique_ptr<Message> response,
+    void sendResponseToBackend(const Message &response,
                                const NetworkAddress &clientAddr);
-    void sendCommandToSlave(uint32_t slaveId, std::unique_ptr<Message> command,
+    void sendCommandToSlave(uint32_t slaveId, const Message &command,
                             const NetworkAddress &clientAddr);
     void sendCommandToSlaveWithRetry(uint32_t slaveId,
-                                     std::unique_ptr<Message> command,
+                                     const Master2SlaveVariant &command,
                                      const NetworkAddress &clientAddr,
                                      uint8_t maxRetries = 3);
+    // 批量发送命令: 打包到同一 arena 后一次批量广播
+    void sendCommandBatch(const std::vector<SlaveCommand> &commands);
+    void sendCommandBatchWithRetry(const std::vector<SlaveCommand> &commands,
+                                   const NetworkAddress &clientAddr,
+                                   uint8_t maxRetries = 3);
+
+    // 广播命令合并: 截止时间内产生的命令合并为不超过 MTU 的数据报
+    void setCommandCoalesceDeadline(uint32_t deadlineMs) {
+        commandCoalesceDeadlineMs = deadlineMs;
+    }
+    // 立即发送所有已合并的命令
+    void flushCommands();
+
+    // 调试模式: 以十六进制打印每个接收的数据报，内容为十六进制文本
+    // (如用 UDP 调试工具手工发送) 时先转换为字节再解析。默认关闭
+    void setHexInputDebug(bool enable) { hexInputDebug = enable; }
 
     // Command management
-    void processPendingCommands();
     void addPingSession(uint32_t targetId, uint8_t pingMode,
                         uint16_t totalCount, uint16_t interval,
                         const NetworkAddress &clientAddr);
-    void processPingSessions();
+    // 处理到期的命令重试与 ping 定时器，到期的重试合并为一批发送
+    void processTimers();
 
     // 数据采集管理
     void processDataCollection();
 
+    // 距最近的定时任务 (命令重试、ping、采集周期、命令合并) 到期的毫秒数
+    // 主循环以此作为等待网络事件的超时，最长 MAX_IDLE_WAIT_MS
+    uint32_t nextTimerDelayMs();
+
+    // 主机能接收的最大帧长，在 Short ID Assign 中告知从机
+    static constexpr uint16_t MAX_RECEIVE_MTU = 1400;
+    // 未收到响应的命令的重发间隔
+    static constexpr uint32_t COMMAND_RETRY_TIMEOUT_MS = 5000;
+    // 没有定时任务时主循环的最长等待时间
+    static constexpr uint32_t MAX_IDLE_WAIT_MS = 1000;
+
+    // 读取数据请求中携带的确认字节 (见 utils/DataCodec.h)
+    uint8_t getConductionAckSequence(uint32_t slaveId) const;
+    uint8_t getResistanceAckSequence(uint32_t slaveId) const;
+
     // Device management
     DeviceManager &getDeviceManager() { return deviceManager; }
     ProtocolProcessor &getProcessor() { return processor; }
     NetworkManager *getNetworkManager() { return networkManager.get(); }
 
-    // Register message handlers
-    void registerMessageHandler(uint8_t messageId,
-                                std::unique_ptr<IMessageHandler> handler);
-
   private:
-    void initializeMessageHandlers();
     void onNetworkEvent(const NetworkEvent &event);
+    // 登记等待响应的命令并安排重试
+    void trackPendingCommand(uint32_t slaveId,
+                             const Master2SlaveVariant &command,
+                             const NetworkAddress &clientAddr,
+                             uint8_t maxRetries, uint32_t now);
+    // 重试超时: 加入 batchEntries 或在重试次数用尽时移除
+    void handleCommandTimeout(uint64_t key, uint32_t now);
+    // 从机响应后取消对应命令的重试
+    void completePendingCommand(uint32_t slaveId,
+                                Master2SlaveMessageId commandId);
+    // 移除待响应命令及其索引 (定时器由调用方处理)
+    void erasePendingCommand(
+        std::unordered_map<uint64_t, PendingCommand>::iterator it);
+    static uint64_t pendingIndexKey(uint32_t slaveId, uint8_t messageId) {
+        return (static_cast<uint64_t>(slaveId) << 8) | messageId;
+    }
+    void handlePingTimer(uint64_t key, uint32_t now);
+    // 打包 batchEntries 中的命令并加入合并队列
+    void broadcastBatchEntries();
+    void queueCommandDatagram(ByteView datagram);
+    // 按当前从机档案中最小的MTU更新合并数据报的上限
+    void updateCommandDatagramLimit();
+    // 处理从机上线通告: 协商能力、分配短ID并回复 Short ID Assign
+    void handleAnnounce(uint32_t slaveId,
+                        const Slave2Master::AnnounceMessage &announce,
+                        const NetworkAddress &clientAddr);
+    bool supportsDataEncoding(uint32_t slaveId) const;
+    // 把压缩编码的数据消息还原为原始格式，参考周期不匹配时返回false
+    bool decodeSlaveData(uint32_t slaveId, Slave2BackendVariant &message);
 };
\ No newline at end of file
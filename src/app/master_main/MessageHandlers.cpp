@@ -6,44 +6,33 @@
 using namespace Interface;
 
 // Slave Configuration Message Handler
-std::unique_ptr<Message>
-SlaveConfigHandler::processMessage(const Message &message,
+Master2BackendVariant
+SlaveConfigHandler::processMessage(const MessageType &message,
                                    MasterServer *server) {
-    const auto *configMsg =
-        dynamic_cast<const Backend2Master::SlaveConfigMessage *>(&message);
-    if (!configMsg)
-        return nullptr;
-
     Log::i("SlaveConfigHandler", "Processing slave config message");
 
-    auto response =
-        std::make_unique<Master2Backend::SlaveConfigResponseMessage>();
-    response->status = 0; // Success
-    response->slaveNum = configMsg->slaveNum;
+    Master2Backend::SlaveConfigResponseMessage response;
+    response.status = 0; // Success
+    response.slaveNum = message.slaveNum;
 
     // Copy slaves info
-    for (const auto &slave : configMsg->slaves) {
+    for (const auto &slave : message.slaves) {
         Master2Backend::SlaveConfigResponseMessage::SlaveInfo slaveInfo;
         slaveInfo.id = slave.id;
         slaveInfo.conductionNum = slave.conductionNum;
         slaveInfo.resistanceNum = slave.resistanceNum;
         slaveInfo.clipMode = slave.clipMode;
         slaveInfo.clipStatus = slave.clipStatus;
-        response->slaves.push_back(slaveInfo);
+        response.slaves.push_back(slaveInfo);
     }
 
-    return std::move(response);
+    return response;
 }
 
-void SlaveConfigHandler::executeActions(const Message &message,
+void SlaveConfigHandler::executeActions(const MessageType &message,
                                         MasterServer *server) {
-    const auto *configMsg =
-        dynamic_cast<const Backend2Master::SlaveConfigMessage *>(&message);
-    if (!configMsg)
-        return;
-
     // Store slave configurations in device manager
-    for (const auto &slave : configMsg->slaves) {
+    for (const auto &slave : message.slaves) {
         server->getDeviceManager().addSlave(slave.id);
         server->getDeviceManager().setSlaveConfig(slave.id, slave);
         Log::i("SlaveConfigHandler",
@@ -55,103 +44,91 @@ void SlaveConfigHandler::executeActions(const Message &message,
     }
 
     Log::i("SlaveConfigHandler", "Configuration actions executed for %d slaves",
-           static_cast<int>(configMsg->slaveNum));
+           static_cast<int>(message.slaveNum));
 }
 
 // Mode Configuration Message Handler
-std::unique_ptr<Message>
-ModeConfigHandler::processMessage(const Message &message,
+Master2BackendVariant
+ModeConfigHandler::processMessage(const MessageType &message,
                                   MasterServer *server) {
-    const auto *modeMsg =
-        dynamic_cast<const Backend2Master::ModeConfigMessage *>(&message);
-    if (!modeMsg)
-        return nullptr;
-
     Log::i("ModeConfigHandler", "Processing mode config message - Mode: %d",
-           static_cast<int>(modeMsg->mode));
+           static_cast<int>(message.mode));
 
-    auto response =
-        std::make_unique<Master2Backend::ModeConfigResponseMessage>();
-    response->status = 0; // Success
-    response->mode = modeMsg->mode;
+    Master2Backend::ModeConfigResponseMessage response;
+    response.status = 0; // Success
+    response.mode = message.mode;
 
-    return std::move(response);
+    return response;
 }
 
-void ModeConfigHandler::executeActions(const Message &message,
+void ModeConfigHandler::executeActions(const MessageType &message,
                                        MasterServer *server) {
-    const auto *modeMsg =
-        dynamic_cast<const Backend2Master::ModeConfigMessage *>(&message);
-    if (!modeMsg)
-        return;
-
     // Set the mode in device manager
-    server->getDeviceManager().setCurrentMode(modeMsg->mode);
+    server->getDeviceManager().setCurrentMode(message.mode);
 
     Log::i("ModeConfigHandler", "Mode set to %d",
-           static_cast<int>(modeMsg->mode));
+           static_cast<int>(message.mode));
 
     // Get connected slaves and send configuration based on mode
     auto connectedSlaves = server->getDeviceManager().getConnectedSlaves();
 
+    // 所有从机的配置命令收集后一次批量发送
+    std::vector<SlaveCommand> commands;
+    commands.reserve(connectedSlaves.size());
+
     for (uint32_t slaveId : connectedSlaves) {
         if (server->getDeviceManager().hasSlaveConfig(slaveId)) {
             const auto &slaveConfig =
                 server->getDeviceManager().getSlaveConfig(slaveId);
 
-            switch (modeMsg->mode) {
+            switch (message.mode) {
             case 0: // Conduction mode
                 if (slaveConfig.conductionNum > 0) {
-                    auto condCmd = std::make_unique<
-                        Master2Slave::ConductionConfigMessage>();
-                    condCmd->timeSlot = 1;
-                    condCmd->interval = 100; // 100ms default
-                    condCmd->totalConductionNum = slaveConfig.conductionNum;
-                    condCmd->startConductionNum = 0;
-                    condCmd->conductionNum = slaveConfig.conductionNum;
-
-                    // Use retry mechanism for important configuration commands
-                    server->sendCommandToSlaveWithRetry(
-                        slaveId, std::move(condCmd), NetworkAddress{}, 3);
+                    Master2Slave::ConductionConfigMessage condCmd;
+                    condCmd.timeSlot = 1;
+                    condCmd.interval = 100; // 100ms default
+                    condCmd.totalConductionNum = slaveConfig.conductionNum;
+                    condCmd.startConductionNum = 0;
+                    condCmd.conductionNum = slaveConfig.conductionNum;
+
+                    commands.push_back({slaveId, condCmd});
                     Log::i("ModeConfigHandler",
-                           "Sent conduction config to slave 0x%08X", slaveId);
+                           "Queued conduction config for slave 0x%08X",
+                           slaveId);
                 }
                 break;
 
             case 1: // Resistance mode
                 if (slaveConfig.resistanceNum > 0) {
-                    auto resCmd = std::make_unique<
-                        Master2Slave::ResistanceConfigMessage>();
-                    resCmd->timeSlot = 1;
-                    resCmd->interval = 100; // 100ms default
-                    resCmd->totalNum = slaveConfig.resistanceNum;
-                    resCmd->startNum = 0;
-                    resCmd->num = slaveConfig.resistanceNum;
-
-                    server->sendCommandToSlaveWithRetry(
-                        slaveId, std::move(resCmd), NetworkAddress{}, 3);
+                    Master2Slave::ResistanceConfigMessage resCmd;
+                    resCmd.timeSlot = 1;
+                    resCmd.interval = 100; // 100ms default
+                    resCmd.totalNum = slaveConfig.resistanceNum;
+                    resCmd.startNum = 0;
+                    resCmd.num = slaveConfig.resistanceNum;
+
+                    commands.push_back({slaveId, resCmd});
                     Log::i("ModeConfigHandler",
-                           "Sent resistance config to slave 0x%08X", slaveId);
+                           "Queued resistance config for slave 0x%08X",
+                           slaveId);
                 }
                 break;
 
             case 2: // Clip mode
             {
-                auto clipCmd =
-                    std::make_unique<Master2Slave::ClipConfigMessage>();
-                clipCmd->interval = 100; // 100ms default
-                clipCmd->mode = slaveConfig.clipMode;
-                clipCmd->clipPin = slaveConfig.clipStatus;
-
-                server->sendCommandToSlaveWithRetry(slaveId, std::move(clipCmd),
-                                                    NetworkAddress{}, 3);
-                Log::i("ModeConfigHandler", "Sent clip config to slave 0x%08X",
-                       slaveId);
+                Master2Slave::ClipConfigMessage clipCmd;
+                clipCmd.interval = 100; // 100ms default
+                clipCmd.mode = slaveConfig.clipMode;
+                clipCmd.clipPin = slaveConfig.clipStatus;
+
+                commands.push_back({slaveId, clipCmd});
+                Log::i("ModeConfigHandler",
+                       "Queued clip config for slave 0x%08X", slaveId);
             } break;
 
             default:
                 Log::w("ModeConfigHandler", "Unknown mode: %d",
-                       static_cast<int>(modeMsg->mode));
+                       static_cast<int>(message.mode));
                 break;
             }
         } else {
@@ -160,128 +137,115 @@ void ModeConfigHandler::executeActions(const Message &message,
         }
     }
 
+    // Use retry mechanism for important configuration commands
+    server->sendCommandBatchWithRetry(commands, NetworkAddress{}, 3);
+
     Log::i("ModeConfigHandler",
            "Mode configuration applied: %d, sent to %zu slaves",
-           static_cast<int>(modeMsg->mode), connectedSlaves.size());
+           static_cast<int>(message.mode), connectedSlaves.size());
 }
 
 // Reset Message Handler
-std::unique_ptr<Message> ResetHandler::processMessage(const Message &message,
-                                                      MasterServer *server) {
-    const auto *rstMsg =
-        dynamic_cast<const Backend2Master::RstMessage *>(&message);
-    if (!rstMsg)
-        return nullptr;
-
+Master2BackendVariant ResetHandler::processMessage(const MessageType &message,
+                                                   MasterServer *server) {
     Log::i("ResetHandler", "Processing reset message - Slave count: %d",
-           static_cast<int>(rstMsg->slaveNum));
+           static_cast<int>(message.slaveNum));
 
-    for (const auto &slave : rstMsg->slaves) {
+    for (const auto &slave : message.slaves) {
         Log::i("ResetHandler",
                "  Reset Slave ID: 0x%08X, Lock: %d, Clip status: 0x%04X",
                slave.id, static_cast<int>(slave.lock), slave.clipStatus);
     }
 
-    auto response = std::make_unique<Master2Backend::RstResponseMessage>();
-    response->status = 0; // Success
-    response->slaveNum = rstMsg->slaveNum;
+    Master2Backend::RstResponseMessage response;
+    response.status = 0; // Success
+    response.slaveNum = message.slaveNum;
 
     // Copy slaves reset info
-    for (const auto &slave : rstMsg->slaves) {
+    for (const auto &slave : message.slaves) {
         Master2Backend::RstResponseMessage::SlaveRstInfo slaveRstInfo;
         slaveRstInfo.id = slave.id;
         slaveRstInfo.lock = slave.lock;
         slaveRstInfo.clipStatus = slave.clipStatus;
-        response->slaves.push_back(slaveRstInfo);
+        response.slaves.push_back(slaveRstInfo);
     }
 
-    return std::move(response);
+    return response;
 }
 
-void ResetHandler::executeActions(const Message &message,
+void ResetHandler::executeActions(const MessageType &message,
                                   MasterServer *server) {
-    const auto *rstMsg =
-        dynamic_cast<const Backend2Master::RstMessage *>(&message);
-    if (!rstMsg)
-        return;
-
     // Send reset commands to specified slaves with retry mechanism
     int successCount = 0;
-    for (const auto &slave : rstMsg->slaves) {
+    std::vector<SlaveCommand> commands;
+    commands.reserve(message.slaves.size());
+    for (const auto &slave : message.slaves) {
         if (server->getDeviceManager().isSlaveConnected(slave.id)) {
-            auto resetCmd = std::make_unique<Master2Slave::RstMessage>();
-            resetCmd->lockStatus = slave.lock;
-            resetCmd->clipLed = slave.clipStatus;
+            Master2Slave::RstMessage resetCmd;
+            resetCmd.lockStatus = slave.lock;
+            resetCmd.clipLed = slave.clipStatus;
 
-            server->sendCommandToSlaveWithRetry(slave.id, std::move(resetCmd),
-                                                NetworkAddress{}, 3);
+            commands.push_back({slave.id, resetCmd});
             successCount++;
-            Log::i(
-                "ResetHandler",
-                "Sent reset command to slave 0x%08X (lock=%d, clipLed=0x%04X)",
+            Log::i("ResetHandler",
+                   "Queued reset command for slave 0x%08X (lock=%d, "
+                   "clipLed=0x%04X)",
                 slave.id, static_cast<int>(slave.lock), slave.clipStatus);
         } else {
             Log::w("ResetHandler",
                    "Slave 0x%08X is not connected, skipping reset", slave.id);
         }
     }
+    server->sendCommandBatchWithRetry(commands, NetworkAddress{}, 3);
 
     Log::i("ResetHandler", "Reset commands sent to %d/%d slaves", successCount,
-           static_cast<int>(rstMsg->slaveNum));
+           static_cast<int>(message.slaveNum));
 }
 
 // Control Message Handler
-std::unique_ptr<Message> ControlHandler::processMessage(const Message &message,
-                                                        MasterServer *server) {
-    const auto *controlMsg =
-        dynamic_cast<const Backend2Master::CtrlMessage *>(&message);
-    if (!controlMsg)
-        return nullptr;
-
+Master2BackendVariant ControlHandler::processMessage(const MessageType &message,
+                                                     MasterServer *server) {
     Log::i("ControlHandler", "Processing control message - Running status: %d",
-           static_cast<int>(controlMsg->runningStatus));
+           static_cast<int>(message.runningStatus));
 
-    auto response = std::make_unique<Master2Backend::CtrlResponseMessage>();
-    response->status = 0; // Success
-    response->runningStatus = controlMsg->runningStatus;
+    Master2Backend::CtrlResponseMessage response;
+    response.status = 0; // Success
+    response.runningStatus = message.runningStatus;
 
-    return std::move(response);
+    return response;
 }
 
-void ControlHandler::executeActions(const Message &message,
+void ControlHandler::executeActions(const MessageType &message,
                                     MasterServer *server) {
-    const auto *controlMsg =
-        dynamic_cast<const Backend2Master::CtrlMessage *>(&message);
-    if (!controlMsg)
-        return;
-
     auto &deviceManager = server->getDeviceManager();
 
     // 保存当前运行状态
-    deviceManager.setSystemRunningStatus(controlMsg->runningStatus);
+    deviceManager.setSystemRunningStatus(message.runningStatus);
 
     Log::i("ControlHandler", "Setting system running status to %d",
-           static_cast<int>(controlMsg->runningStatus));
+           static_cast<int>(message.runningStatus));
 
     // 根据运行状态执行操作
-    switch (controlMsg->runningStatus) {
+    switch (message.runningStatus) {
     case 0: // 停止
         Log::i("ControlHandler", "Stopping all operations");
 
         // 停止所有数据采集
         deviceManager.resetDataCollection();
 
-        // 向所有从机发送停止信号
-        for (uint32_t slaveId : deviceManager.getConnectedSlaves()) {
-            if (deviceManager.hasSlaveConfig(slaveId)) {
-                // 发送同步消息但设置模式为0（停止）
-                auto syncCmd = std::make_unique<Master2Slave::SyncMessage>();
-                syncCmd->mode = 0; // 停止模式
-                syncCmd->timestamp = server->getCurrentTimestampMs();
-
-                server->sendCommandToSlaveWithRetry(slaveId, std::move(syncCmd),
-                                                    NetworkAddress{}, 1);
+        // 向所有从机发送停止信号 (合并为一批)
+        {
+            std::vector<SlaveCommand> commands;
+            for (uint32_t slaveId : deviceManager.getConnectedSlaves()) {
+                if (deviceManager.hasSlaveConfig(slaveId)) {
+                    // 发送同步消息但设置模式为0（停止）
+                    Master2Slave::SyncMessage syncCmd;
+                    syncCmd.mode = 0; // 停止模式
+                    syncCmd.timestamp = server->getCurrentTimestampMs();
+                    commands.push_back({slaveId, syncCmd});
+                }
             }
+            server->sendCommandBatchWithRetry(commands, NetworkAddress{}, 1);
         }
         break;
 
@@ -309,16 +273,18 @@ void ControlHandler::executeActions(const Message &message,
     case 2: // 重置
         Log::i("ControlHandler", "Resetting all devices");
 
-        // 重置所有从机状态
-        for (uint32_t slaveId : deviceManager.getConnectedSlaves()) {
-            if (deviceManager.hasSlaveConfig(slaveId)) {
-                auto resetCmd = std::make_unique<Master2Slave::RstMessage>();
-                resetCmd->lockStatus = 0; // 解锁
-                resetCmd->clipLed = 0;    // 关闭LED
-
-                server->sendCommandToSlaveWithRetry(
-                    slaveId, std::move(resetCmd), NetworkAddress{}, 1);
+        // 重置所有从机状态 (合并为一批)
+        {
+            std::vector<SlaveCommand> commands;
+            for (uint32_t slaveId : deviceManager.getConnectedSlaves()) {
+                if (deviceManager.hasSlaveConfig(slaveId)) {
+                    Master2Slave::RstMessage resetCmd;
+                    resetCmd.lockStatus = 0; // 解锁
+                    resetCmd.clipLed = 0;    // 关闭LED
+                    commands.push_back({slaveId, resetCmd});
+                }
             }
+            server->sendCommandBatchWithRetry(commands, NetworkAddress{}, 1);
         }
 
         // 重置设备管理器状态
@@ -327,70 +293,54 @@ void ControlHandler::executeActions(const Message &message,
 
     default:
         Log::w("ControlHandler", "Unknown running status: %d",
-               static_cast<int>(controlMsg->runningStatus));
+               static_cast<int>(message.runningStatus));
         break;
     }
 }
 
 // Ping Control Message Handler
-std::unique_ptr<Message>
-PingControlHandler::processMessage(const Message &message,
+Master2BackendVariant
+PingControlHandler::processMessage(const MessageType &message,
                                    MasterServer *server) {
-    const auto *pingMsg =
-        dynamic_cast<const Backend2Master::PingCtrlMessage *>(&message);
-    if (!pingMsg)
-        return nullptr;
-
     Log::i("PingControlHandler",
            "Processing ping control message - Mode: %d, Count: %d, Interval: "
            "%d, Target: 0x%08X",
-           static_cast<int>(pingMsg->pingMode), pingMsg->pingCount,
-           pingMsg->interval, pingMsg->destinationId);
+           static_cast<int>(message.pingMode), message.pingCount,
+           message.interval, message.destinationId);
 
-    auto response = std::make_unique<Master2Backend::PingResponseMessage>();
-    response->pingMode = pingMsg->pingMode;
-    response->totalCount = pingMsg->pingCount;
-    response->successCount = pingMsg->pingCount - 1; // Simulate 1 failure
-    response->destinationId = pingMsg->destinationId;
+    Master2Backend::PingResponseMessage response;
+    response.pingMode = message.pingMode;
+    response.totalCount = message.pingCount;
+    response.successCount = message.pingCount - 1; // Simulate 1 failure
+    response.destinationId = message.destinationId;
 
-    return std::move(response);
+    return response;
 }
 
-void PingControlHandler::executeActions(const Message &message,
+void PingControlHandler::executeActions(const MessageType &message,
                                         MasterServer *server) {
-    const auto *pingMsg =
-        dynamic_cast<const Backend2Master::PingCtrlMessage *>(&message);
-    if (!pingMsg)
-        return;
-
     // Add ping session to the server
-    server->addPingSession(pingMsg->destinationId, pingMsg->pingMode,
-                           pingMsg->pingCount, pingMsg->interval,
+    server->addPingSession(message.destinationId, message.pingMode,
+                           message.pingCount, message.interval,
                            NetworkAddress{});
 
     Log::i("PingControlHandler",
            "Added ping session for target 0x%08X (mode=%d, count=%d, "
            "interval=%d)",
-           pingMsg->destinationId, static_cast<int>(pingMsg->pingMode),
-           pingMsg->pingCount, pingMsg->interval);
+           message.destinationId, static_cast<int>(message.pingMode),
+           message.pingCount, message.interval);
 }
 
 // Device List Request Handler
-std::unique_ptr<Message>
-DeviceListHandler::processMessage(const Message &message,
+Master2BackendVariant
+DeviceListHandler::processMessage(const MessageType &message,
                                   MasterServer *server) {
-    const auto *deviceListMsg =
-        dynamic_cast<const Backend2Master::DeviceListReqMessage *>(&message);
-    if (!deviceListMsg)
-        return nullptr;
-
     Log::i("DeviceListHandler", "Processing device list request");
 
     auto connectedSlaves = server->getDeviceManager().getConnectedSlaves();
 
-    auto response =
-        std::make_unique<Master2Backend::DeviceListResponseMessage>();
-    response->deviceCount = static_cast<uint8_t>(connectedSlaves.size());
+    Master2Backend::DeviceListResponseMessage response;
+    response.deviceCount = static_cast<uint8_t>(connectedSlaves.size());
 
     // Add connected slaves to response
     for (uint32_t slaveId : connectedSlaves) {
@@ -402,16 +352,16 @@ DeviceListHandler::processMessage(const Message &message,
         deviceInfo.versionMajor = 1;
         deviceInfo.versionMinor = 2;
         deviceInfo.versionPatch = 3;
-        response->devices.push_back(deviceInfo);
+        response.devices.push_back(deviceInfo);
     }
 
     Log::i("DeviceListHandler", "Returning %d connected devices",
-           response->deviceCount);
+           response.deviceCount);
 
-    return std::move(response);
+    return response;
 }
 
-void DeviceListHandler::executeActions(const Message &message,
+void DeviceListHandler::executeActions(const MessageType &message,
                                        MasterServer *server) {
     // No additional actions needed for device list request
     Log::d("DeviceListHandler", "Device list request processed");
@@ -1,8 +1,9 @@
 #pragma once
 
 #include "WhtsProtocol.h"
-#include <memory>
 #include <string>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 using namespace WhtsProtocol;
@@ -10,15 +11,12 @@ using namespace WhtsProtocol;
 // Forward declarations
 class MasterServer;
 
-// Message handler interface for extensible message processing
-class IMessageHandler {
-  public:
-    virtual ~IMessageHandler() = default;
-    virtual std::unique_ptr<Message> processMessage(const Message &message,
-                                                    MasterServer *server) = 0;
-    virtual void executeActions(const Message &message,
-                                MasterServer *server) = 0;
-};
+// 消息处理器约定:
+//   using MessageType = 处理的 Backend2Master 消息类型;
+//   Master2BackendVariant processMessage(const MessageType&, MasterServer*);
+//   void executeActions(const MessageType&, MasterServer*);
+// processMessage 返回 std::monostate 表示无需响应。
+// 处理器按消息类型在编译期选择，不使用虚函数与 dynamic_cast。
 
 // Action result structure
 struct ActionResult {
@@ -31,49 +29,86 @@ struct ActionResult {
 };
 
 // Slave Configuration Message Handler
-class SlaveConfigHandler : public IMessageHandler {
+class SlaveConfigHandler {
   public:
-    std::unique_ptr<Message> processMessage(const Message &message,
-                                            MasterServer *server) override;
-    void executeActions(const Message &message, MasterServer *server) override;
+    using MessageType = Backend2Master::SlaveConfigMessage;
+
+    Master2BackendVariant processMessage(const MessageType &message,
+                                         MasterServer *server);
+    void executeActions(const MessageType &message, MasterServer *server);
 };
 
 // Mode Configuration Message Handler
-class ModeConfigHandler : public IMessageHandler {
+class ModeConfigHandler {
   public:
-    std::unique_ptr<Message> processMessage(const Message &message,
-                                            MasterServer *server) override;
-    void executeActions(const Message &message, MasterServer *server) override;
+    using MessageType = Backend2Master::ModeConfigMessage;
+
+    Master2BackendVariant processMessage(const MessageType &message,
+                                         MasterServer *server);
+    void executeActions(const MessageType &message, MasterServer *server);
 };
 
 // Reset Message Handler
-class ResetHandler : public IMessageHandler {
+class ResetHandler {
   public:
-    std::unique_ptr<Message> processMessage(const Message &message,
-                                            MasterServer *server) override;
-    void executeActions(const Message &message, MasterServer *server) override;
+    using MessageType = Backend2Master::RstMessage;
+
+    Master2BackendVariant processMessage(const MessageType &message,
+                                         MasterServer *server);
+    void executeActions(const MessageType &message, MasterServer *server);
 };
 
 // Control Message Handler
-class ControlHandler : public IMessageHandler {
+class ControlHandler {
   public:
-    std::unique_ptr<Message> processMessage(const Message &message,
-                                            MasterServer *server) override;
-    void executeActions(const Message &message, MasterServer *server) override;
+    using MessageType = Backend2Master::CtrlMessage;
+
+    Master2BackendVariant processMessage(const MessageType &message,
+                                         MasterServer *server);
+    void executeActions(const MessageType &message, MasterServer *server);
 };
 
 // Ping Control Message Handler
-class PingControlHandler : public IMessageHandler {
+class PingControlHandler {
   public:
-    std::unique_ptr<Message> processMessage(const Message &message,
-                                            MasterServer *server) override;
-    void executeActions(const Message &message, MasterServer *server) override;
+    using MessageType = Backend2Master::PingCtrlMessage;
+
+    Master2BackendVariant processMessage(const MessageType &message,
+                                         MasterServer *server);
+    void executeActions(const MessageType &message, MasterServer *server);
 };
 
 // Device List Request Handler
-class DeviceListHandler : public IMessageHandler {
+class DeviceListHandler {
   public:
-    std::unique_ptr<Message> processMessage(const Message &message,
-                                            MasterServer *server) override;
-    void executeActions(const Message &message, MasterServer *server) override;
-};
\ No newline at end of file
+    using MessageType = Backend2Master::DeviceListReqMessage;
+
+    Master2BackendVariant processMessage(const MessageType &message,
+                                         MasterServer *server);
+    void executeActions(const MessageType &message, MasterServer *server);
+};
+
+// 全部 Backend2Master 消息处理器，新增消息类型时在此登记
+using Backend2MasterHandlers =
+    std::tuple<SlaveConfigHandler, ModeConfigHandler, ResetHandler,
+               ControlHandler, PingControlHandler, DeviceListHandler>;
+
+// 判断处理器元组中是否存在处理消息类型 MessageT 的处理器
+template <typename MessageT, typename Handlers> struct HasHandlerFor;
+template <typename MessageT, typename... Hs>
+struct HasHandlerFor<MessageT, std::tuple<Hs...>>
+    : std::bool_constant<(
+          std::is_same<typename Hs::MessageType, MessageT>::value || ...)> {};
+
+// 编译期查找处理消息类型 MessageT 的处理器
+template <typename MessageT, size_t I = 0, typename... Hs>
+auto &handlerFor(std::tuple<Hs...> &handlers) {
+    using Handler = std::tuple_element_t<I, std::tuple<Hs...>>;
+    if constexpr (std::is_same<typename Handler::MessageType,
+                               MessageT>::value) {
+        return std::get<I>(handlers);
+    } else {
+        static_assert(I + 1 < sizeof...(Hs), "no handler for message type");
+        return handlerFor<MessageT, I + 1>(handlers);
+    }
+}
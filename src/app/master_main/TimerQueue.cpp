@@ -0,0 +1,74 @@
+#include "TimerQueue.h"
+#include <algorithm>
+
+bool TimerQueue::later(const Entry &a, const Entry &b) {
+    int32_t diff = static_cast<int32_t>(a.deadlineMs - b.deadlineMs);
+    if (diff != 0)
+        return diff > 0;
+    return a.id > b.id;
+}
+
+TimerQueue::TimerId TimerQueue::schedule(uint32_t deadlineMs, uint8_t type,
+                                         uint64_t key) {
+    compactIfNeeded();
+
+    TimerId id = nextId_++;
+    heap_.push_back({deadlineMs, id, type, key});
+    std::push_heap(heap_.begin(), heap_.end(), later);
+    armed_.insert(id);
+    return id;
+}
+
+bool TimerQueue::cancel(TimerId id) { return armed_.erase(id) > 0; }
+
+size_t TimerQueue::popExpired(uint32_t nowMs, std::vector<Expired> &out) {
+    size_t count = 0;
+    while (!heap_.empty()) {
+        const Entry &top = heap_.front();
+        bool live = armed_.count(top.id) > 0;
+        if (live && static_cast<int32_t>(top.deadlineMs - nowMs) > 0)
+            break;
+
+        if (live) {
+            out.push_back({top.id, top.type, top.key});
+            armed_.erase(top.id);
+            ++count;
+        }
+        std::pop_heap(heap_.begin(), heap_.end(), later);
+        heap_.pop_back();
+    }
+    return count;
+}
+
+uint32_t TimerQueue::msUntilNext(uint32_t nowMs) {
+    discardCancelled();
+    if (heap_.empty())
+        return UINT32_MAX;
+
+    int32_t remaining = static_cast<int32_t>(heap_.front().deadlineMs - nowMs);
+    return remaining > 0 ? static_cast<uint32_t>(remaining) : 0;
+}
+
+void TimerQueue::clear() {
+    heap_.clear();
+    armed_.clear();
+}
+
+void TimerQueue::discardCancelled() {
+    while (!heap_.empty() && armed_.count(heap_.front().id) == 0) {
+        std::pop_heap(heap_.begin(), heap_.end(), later);
+        heap_.pop_back();
+    }
+}
+
+void TimerQueue::compactIfNeeded() {
+    if (heap_.size() < MIN_COMPACT_SIZE || heap_.size() <= 2 * armed_.size())
+        return;
+
+    heap_.erase(std::remove_if(heap_.begin(), heap_.end(),
+                               [this](const Entry &entry) {
+                                   return armed_.count(entry.id) == 0;
+                               }),
+                heap_.end());
+    std::make_heap(heap_.begin(), heap_.end(), later);
+}
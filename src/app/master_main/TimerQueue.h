@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+// 主机定时任务调度 (最小堆)
+// 命令重试与 ping 会话的截止时间统一由调度器保存，主循环每轮只取出到期的
+// 定时器，不再扫描全部命令；最近的截止时间作为等待网络事件的超时。
+// 取消只从登记表中删除 (O(1))，堆中的旧条目在到达堆顶时丢弃，
+// 失效条目过多时整体重建。
+// 时间为 getCurrentTimestampMs() 的毫秒数，按回绕安全的方式比较。
+// 只由主循环线程使用。
+class TimerQueue {
+  public:
+    using TimerId = uint64_t; // 0 表示无效
+
+    // 到期的定时器: type 与 key 由使用方定义 (如命令编号)
+    struct Expired {
+        TimerId id;
+        uint8_t type;
+        uint64_t key;
+    };
+
+    // 在 deadlineMs 到期，返回可用于取消的定时器编号
+    TimerId schedule(uint32_t deadlineMs, uint8_t type, uint64_t key);
+
+    // 取消尚未到期的定时器，返回是否存在
+    bool cancel(TimerId id);
+
+    // 取出全部在 nowMs 之前 (含) 到期的定时器，按截止时间与创建顺序追加
+    // 处理过程中新安排的定时器不会在本次取出
+    size_t popExpired(uint32_t nowMs, std::vector<Expired> &out);
+
+    // 距最近的截止时间的毫秒数，已到期为0，没有定时器时为 UINT32_MAX
+    uint32_t msUntilNext(uint32_t nowMs);
+
+    size_t size() const { return armed_.size(); }
+    bool empty() const { return armed_.empty(); }
+    void clear();
+
+  private:
+    struct Entry {
+        uint32_t deadlineMs;
+        TimerId id;
+        uint8_t type;
+        uint64_t key;
+    };
+
+    // 堆比较: 截止时间晚的优先级低，相同截止时间按创建顺序
+    static bool later(const Entry &a, const Entry &b);
+
+    // 丢弃堆顶已取消的条目
+    void discardCancelled();
+    // 失效条目超过有效条目时重建堆
+    void compactIfNeeded();
+
+    std::vector<Entry> heap_;
+    std::unordered_set<TimerId> armed_;
+    TimerId nextId_ = 1;
+
+    static constexpr size_t MIN_COMPACT_SIZE = 64;
+};
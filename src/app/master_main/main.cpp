@@ -1,7 +1,8 @@
 #include "../Logger.h"
 #include "MasterServer.h"
+#include <cstring>
 
-int main() {
+int main(int argc, char *argv[]) {
     Log::i("Main", "WhtsProtocol Master Server");
     Log::i("Main", "==========================");
 
@@ -26,6 +27,13 @@ int main() {
 
     try {
         MasterServer server(8080);
+        // --hex-input: 接受十六进制文本形式的数据报 (调试用)
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--hex-input") == 0) {
+                server.setHexInputDebug(true);
+                Log::i("Main", "Hexadecimal input debug mode enabled");
+            }
+        }
         server.run();
     } catch (const std::exception &e) {
         Log::e("Main", "Error: %s", e.what());
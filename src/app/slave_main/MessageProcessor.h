@@ -5,9 +5,24 @@
 #include "WhtsProtocol.h"
 #include <memory>
 #include <mutex>
+#include <variant>
 
 namespace SlaveApp {
 
+// 从机响应消息: Slave2Master 或 Slave2Backend 消息
+// std::monostate 表示不需要响应
+using SlaveResponse =
+    std::variant<std::monostate,
+                 WhtsProtocol::Slave2Master::ConductionConfigResponseMessage,
+                 WhtsProtocol::Slave2Master::ResistanceConfigResponseMessage,
+                 WhtsProtocol::Slave2Master::ClipConfigResponseMessage,
+                 WhtsProtocol::Slave2Master::RstResponseMessage,
+                 WhtsProtocol::Slave2Master::PingRspMessage,
+                 WhtsProtocol::Slave2Master::ShortIdConfirmMessage,
+                 WhtsProtocol::Slave2Backend::ConductionDataMessage,
+                 WhtsProtocol::Slave2Backend::ResistanceDataMessage,
+                 WhtsProtocol::Slave2Backend::ClipDataMessage>;
+
 /**
  * 消息处理器类
  * 负责处理从Master接收到的各种消息并生成相应的响应
@@ -21,9 +36,40 @@ class MessageProcessor {
     std::mutex &stateMutex;
     std::unique_ptr<Adapter::ContinuityCollector> &continuityCollector;
 
+    // 数据消息的差分编码器，保存最近发送的周期
+    WhtsProtocol::DataCodec::DeltaEncoder conductionEncoder;
+    WhtsProtocol::DataCodec::DeltaEncoder resistanceEncoder;
+    std::vector<uint8_t> encodedData;
+
+    // 主机支持时按其确认的周期压缩编码，成功后 data 替换为编码载荷
+    bool encodeData(WhtsProtocol::DataCodec::DeltaEncoder &encoder,
+                    uint8_t ackSequence, std::vector<uint8_t> &data,
+                    WhtsProtocol::DataCodec::EncodedHeader &encoding);
+
     // Get the current timestamp
     uint32_t getCurrentTimestamp();
 
+    // 各消息类型的处理函数，由重载决议在编译期分派
+    SlaveResponse handle(const std::monostate &);
+    SlaveResponse handle(const WhtsProtocol::Master2Slave::SyncMessage &msg);
+    SlaveResponse
+    handle(const WhtsProtocol::Master2Slave::ConductionConfigMessage &msg);
+    SlaveResponse
+    handle(const WhtsProtocol::Master2Slave::ResistanceConfigMessage &msg);
+    SlaveResponse
+    handle(const WhtsProtocol::Master2Slave::ClipConfigMessage &msg);
+    SlaveResponse
+    handle(const WhtsProtocol::Master2Slave::ReadConductionDataMessage &msg);
+    SlaveResponse
+    handle(const WhtsProtocol::Master2Slave::ReadResistanceDataMessage &msg);
+    SlaveResponse
+    handle(const WhtsProtocol::Master2Slave::ReadClipDataMessage &msg);
+    SlaveResponse handle(const WhtsProtocol::Master2Slave::RstMessage &msg);
+    SlaveResponse
+    handle(const WhtsProtocol::Master2Slave::PingReqMessage &msg);
+    SlaveResponse
+    handle(const WhtsProtocol::Master2Slave::ShortIdAssignMessage &msg);
+
   public:
     MessageProcessor(
         uint32_t deviceId, SlaveDeviceState &deviceState,
@@ -34,10 +80,10 @@ class MessageProcessor {
     /**
      * 处理Master2Slave消息并生成响应
      * @param request 接收到的消息
-     * @return 生成的响应消息，如果不需要响应则返回nullptr
+     * @return 生成的响应消息，如果不需要响应则为 std::monostate
      */
-    std::unique_ptr<WhtsProtocol::Message>
-    processAndCreateResponse(const WhtsProtocol::Message &request);
+    SlaveResponse
+    processAndCreateResponse(const WhtsProtocol::Master2SlaveVariant &request);
 
     /**
      * 重置设备状态
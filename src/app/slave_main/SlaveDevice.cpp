@@ -2,7 +2,6 @@
 #include "../Logger.h"
 #include <chrono>
 #include <iostream>
-#include <thread>
 
 using namespace WhtsProtocol;
 using namespace Interface;
@@ -11,7 +10,7 @@ namespace SlaveApp {
 
 SlaveDevice::SlaveDevice(uint16_t listenPort, uint32_t id)
     : port(listenPort), deviceId(id), deviceState(SlaveDeviceState::IDLE),
-      isConfigured(false) {
+      isConfigured(false), shortIdAssigned(false) {
 
     // 创建网络管理器
     networkManager = NetworkFactory::createNetworkManager();
@@ -69,6 +68,74 @@ bool SlaveDevice::initialize() {
     return true;
 }
 
+void SlaveDevice::sendResponse(const SlaveResponse &response) {
+    std::visit(
+        [this](const auto &msg) {
+            using T = std::decay_t<decltype(msg)>;
+            if constexpr (!std::is_same<T, std::monostate>::value) {
+                Log::i("SlaveDevice", "Generated response message");
+
+                // 数据消息走 Slave2Backend，其余响应走 Slave2Master
+                std::vector<std::vector<uint8_t>> responseData;
+                if constexpr (IsVariantMember<T, Slave2BackendVariant>::value) {
+                    Log::i("SlaveDevice", "Packing Slave2Backend message");
+                    responseData = processor.packSlave2BackendMessage(
+                        deviceId, deviceStatus, msg);
+                } else {
+                    responseData =
+                        processor.packSlave2MasterMessage(deviceId, msg);
+                }
+
+                Log::i("SlaveDevice", "Sending response:");
+
+                // Send all fragments to master
+                for (const auto &fragment : responseData) {
+                    networkManager->sendTo(mainSocketId, fragment, masterAddr);
+                }
+            }
+        },
+        response);
+}
+
+void SlaveDevice::sendAnnounce() {
+    Slave2Master::AnnounceMessage announce;
+    announce.deviceId = deviceId;
+    announce.versionMajor = 1;
+    announce.versionMinor = 2;
+    announce.versionPatch = 3;
+    announce.hasExtension = true;
+    announce.capabilities = Capability::SUPPORTED;
+    announce.maxReceiveMtu = MAX_RECEIVE_MTU;
+
+    for (const auto &fragment :
+         processor.packSlave2MasterMessage(deviceId, announce)) {
+        networkManager->sendTo(mainSocketId, fragment, masterAddr);
+    }
+    lastAnnounceTime = std::chrono::steady_clock::now();
+    Log::i("SlaveDevice", "Sent announce (capabilities 0x%04X, MTU %d)",
+           announce.capabilities, static_cast<int>(MAX_RECEIVE_MTU));
+}
+
+void SlaveDevice::applyShortIdAssign(
+    const Master2Slave::ShortIdAssignMessage &msg) {
+    shortIdAssigned = true;
+    if (!msg.hasExtension) {
+        // 旧版本主机，保持默认格式
+        Log::i("SlaveDevice", "Master did not negotiate capabilities");
+        return;
+    }
+
+    PeerProfile profile = negotiateProfile(
+        Capability::SUPPORTED, msg.capabilities, msg.maxReceiveMtu);
+    processor.setChecksumType(profile.checksumType);
+    if (profile.mtu)
+        processor.setMTU(profile.mtu);
+    Log::i("SlaveDevice",
+           "Negotiated capabilities 0x%04X, checksum %d, MTU %zu",
+           profile.capabilities, static_cast<int>(profile.checksumType),
+           processor.getMTU());
+}
+
 void SlaveDevice::processFrame(Frame &frame, const NetworkAddress &senderAddr) {
     Log::i("SlaveDevice",
            "Processing frame - PacketId: 0x%02X, payload size: %zu",
@@ -76,7 +143,6 @@ void SlaveDevice::processFrame(Frame &frame, const NetworkAddress &senderAddr) {
 
     if (frame.packetId == static_cast<uint8_t>(PacketId::MASTER_TO_SLAVE)) {
         uint32_t targetSlaveId;
-        std::unique_ptr<Message> masterMessage;
 
         if (processor.parseMaster2SlavePacket(frame.payload, targetSlaveId,
                                               masterMessage)) {
@@ -86,43 +152,20 @@ void SlaveDevice::processFrame(Frame &frame, const NetworkAddress &senderAddr) {
                        "Processing Master2Slave message for device 0x%08X, "
                        "Message ID: 0x%02X",
                        targetSlaveId,
-                       static_cast<int>(masterMessage->getMessageId()));
+                       static_cast<int>(
+                           asMessage(masterMessage)->getMessageId()));
 
-                // Process message and create response
-                auto response =
-                    messageProcessor->processAndCreateResponse(*masterMessage);
-
-                if (response) {
-                    Log::i("SlaveDevice", "Generated response message");
-
-                    std::vector<std::vector<uint8_t>> responseData;
-                    DeviceStatus deviceStatus = {};
-
-                    if (response->getMessageId() ==
-                            static_cast<uint8_t>(
-                                Slave2BackendMessageId::CONDUCTION_DATA_MSG) ||
-                        response->getMessageId() ==
-                            static_cast<uint8_t>(
-                                Slave2BackendMessageId::RESISTANCE_DATA_MSG) ||
-                        response->getMessageId() ==
-                            static_cast<uint8_t>(
-                                Slave2BackendMessageId::CLIP_DATA_MSG)) {
-                        Log::i("SlaveDevice", "Packing Slave2Backend message");
-                        responseData = processor.packSlave2BackendMessage(
-                            deviceId, deviceStatus, *response);
-                    } else {
-                        responseData = processor.packSlave2MasterMessage(
-                            deviceId, *response);
-                    }
-
-                    Log::i("SlaveDevice", "Sending response:");
-
-                    // Send all fragments to master
-                    for (const auto &fragment : responseData) {
-                        networkManager->sendTo(mainSocketId, fragment,
-                                               masterAddr);
-                    }
+                if (auto *assign =
+                        std::get_if<Master2Slave::ShortIdAssignMessage>(
+                            &masterMessage)) {
+                    applyShortIdAssign(*assign);
                 }
+
+                // Process message and create response
+                SlaveResponse response =
+                    messageProcessor->processAndCreateResponse(masterMessage);
+
+                sendResponse(response);
             } else {
                 Log::d("SlaveDevice",
                        "Message not for this device (target: 0x%08X, our ID: "
@@ -144,10 +187,19 @@ void SlaveDevice::run() {
     Log::i("SlaveDevice", "Handling Master2Slave broadcast packets");
     Log::i("SlaveDevice", "Sending responses to Master on port 8080");
 
-    uint8_t buffer[1024];
+    uint8_t buffer[MAX_RECEIVE_MTU];
     NetworkAddress senderAddr;
 
+    sendAnnounce();
+
     while (true) {
+        // 尚未分配短ID时定期重发通告 (主机可能晚于从机启动)
+        if (!shortIdAssigned &&
+            std::chrono::steady_clock::now() - lastAnnounceTime >=
+                std::chrono::milliseconds(ANNOUNCE_INTERVAL_MS)) {
+            sendAnnounce();
+        }
+
         // 处理采集状态（状态机）
         if (isConfigured && deviceState == SlaveDeviceState::COLLECTING) {
             continuityCollector->processCollection();
@@ -165,18 +217,36 @@ void SlaveDevice::run() {
             mainSocketId, buffer, sizeof(buffer), senderAddr);
 
         if (bytesReceived > 0) {
-            std::vector<uint8_t> data(buffer, buffer + bytesReceived);
-
-            processor.processReceivedData(data);
+            // 直接以视图形式交给协议处理器，避免额外拷贝
+            processor.processReceivedData(
+                ByteView(buffer, static_cast<size_t>(bytesReceived)));
             Frame receivedFrame;
             while (processor.getNextCompleteFrame(receivedFrame)) {
                 processFrame(receivedFrame, senderAddr);
             }
         } else {
-            // 如果没有数据，短暂休眠以避免CPU占用过高
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            // 没有数据时等待套接字可读或下一个定时事件
+            networkManager->waitForEvents(nextWaitMs());
         }
     }
 }
 
+uint32_t SlaveDevice::nextWaitMs() const {
+    if (isConfigured && deviceState == SlaveDeviceState::COLLECTING) {
+        return COLLECTION_POLL_MS;
+    }
+
+    if (!shortIdAssigned) {
+        auto remaining = std::chrono::milliseconds(ANNOUNCE_INTERVAL_MS) -
+                         (std::chrono::steady_clock::now() - lastAnnounceTime);
+        if (remaining <= std::chrono::milliseconds::zero()) {
+            return 0;
+        }
+        return static_cast<uint32_t>(
+            std::chrono::ceil<std::chrono::milliseconds>(remaining).count());
+    }
+
+    return MAX_IDLE_WAIT_MS;
+}
+
 } // namespace SlaveApp
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "MessageProcessor.h"
 #include "SlaveDeviceState.h"
 #include "WhtsProtocol.h"
+#include <chrono>
 #include <memory>
 #include <mutex>
 
@@ -41,6 +42,9 @@ class SlaveDevice {
     NetworkAddress masterAddr;
     WhtsProtocol::ProtocolProcessor processor;
 
+    // 复用的解码目标，避免每帧分配消息对象
+    WhtsProtocol::Master2SlaveVariant masterMessage;
+
     std::unique_ptr<MessageProcessor> messageProcessor;
     std::unique_ptr<Adapter::ContinuityCollector> continuityCollector;
 
@@ -52,6 +56,31 @@ class SlaveDevice {
 
     uint16_t port;
     uint32_t deviceId;
+    // 本机设备状态字，随每个 Slave2Backend 包原样上报
+    WhtsProtocol::DeviceStatus deviceStatus;
+
+    // 上线通告: 分配短ID之前按固定间隔重发
+    bool shortIdAssigned;
+    std::chrono::steady_clock::time_point lastAnnounceTime;
+
+    static constexpr uint16_t MAX_RECEIVE_MTU = 1024; // 接收缓冲区大小
+    static constexpr uint32_t ANNOUNCE_INTERVAL_MS = 1000;
+    // 采集期间状态机需要持续推进，等待时间取较短值
+    static constexpr uint32_t COLLECTION_POLL_MS = 1;
+    static constexpr uint32_t MAX_IDLE_WAIT_MS = 1000;
+
+    // 打包并发送响应消息 (std::monostate 表示无需响应)
+    void sendResponse(const SlaveResponse &response);
+
+    // 发送带能力扩展的 Announce
+    void sendAnnounce();
+
+    // 主循环无数据时可以等待的时长 (下次通告或采集推进之前)
+    uint32_t nextWaitMs() const;
+
+    // 按主机回复的协商结果设置发送帧的校验尾与MTU
+    void applyShortIdAssign(
+        const WhtsProtocol::Master2Slave::ShortIdAssignMessage &msg);
 
   public:
     SlaveDevice(uint16_t listenPort = 8081, uint32_t id = 0x3732485B);
@@ -71,6 +100,14 @@ class SlaveDevice {
     void processFrame(WhtsProtocol::Frame &frame,
                       const NetworkAddress &senderAddr);
 
+    /**
+     * 更新本机设备状态
+     * @param status 新的设备状态字
+     */
+    void setDeviceStatus(WhtsProtocol::DeviceStatus status) {
+        deviceStatus = status;
+    }
+
     /**
      * 运行主循环
      */
@@ -24,7 +24,8 @@ enum class NetworkEventType {
 struct NetworkEvent {
     NetworkEventType type;
     std::string socketId;
-    std::vector<uint8_t> data;
+    // DATA_RECEIVED: 接收到的数据报，回调可以交换取走 (见 UdpReceiveCallback)
+    ReceiveBuffer data;
     NetworkAddress remoteAddr;
     std::string errorMessage;
 
@@ -34,8 +35,10 @@ struct NetworkEvent {
 
 /**
  * 网络事件回调函数类型
+ * 事件以非 const 引用传入，接收的数据可以交换取走；
+ * 接受 const NetworkEvent & 的回调同样可以使用
  */
-using NetworkEventCallback = std::function<void(const NetworkEvent &event)>;
+using NetworkEventCallback = std::function<void(NetworkEvent &event)>;
 
 /**
  * 网络管理器抽象接口
@@ -108,6 +111,65 @@ class INetwork {
     virtual bool broadcast(const std::string &socketId,
                            const std::vector<uint8_t> &data, uint16_t port) = 0;
 
+    /**
+     * 发送数据到指定地址，缓冲区所有权交给套接字 (异步实现不拷贝)
+     * @param socketId 套接字ID
+     * @param data 要发送的数据 (调用后不应再使用)
+     * @param targetAddr 目标地址
+     * @return 是否成功发起发送
+     */
+    virtual bool sendToOwned(const std::string &socketId,
+                             std::vector<uint8_t> &&data,
+                             const NetworkAddress &targetAddr) = 0;
+
+    /**
+     * 分散-聚集发送：多个缓冲区片段组成一个数据报发送到指定地址
+     * @param socketId 套接字ID
+     * @param buffers 缓冲区片段数组
+     * @param count 片段数量
+     * @param targetAddr 目标地址
+     * @return 是否成功发起发送
+     */
+    virtual bool sendToGather(const std::string &socketId,
+                              const ConstBuffer *buffers, size_t count,
+                              const NetworkAddress &targetAddr) = 0;
+
+    /**
+     * 分散-聚集广播：多个缓冲区片段组成一个数据报广播到指定端口
+     * @param socketId 套接字ID
+     * @param buffers 缓冲区片段数组
+     * @param count 片段数量
+     * @param port 目标端口
+     * @return 是否成功发起广播
+     */
+    virtual bool broadcastGather(const std::string &socketId,
+                                 const ConstBuffer *buffers, size_t count,
+                                 uint16_t port) = 0;
+
+    /**
+     * 批量发送：多个独立的数据报发送到指定地址
+     * @param socketId 套接字ID
+     * @param datagrams 数据报数组，每个元素为一个完整数据报
+     * @param count 数据报数量
+     * @param targetAddr 目标地址
+     * @return 是否全部成功发起发送
+     */
+    virtual bool sendToBatch(const std::string &socketId,
+                             const ConstBuffer *datagrams, size_t count,
+                             const NetworkAddress &targetAddr) = 0;
+
+    /**
+     * 批量广播：多个独立的数据报广播到指定端口
+     * @param socketId 套接字ID
+     * @param datagrams 数据报数组，每个元素为一个完整数据报
+     * @param count 数据报数量
+     * @param port 目标端口
+     * @return 是否全部成功发起广播
+     */
+    virtual bool broadcastBatch(const std::string &socketId,
+                                const ConstBuffer *datagrams, size_t count,
+                                uint16_t port) = 0;
+
     /**
      * 接收数据（非阻塞）
      * @param socketId 套接字ID
@@ -163,6 +225,15 @@ class INetwork {
      */
     virtual void processEvents() = 0;
 
+    /**
+     * 阻塞等待任一套接字的网络事件，代替主循环中的固定休眠
+     * 调用方按最近的定时任务计算 timeoutMs，返回后调用 processEvents
+     * 或 receiveFrom 处理数据
+     * @param timeoutMs 最长等待时间（毫秒）
+     * @return 是否有事件待处理，超时返回false
+     */
+    virtual bool waitForEvents(uint32_t timeoutMs) = 0;
+
     /**
      * 获取所有套接字ID列表
      */
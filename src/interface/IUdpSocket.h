@@ -3,7 +3,10 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <new>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace Interface {
@@ -21,13 +24,46 @@ struct NetworkAddress {
     bool isValid() const { return !ip.empty() && port > 0; }
 };
 
+/**
+ * 默认初始化分配器: resize 扩大长度时不对新元素清零
+ * 接收缓冲区在每次接收前恢复到最大长度，由内核直接写入，不需要先清零
+ */
+template <typename T> class DefaultInitAllocator : public std::allocator<T> {
+  public:
+    template <typename U> struct rebind {
+        using other = DefaultInitAllocator<U>;
+    };
+
+    DefaultInitAllocator() = default;
+    template <typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U> &) noexcept {}
+
+    template <typename U>
+    void construct(U *p) noexcept(
+        std::is_nothrow_default_constructible<U>::value) {
+        ::new (static_cast<void *>(p)) U;
+    }
+    template <typename U, typename... Args>
+    void construct(U *p, Args &&...args) {
+        ::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+/**
+ * 接收缓冲区: 内核写入一次，之后以交换 (swap) 的方式在各层之间转移所有权
+ */
+using ReceiveBuffer = std::vector<uint8_t, DefaultInitAllocator<uint8_t>>;
+
 /**
  * UDP套接字接收回调函数类型
+ * data 为套接字自己的接收缓冲区，长度为数据报长度。回调可以与自己的
+ * 缓冲区交换以取走数据 (不拷贝)，交换回来的缓冲区由套接字用于下一次接收；
+ * 不交换时 data 只在回调期间有效
  * @param data 接收到的数据
  * @param senderAddr 发送方地址
  */
 using UdpReceiveCallback = std::function<void(
-    const std::vector<uint8_t> &data, const NetworkAddress &senderAddr)>;
+    ReceiveBuffer &data, const NetworkAddress &senderAddr)>;
 
 /**
  * UDP套接字发送完成回调函数类型
@@ -36,6 +72,15 @@ using UdpReceiveCallback = std::function<void(
  */
 using UdpSendCallback = std::function<void(bool success, size_t bytesSent)>;
 
+/**
+ * 分散-聚集发送的只读缓冲区片段
+ * 多个片段按顺序组成一个数据报
+ */
+struct ConstBuffer {
+    const uint8_t *data;
+    size_t size;
+};
+
 /**
  * UDP套接字抽象接口
  * 提供跨平台的UDP通信能力
@@ -93,6 +138,88 @@ class IUdpSocket {
     virtual bool broadcast(const std::vector<uint8_t> &data, uint16_t port,
                            UdpSendCallback callback = nullptr) = 0;
 
+    /**
+     * 发送数据到指定地址，缓冲区所有权交给套接字
+     * 异步实现可将缓冲区直接移入发送队列而不拷贝，默认实现调用 sendTo
+     * @param data 要发送的数据 (调用后不应再使用)
+     * @param targetAddr 目标地址
+     * @param callback 发送完成回调（可选）
+     * @return 是否成功发起发送
+     */
+    virtual bool sendToOwned(std::vector<uint8_t> &&data,
+                             const NetworkAddress &targetAddr,
+                             UdpSendCallback callback = nullptr) {
+        return sendTo(data, targetAddr, std::move(callback));
+    }
+
+    /**
+     * 分散-聚集发送：将多个缓冲区片段作为一个数据报发送到指定地址
+     * 默认实现拼接后调用 sendTo，支持 sendmsg/WSASendTo 的平台应重写以避免拷贝
+     * 片段只需在调用期间有效
+     * @param buffers 缓冲区片段数组
+     * @param count 片段数量
+     * @param targetAddr 目标地址
+     * @param callback 发送完成回调（可选）
+     * @return 是否成功发起发送
+     */
+    virtual bool sendToGather(const ConstBuffer *buffers, size_t count,
+                              const NetworkAddress &targetAddr,
+                              UdpSendCallback callback = nullptr) {
+        return sendToOwned(concatBuffers(buffers, count), targetAddr,
+                           std::move(callback));
+    }
+
+    /**
+     * 分散-聚集广播：将多个缓冲区片段作为一个数据报广播到指定端口
+     * @param buffers 缓冲区片段数组
+     * @param count 片段数量
+     * @param port 目标端口
+     * @param callback 发送完成回调（可选）
+     * @return 是否成功发起广播
+     */
+    virtual bool broadcastGather(const ConstBuffer *buffers, size_t count,
+                                 uint16_t port,
+                                 UdpSendCallback callback = nullptr) {
+        return broadcast(concatBuffers(buffers, count), port,
+                         std::move(callback));
+    }
+
+    /**
+     * 批量发送：多个独立的数据报发送到同一地址
+     * 默认实现逐个调用 sendToGather，支持 sendmmsg 的平台应重写以减少系统调用
+     * 回调对每个数据报各调用一次
+     * @param datagrams 数据报数组，每个元素为一个完整数据报
+     * @param count 数据报数量
+     * @param targetAddr 目标地址
+     * @param callback 发送完成回调（可选）
+     * @return 是否全部成功发起发送
+     */
+    virtual bool sendToBatch(const ConstBuffer *datagrams, size_t count,
+                             const NetworkAddress &targetAddr,
+                             UdpSendCallback callback = nullptr) {
+        bool success = true;
+        for (size_t i = 0; i < count; ++i)
+            success &= sendToGather(&datagrams[i], 1, targetAddr, callback);
+        return success;
+    }
+
+    /**
+     * 批量广播：多个独立的数据报广播到指定端口
+     * @param datagrams 数据报数组，每个元素为一个完整数据报
+     * @param count 数据报数量
+     * @param port 目标端口
+     * @param callback 发送完成回调（可选）
+     * @return 是否全部成功发起广播
+     */
+    virtual bool broadcastBatch(const ConstBuffer *datagrams, size_t count,
+                                uint16_t port,
+                                UdpSendCallback callback = nullptr) {
+        bool success = true;
+        for (size_t i = 0; i < count; ++i)
+            success &= broadcastGather(&datagrams[i], 1, port, callback);
+        return success;
+    }
+
     /**
      * 接收数据（非阻塞）
      * @param buffer 接收缓冲区
@@ -139,6 +266,30 @@ class IUdpSocket {
      * 在主循环中调用以处理网络I/O事件
      */
     virtual void processEvents() = 0;
+
+    /**
+     * 阻塞等待网络事件，最多等待 timeoutMs 毫秒
+     * 有数据可读 (或异步实现已分发了接收回调) 时立即返回，不消费数据，
+     * 随后由 processEvents 或 receiveFrom 处理；timeoutMs 为0时只检查不等待
+     * @param timeoutMs 最长等待时间（毫秒）
+     * @return 是否有事件待处理，超时返回false
+     */
+    virtual bool waitForEvents(uint32_t timeoutMs) = 0;
+
+  protected:
+    static std::vector<uint8_t> concatBuffers(const ConstBuffer *buffers,
+                                              size_t count) {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i)
+            total += buffers[i].size;
+
+        std::vector<uint8_t> data;
+        data.reserve(total);
+        for (size_t i = 0; i < count; ++i)
+            data.insert(data.end(), buffers[i].data,
+                        buffers[i].data + buffers[i].size);
+        return data;
+    }
 };
 
 /**
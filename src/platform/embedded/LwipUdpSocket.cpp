@@ -8,7 +8,8 @@ namespace Embedded {
 #ifdef USE_LWIP
 
 LwipUdpSocket::LwipUdpSocket()
-    : conn(nullptr), isInitialized(false), isBound(false) {}
+    : conn(nullptr), isInitialized(false), isBound(false),
+      isNonBlocking(false), pendingBuf(nullptr) {}
 
 LwipUdpSocket::~LwipUdpSocket() { close(); }
 
@@ -69,6 +70,7 @@ bool LwipUdpSocket::setNonBlocking(bool nonBlocking) {
     } else {
         netconn_set_nonblocking(conn, 0);
     }
+    isNonBlocking = nonBlocking;
     return true;
 }
 
@@ -125,9 +127,9 @@ int LwipUdpSocket::receiveFrom(uint8_t *buffer, size_t bufferSize,
         return -1;
     }
 
-    struct netbuf *buf;
-    err_t err = netconn_recv(conn, &buf);
-    if (err != ERR_OK) {
+    struct netbuf *buf = pendingBuf;
+    pendingBuf = nullptr;
+    if (buf == nullptr && netconn_recv(conn, &buf) != ERR_OK) {
         return -1;
     }
 
@@ -160,7 +162,34 @@ void LwipUdpSocket::startAsyncReceive() {
 
 void LwipUdpSocket::stopAsyncReceive() { setNonBlocking(false); }
 
+bool LwipUdpSocket::waitForEvents(uint32_t timeoutMs) {
+    if (!isInitialized) {
+        return false;
+    }
+    if (pendingBuf != nullptr) {
+        return true;
+    }
+
+    // netconn 没有单独的就绪通知，在接收邮箱上限时阻塞，
+    // 取到的数据报暂存到 pendingBuf (超时为0表示永久等待，至少等待1ms)
+    netconn_set_nonblocking(conn, 0);
+    netconn_set_recvtimeout(conn, timeoutMs > 0 ? timeoutMs : 1);
+    err_t err = netconn_recv(conn, &pendingBuf);
+    netconn_set_recvtimeout(conn, 0);
+    netconn_set_nonblocking(conn, isNonBlocking ? 1 : 0);
+
+    if (err != ERR_OK) {
+        pendingBuf = nullptr;
+        return false;
+    }
+    return true;
+}
+
 void LwipUdpSocket::close() {
+    if (pendingBuf != nullptr) {
+        netbuf_delete(pendingBuf);
+        pendingBuf = nullptr;
+    }
     if (conn != nullptr) {
         netconn_close(conn);
         netconn_delete(conn);
@@ -181,14 +210,15 @@ void LwipUdpSocket::processEvents() {
         return;
     }
 
-    // 简单的轮询接收
-    uint8_t buffer[1024];
+    // 简单的轮询接收，netbuf 数据直接复制到交给回调的缓冲区
+    receivedData.resize(RECEIVE_BUFFER_SIZE);
     NetworkAddress senderAddr;
-    int bytesReceived = receiveFrom(buffer, sizeof(buffer), senderAddr);
+    int bytesReceived =
+        receiveFrom(receivedData.data(), receivedData.size(), senderAddr);
 
     if (bytesReceived > 0) {
-        std::vector<uint8_t> data(buffer, buffer + bytesReceived);
-        receiveCallback(data, senderAddr);
+        receivedData.resize(static_cast<size_t>(bytesReceived));
+        receiveCallback(receivedData, senderAddr);
     }
 }
 
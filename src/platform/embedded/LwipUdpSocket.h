@@ -37,6 +37,12 @@ class LwipUdpSocket : public IUdpSocket {
     bool isBound;
     NetworkAddress localAddress;
     UdpReceiveCallback receiveCallback;
+    bool isNonBlocking;
+    // waitForEvents 阻塞取到的数据报，由下一次 receiveFrom 交付
+    struct netbuf *pendingBuf;
+    // 轮询接收直接写入的缓冲区，交给回调 (可被换走)
+    static constexpr size_t RECEIVE_BUFFER_SIZE = 1024;
+    ReceiveBuffer receivedData;
 
     // 辅助方法
     ip_addr_t stringToIpAddr(const std::string &ipStr);
@@ -70,6 +76,8 @@ class LwipUdpSocket : public IUdpSocket {
     NetworkAddress getLocalAddress() const override;
     bool isOpen() const override;
     void processEvents() override;
+    // 在 netconn 接收邮箱上限时等待 (需要 LWIP_SO_RCVTIMEO)
+    bool waitForEvents(uint32_t timeoutMs) override;
 };
 
 /**
@@ -121,6 +129,7 @@ class LwipUdpSocket : public IUdpSocket {
     NetworkAddress getLocalAddress() const override { return NetworkAddress(); }
     bool isOpen() const override { return false; }
     void processEvents() override {}
+    bool waitForEvents(uint32_t) override { return false; }
 };
 
 class LwipUdpSocketFactory : public IUdpSocketFactory {
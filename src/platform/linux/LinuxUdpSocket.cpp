@@ -0,0 +1,433 @@
+#include "LinuxUdpSocket.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <limits>
+#include <unistd.h>
+
+namespace Platform {
+namespace Linux {
+
+LinuxUdpSocket::LinuxUdpSocket()
+    : sock(-1), epollFd(-1), isInitialized(false), isBound(false),
+      isNonBlocking(false), isReceiving(false) {
+    memset(&localAddr, 0, sizeof(localAddr));
+    prepareReceiveMessages();
+}
+
+LinuxUdpSocket::~LinuxUdpSocket() { close(); }
+
+void LinuxUdpSocket::prepareReceiveMessages() {
+    for (size_t i = 0; i < RECEIVE_BATCH; ++i) {
+        receiveSlots[i].resize(RECEIVE_SLOT_SIZE);
+        receiveIov[i].iov_base = receiveSlots[i].data();
+        receiveIov[i].iov_len = RECEIVE_SLOT_SIZE;
+        receiveMessages[i] = {};
+        receiveMessages[i].msg_hdr.msg_name = &receiveAddrs[i];
+        receiveMessages[i].msg_hdr.msg_iov = &receiveIov[i];
+        receiveMessages[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+bool LinuxUdpSocket::initialize() {
+    if (isInitialized) {
+        return true;
+    }
+
+    sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        std::cerr << "[ERROR] LinuxUdpSocket: Socket creation failed - "
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        std::cerr << "[ERROR] LinuxUdpSocket: epoll_create1 failed - "
+                  << strerror(errno) << std::endl;
+        ::close(sock);
+        sock = -1;
+        return false;
+    }
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = sock;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, sock, &event) < 0) {
+        std::cerr << "[ERROR] LinuxUdpSocket: epoll_ctl failed - "
+                  << strerror(errno) << std::endl;
+        ::close(epollFd);
+        ::close(sock);
+        epollFd = -1;
+        sock = -1;
+        return false;
+    }
+
+    isInitialized = true;
+
+    // 缓冲区调整失败不影响使用，只给出警告
+    setBufferSizes(DEFAULT_RECEIVE_BUFFER_BYTES, DEFAULT_SEND_BUFFER_BYTES);
+    return true;
+}
+
+bool LinuxUdpSocket::bind(const std::string &address, uint16_t port) {
+    if (!isInitialized) {
+        std::cerr << "[ERROR] LinuxUdpSocket: Socket not initialized"
+                  << std::endl;
+        return false;
+    }
+
+    localAddr.sin_family = AF_INET;
+    localAddr.sin_port = htons(port);
+
+    if (address.empty()) {
+        localAddr.sin_addr.s_addr = INADDR_ANY;
+    } else if (inet_pton(AF_INET, address.c_str(), &localAddr.sin_addr) !=
+               1) {
+        std::cerr << "[ERROR] LinuxUdpSocket: Invalid address: " << address
+                  << std::endl;
+        return false;
+    }
+
+    if (::bind(sock, reinterpret_cast<sockaddr *>(&localAddr),
+               sizeof(localAddr)) < 0) {
+        std::cerr << "[ERROR] LinuxUdpSocket: Bind failed on "
+                  << (address.empty() ? "0.0.0.0" : address) << ":" << port
+                  << " - " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    isBound = true;
+    localAddress = NetworkAddress(address.empty() ? "0.0.0.0" : address, port);
+    return true;
+}
+
+bool LinuxUdpSocket::setBroadcast(bool enable) {
+    if (!isInitialized) {
+        return false;
+    }
+
+    int broadcast = enable ? 1 : 0;
+    if (setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &broadcast,
+                   sizeof(broadcast)) < 0) {
+        std::cerr << "[WARN] LinuxUdpSocket: Failed to set broadcast option"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LinuxUdpSocket::setNonBlocking(bool nonBlocking) {
+    if (!isInitialized) {
+        return false;
+    }
+
+    int flags = fcntl(sock, F_GETFL, 0);
+    if (flags == -1) {
+        return false;
+    }
+
+    if (nonBlocking) {
+        flags |= O_NONBLOCK;
+    } else {
+        flags &= ~O_NONBLOCK;
+    }
+
+    if (fcntl(sock, F_SETFL, flags) == -1) {
+        std::cerr << "[ERROR] LinuxUdpSocket: Failed to set non-blocking mode"
+                  << std::endl;
+        return false;
+    }
+
+    isNonBlocking = nonBlocking;
+    return true;
+}
+
+bool LinuxUdpSocket::setBufferSizes(int receiveBytes, int sendBytes) {
+    if (!isInitialized) {
+        return false;
+    }
+
+    bool success = true;
+    if (receiveBytes > 0 &&
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &receiveBytes,
+                   sizeof(receiveBytes)) < 0) {
+        std::cerr << "[WARN] LinuxUdpSocket: Failed to set SO_RCVBUF to "
+                  << receiveBytes << std::endl;
+        success = false;
+    }
+    if (sendBytes > 0 && setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &sendBytes,
+                                    sizeof(sendBytes)) < 0) {
+        std::cerr << "[WARN] LinuxUdpSocket: Failed to set SO_SNDBUF to "
+                  << sendBytes << std::endl;
+        success = false;
+    }
+    return success;
+}
+
+sockaddr_in LinuxUdpSocket::createSockAddr(const NetworkAddress &addr) const {
+    sockaddr_in sockAddr;
+    memset(&sockAddr, 0, sizeof(sockAddr));
+    sockAddr.sin_family = AF_INET;
+    sockAddr.sin_port = htons(addr.port);
+    inet_pton(AF_INET, addr.ip.c_str(), &sockAddr.sin_addr);
+    return sockAddr;
+}
+
+NetworkAddress
+LinuxUdpSocket::createNetworkAddress(const sockaddr_in &addr) const {
+    char ipStr[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr.sin_addr, ipStr, INET_ADDRSTRLEN);
+    return NetworkAddress(std::string(ipStr), ntohs(addr.sin_port));
+}
+
+bool LinuxUdpSocket::sendTo(const std::vector<uint8_t> &data,
+                            const NetworkAddress &targetAddr,
+                            UdpSendCallback callback) {
+    if (data.empty()) {
+        if (callback) {
+            callback(false, 0);
+        }
+        return false;
+    }
+
+    ConstBuffer buffer = {data.data(), data.size()};
+    return sendToGather(&buffer, 1, targetAddr, std::move(callback));
+}
+
+bool LinuxUdpSocket::broadcast(const std::vector<uint8_t> &data,
+                               uint16_t port, UdpSendCallback callback) {
+    // 使用本地广播地址
+    NetworkAddress broadcastAddr("127.255.255.255", port);
+    return sendTo(data, broadcastAddr, callback);
+}
+
+bool LinuxUdpSocket::sendToGather(const ConstBuffer *buffers, size_t count,
+                                  const NetworkAddress &targetAddr,
+                                  UdpSendCallback callback) {
+    if (!isInitialized || !buffers || count == 0 || count > MAX_GATHER) {
+        if (callback) {
+            callback(false, 0);
+        }
+        return false;
+    }
+
+    sockaddr_in targetSockAddr = createSockAddr(targetAddr);
+    iovec iov[MAX_GATHER];
+    for (size_t i = 0; i < count; ++i) {
+        iov[i].iov_base = const_cast<uint8_t *>(buffers[i].data);
+        iov[i].iov_len = buffers[i].size;
+    }
+    msghdr msg = {};
+    msg.msg_name = &targetSockAddr;
+    msg.msg_namelen = sizeof(targetSockAddr);
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+
+    ssize_t bytesSent = sendmsg(sock, &msg, MSG_NOSIGNAL);
+    bool success = (bytesSent >= 0);
+
+    if (callback) {
+        callback(success, success ? static_cast<size_t>(bytesSent) : 0);
+    }
+
+    return success;
+}
+
+bool LinuxUdpSocket::broadcastGather(const ConstBuffer *buffers, size_t count,
+                                     uint16_t port, UdpSendCallback callback) {
+    // 使用本地广播地址
+    NetworkAddress broadcastAddr("127.255.255.255", port);
+    return sendToGather(buffers, count, broadcastAddr, callback);
+}
+
+bool LinuxUdpSocket::sendToBatch(const ConstBuffer *datagrams, size_t count,
+                                 const NetworkAddress &targetAddr,
+                                 UdpSendCallback callback) {
+    if (!isInitialized || !datagrams) {
+        if (callback) {
+            callback(false, 0);
+        }
+        return false;
+    }
+
+    sockaddr_in targetSockAddr = createSockAddr(targetAddr);
+    iovec iov[MAX_BATCH];
+    mmsghdr messages[MAX_BATCH];
+
+    size_t sent = 0;
+    while (sent < count) {
+        size_t chunk = std::min(count - sent, MAX_BATCH);
+        for (size_t i = 0; i < chunk; ++i) {
+            iov[i].iov_base = const_cast<uint8_t *>(datagrams[sent + i].data);
+            iov[i].iov_len = datagrams[sent + i].size;
+            messages[i] = {};
+            messages[i].msg_hdr.msg_name = &targetSockAddr;
+            messages[i].msg_hdr.msg_namelen = sizeof(targetSockAddr);
+            messages[i].msg_hdr.msg_iov = &iov[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int result = sendmmsg(sock, messages, static_cast<unsigned>(chunk),
+                              MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            // 剩余数据报全部视为发送失败
+            for (size_t i = sent; i < count && callback; ++i) {
+                callback(false, 0);
+            }
+            return false;
+        }
+
+        for (int i = 0; i < result && callback; ++i) {
+            callback(true, messages[i].msg_len);
+        }
+        sent += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+bool LinuxUdpSocket::broadcastBatch(const ConstBuffer *datagrams, size_t count,
+                                    uint16_t port, UdpSendCallback callback) {
+    // 使用本地广播地址
+    NetworkAddress broadcastAddr("127.255.255.255", port);
+    return sendToBatch(datagrams, count, broadcastAddr, callback);
+}
+
+int LinuxUdpSocket::receiveFrom(uint8_t *buffer, size_t bufferSize,
+                                NetworkAddress &senderAddr) {
+    if (!isInitialized || !buffer || bufferSize == 0) {
+        return -1;
+    }
+
+    sockaddr_in senderSockAddr;
+    socklen_t senderAddrLen = sizeof(senderSockAddr);
+
+    ssize_t bytesReceived =
+        recvfrom(sock, buffer, bufferSize, 0,
+                 reinterpret_cast<sockaddr *>(&senderSockAddr), &senderAddrLen);
+
+    if (bytesReceived < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            std::cerr << "[ERROR] LinuxUdpSocket: Receive failed - "
+                      << strerror(errno) << std::endl;
+        }
+        return -1;
+    }
+
+    senderAddr = createNetworkAddress(senderSockAddr);
+    return static_cast<int>(bytesReceived);
+}
+
+void LinuxUdpSocket::setReceiveCallback(UdpReceiveCallback callback) {
+    receiveCallback = callback;
+}
+
+void LinuxUdpSocket::startAsyncReceive() {
+    // 可读事件由 epoll 报告，processEvents 中批量接收
+    setNonBlocking(true);
+    isReceiving = true;
+}
+
+void LinuxUdpSocket::stopAsyncReceive() {
+    isReceiving = false;
+    setNonBlocking(false);
+}
+
+void LinuxUdpSocket::processEvents() {
+    if (!isInitialized || !isReceiving || !receiveCallback) {
+        return;
+    }
+
+    // 空队列时 recvmmsg 立即返回 EAGAIN，代价与一次 epoll_wait 相同
+    drainReceiveQueue();
+}
+
+bool LinuxUdpSocket::waitForEvents(uint32_t timeoutMs) {
+    if (!isInitialized) {
+        return false;
+    }
+
+    epoll_event event;
+    int timeout = static_cast<int>(
+        std::min<uint32_t>(timeoutMs, std::numeric_limits<int>::max()));
+    int ready = epoll_wait(epollFd, &event, 1, timeout);
+    if (ready < 0 && errno != EINTR) {
+        std::cerr << "[ERROR] LinuxUdpSocket: epoll_wait failed - "
+                  << strerror(errno) << std::endl;
+    }
+    return ready > 0;
+}
+
+size_t LinuxUdpSocket::drainReceiveQueue() {
+    size_t delivered = 0;
+    for (size_t round = 0; round < MAX_RECEIVE_ROUNDS; ++round) {
+        for (size_t i = 0; i < RECEIVE_BATCH; ++i) {
+            // 上一轮的槽位缩短为数据报长度或已被回调换走，恢复长度 (不清零)
+            receiveSlots[i].resize(RECEIVE_SLOT_SIZE);
+            receiveIov[i].iov_base = receiveSlots[i].data();
+            receiveMessages[i].msg_hdr.msg_namelen = sizeof(receiveAddrs[i]);
+            receiveMessages[i].msg_hdr.msg_flags = 0;
+        }
+
+        int received = recvmmsg(sock, receiveMessages, RECEIVE_BATCH,
+                                MSG_DONTWAIT, nullptr);
+        if (received <= 0) {
+            if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+                errno != EINTR) {
+                std::cerr << "[ERROR] LinuxUdpSocket: recvmmsg failed - "
+                          << strerror(errno) << std::endl;
+            }
+            break;
+        }
+
+        for (int i = 0; i < received; ++i) {
+            const mmsghdr &message = receiveMessages[i];
+            if (message.msg_hdr.msg_flags & MSG_TRUNC) {
+                std::cerr << "[WARN] LinuxUdpSocket: Dropped datagram larger "
+                             "than "
+                          << RECEIVE_SLOT_SIZE << " bytes" << std::endl;
+                continue;
+            }
+
+            // 内核直接写入槽位，缩短到数据报长度后交给回调
+            receiveSlots[i].resize(message.msg_len);
+            receiveCallback(receiveSlots[i],
+                            createNetworkAddress(receiveAddrs[i]));
+            ++delivered;
+        }
+
+        // 未填满一批说明接收队列已空
+        if (static_cast<size_t>(received) < RECEIVE_BATCH) {
+            break;
+        }
+    }
+    return delivered;
+}
+
+void LinuxUdpSocket::close() {
+    if (epollFd >= 0) {
+        ::close(epollFd);
+        epollFd = -1;
+    }
+    if (sock >= 0) {
+        ::close(sock);
+        sock = -1;
+    }
+    isInitialized = false;
+    isBound = false;
+    isNonBlocking = false;
+    isReceiving = false;
+}
+
+NetworkAddress LinuxUdpSocket::getLocalAddress() const { return localAddress; }
+
+bool LinuxUdpSocket::isOpen() const { return isInitialized && sock >= 0; }
+
+} // namespace Linux
+} // namespace Platform
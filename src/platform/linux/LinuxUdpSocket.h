@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../../interface/IUdpSocket.h"
+
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
+
+using namespace Interface;
+
+namespace Platform {
+namespace Linux {
+
+/**
+ * Linux平台UDP套接字实现
+ * 基于 epoll 等待可读事件，使用 recvmmsg / sendmmsg 批量收发：
+ * 一次 processEvents 中每个系统调用最多接收 RECEIVE_BATCH 个数据报，
+ * 数据报由内核写入预先分配的接收槽后直接交给回调，稳态下不分配内存、
+ * 不拷贝。
+ */
+class LinuxUdpSocket : public IUdpSocket {
+  private:
+    static constexpr size_t MAX_GATHER = 16;     // 单个数据报的最大片段数
+    static constexpr size_t MAX_BATCH = 32;      // 单次 sendmmsg 的数据报数
+    static constexpr size_t RECEIVE_BATCH = 32;  // 单次 recvmmsg 的数据报数
+    static constexpr size_t RECEIVE_SLOT_SIZE = 4096; // 每个接收槽的大小
+    // 每次 processEvents 最多调用 recvmmsg 的次数，避免接收占满主循环
+    static constexpr size_t MAX_RECEIVE_ROUNDS = 4;
+    // 默认内核缓冲区大小，突发的批量数据不会因缓冲区满而丢弃
+    static constexpr int DEFAULT_RECEIVE_BUFFER_BYTES = 1 << 20;
+    static constexpr int DEFAULT_SEND_BUFFER_BYTES = 1 << 20;
+
+    int sock;
+    int epollFd;
+    sockaddr_in localAddr;
+    bool isInitialized;
+    bool isBound;
+    bool isNonBlocking;
+    bool isReceiving;
+    UdpReceiveCallback receiveCallback;
+    NetworkAddress localAddress;
+
+    // 预分配的接收槽与 recvmmsg 描述符
+    // 内核直接写入接收槽，槽位本身交给回调，回调可以交换取走
+    ReceiveBuffer receiveSlots[RECEIVE_BATCH];
+    iovec receiveIov[RECEIVE_BATCH];
+    sockaddr_in receiveAddrs[RECEIVE_BATCH];
+    mmsghdr receiveMessages[RECEIVE_BATCH];
+
+    // 辅助方法
+    sockaddr_in createSockAddr(const NetworkAddress &addr) const;
+    NetworkAddress createNetworkAddress(const sockaddr_in &addr) const;
+    void prepareReceiveMessages();
+
+    // 批量接收直到套接字为空或达到轮数上限，返回分发的数据报数
+    size_t drainReceiveQueue();
+
+  public:
+    LinuxUdpSocket();
+    ~LinuxUdpSocket() override;
+
+    // IUdpSocket接口实现
+    bool initialize() override;
+    bool bind(const std::string &address, uint16_t port) override;
+    bool setBroadcast(bool enable) override;
+    bool setNonBlocking(bool nonBlocking) override;
+
+    /**
+     * 设置内核收发缓冲区大小 (SO_RCVBUF / SO_SNDBUF)
+     * 初始化时已设置为默认值；内核实际分配的大小可能受 rmem_max 限制
+     * @param receiveBytes 接收缓冲区字节数，0表示不修改
+     * @param sendBytes 发送缓冲区字节数，0表示不修改
+     * @return 是否全部设置成功
+     */
+    bool setBufferSizes(int receiveBytes, int sendBytes);
+
+    bool sendTo(const std::vector<uint8_t> &data,
+                const NetworkAddress &targetAddr,
+                UdpSendCallback callback = nullptr) override;
+
+    bool broadcast(const std::vector<uint8_t> &data, uint16_t port,
+                   UdpSendCallback callback = nullptr) override;
+
+    // 分散-聚集发送 (sendmsg)，不拼接片段
+    bool sendToGather(const ConstBuffer *buffers, size_t count,
+                      const NetworkAddress &targetAddr,
+                      UdpSendCallback callback = nullptr) override;
+
+    bool broadcastGather(const ConstBuffer *buffers, size_t count,
+                         uint16_t port,
+                         UdpSendCallback callback = nullptr) override;
+
+    // 批量发送 (sendmmsg)
+    bool sendToBatch(const ConstBuffer *datagrams, size_t count,
+                     const NetworkAddress &targetAddr,
+                     UdpSendCallback callback = nullptr) override;
+
+    bool broadcastBatch(const ConstBuffer *datagrams, size_t count,
+                        uint16_t port,
+                        UdpSendCallback callback = nullptr) override;
+
+    int receiveFrom(uint8_t *buffer, size_t bufferSize,
+                    NetworkAddress &senderAddr) override;
+
+    void setReceiveCallback(UdpReceiveCallback callback) override;
+    void startAsyncReceive() override;
+    void stopAsyncReceive() override;
+    void close() override;
+
+    NetworkAddress getLocalAddress() const override;
+    bool isOpen() const override;
+    void processEvents() override;
+    // 使用 epoll_wait 等待可读
+    bool waitForEvents(uint32_t timeoutMs) override;
+};
+
+/**
+ * Linux UDP套接字工厂
+ */
+class LinuxUdpSocketFactory : public IUdpSocketFactory {
+  public:
+    std::unique_ptr<IUdpSocket> createUdpSocket() override {
+        return std::make_unique<LinuxUdpSocket>();
+    }
+};
+
+} // namespace Linux
+} // namespace Platform
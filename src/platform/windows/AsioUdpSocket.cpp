@@ -2,14 +2,26 @@
 #include <chrono>
 #include <iostream>
 
-namespace HAL {
-namespace Network {
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#endif
+
+#ifndef _WIN32
+#include <sys/select.h>
+#endif
+
+namespace Platform {
+namespace Windows {
 
 #ifdef USE_ASIO
 
 AsioUdpSocket::AsioUdpSocket()
     : socket(ioContext), isRunning(false), isInitialized(false), isBound(false),
-      isSending(false) {}
+      receiveQueue(RECEIVE_QUEUE_CAPACITY), receivePaused(false),
+      sendScheduled(false), sendBatchOffset(0) {
+    sendBatch.reserve(MAX_SEND_BATCH);
+}
 
 AsioUdpSocket::~AsioUdpSocket() { close(); }
 
@@ -110,9 +122,87 @@ NetworkAddress AsioUdpSocket::createNetworkAddress(
     return NetworkAddress(endpoint.address().to_string(), endpoint.port());
 }
 
+AsioUdpSocket::SendQueue::SendQueue() : head(&stub), tail(&stub) {}
+
+AsioUdpSocket::SendQueue::~SendQueue() {
+    while (SendRequest *request = pop()) {
+        delete request;
+    }
+}
+
+void AsioUdpSocket::SendQueue::push(SendRequest *request) {
+    request->next.store(nullptr, std::memory_order_relaxed);
+    SendRequest *previous = head.exchange(request, std::memory_order_acq_rel);
+    previous->next.store(request, std::memory_order_release);
+}
+
+AsioUdpSocket::SendRequest *AsioUdpSocket::SendQueue::pop() {
+    SendRequest *first = tail;
+    SendRequest *next = first->next.load(std::memory_order_acquire);
+    if (first == &stub) {
+        if (!next) {
+            return nullptr;
+        }
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        tail = next;
+        return first;
+    }
+
+    // first 是最后一个请求: 入队方已交换 head 但尚未链接时稍后再取
+    if (first != head.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    // 放回占位节点后 first 才能安全出队
+    push(&stub);
+    next = first->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return first;
+    }
+    return nullptr;
+}
+
 bool AsioUdpSocket::sendTo(const std::vector<uint8_t> &data,
                            const NetworkAddress &targetAddr,
                            UdpSendCallback callback) {
+    return enqueueSend(std::vector<uint8_t>(data), targetAddr, callback);
+}
+
+bool AsioUdpSocket::sendToOwned(std::vector<uint8_t> &&data,
+                                const NetworkAddress &targetAddr,
+                                UdpSendCallback callback) {
+    return enqueueSend(std::move(data), targetAddr, callback);
+}
+
+bool AsioUdpSocket::broadcast(const std::vector<uint8_t> &data, uint16_t port,
+                              UdpSendCallback callback) {
+    // 使用广播地址
+    NetworkAddress broadcastAddr("255.255.255.255", port);
+    return sendTo(data, broadcastAddr, callback);
+}
+
+bool AsioUdpSocket::sendToGather(const ConstBuffer *buffers, size_t count,
+                                 const NetworkAddress &targetAddr,
+                                 UdpSendCallback callback) {
+    // 片段只在调用期间有效，拼接一次后移入发送队列
+    return enqueueSend(concatBuffers(buffers, count), targetAddr, callback);
+}
+
+bool AsioUdpSocket::broadcastGather(const ConstBuffer *buffers, size_t count,
+                                    uint16_t port, UdpSendCallback callback) {
+    NetworkAddress broadcastAddr("255.255.255.255", port);
+    return enqueueSend(concatBuffers(buffers, count), broadcastAddr, callback);
+}
+
+bool AsioUdpSocket::enqueueSend(std::vector<uint8_t> &&data,
+                                const NetworkAddress &targetAddr,
+                                UdpSendCallback &callback) {
     if (!isInitialized.load() || data.empty()) {
         if (callback) {
             callback(false, 0);
@@ -129,63 +219,126 @@ bool AsioUdpSocket::sendTo(const std::vector<uint8_t> &data,
     }
 
     // 添加到发送队列
-    {
-        std::lock_guard<std::mutex> lock(sendQueueMutex);
-        sendQueue.emplace(data, endpoint, callback);
+    SendRequest *request = new SendRequest();
+    request->data = std::move(data);
+    request->endpoint = endpoint;
+    request->callback = std::move(callback);
+    sendQueue.push(request);
+
+    // 只在IO线程没有待处理的发送任务时投递，突发的请求由同一次唤醒处理
+    if (!sendScheduled.exchange(true)) {
+        asio::post(ioContext, [this]() { drainSendQueue(); });
     }
 
-    // 触发发送处理
-    asio::post(ioContext, [this]() { processSendQueue(); });
-
     return true;
 }
 
-bool AsioUdpSocket::broadcast(const std::vector<uint8_t> &data, uint16_t port,
-                              UdpSendCallback callback) {
-    // 使用广播地址
-    NetworkAddress broadcastAddr("255.255.255.255", port);
-    return sendTo(data, broadcastAddr, callback);
-}
-
-void AsioUdpSocket::processSendQueue() {
-    if (isSending.load()) {
-        return; // 已经在发送中
-    }
+void AsioUdpSocket::drainSendQueue() {
+    for (size_t round = 0; round < MAX_SEND_ROUNDS; ++round) {
+        if (sendBatch.empty() && fillSendBatch() == 0) {
+            // 清除标记后再检查一次: 标记清除前入队的请求在这里取到，
+            // 之后入队的请求会重新投递发送任务
+            sendScheduled.store(false);
+            if (fillSendBatch() == 0) {
+                return;
+            }
+            sendScheduled.store(true);
+        }
 
-    std::lock_guard<std::mutex> lock(sendQueueMutex);
-    if (sendQueue.empty()) {
-        return;
+        if (!transmitSendBatch()) {
+            // 套接字缓冲区已满，可写时继续发送
+            socket.async_wait(
+                asio::ip::udp::socket::wait_write,
+                [this](const asio::error_code &error) {
+                    if (error != asio::error::operation_aborted) {
+                        drainSendQueue();
+                    }
+                });
+            return;
+        }
     }
 
-    isSending.store(true);
-    SendRequest request = std::move(sendQueue.front());
-    sendQueue.pop();
+    // 本次唤醒的批次已达上限，先让IO线程处理接收
+    asio::post(ioContext, [this]() { drainSendQueue(); });
+}
 
-    // 异步发送
-    socket.async_send_to(asio::buffer(request.data), request.endpoint,
-                         [this, callback = request.callback](
-                             const asio::error_code &error, size_t bytesSent) {
-                             handleSend(error, bytesSent, callback);
-                         });
+size_t AsioUdpSocket::fillSendBatch() {
+    while (sendBatch.size() < MAX_SEND_BATCH) {
+        SendRequest *request = sendQueue.pop();
+        if (!request) {
+            break;
+        }
+        sendBatch.emplace_back(request);
+    }
+    return sendBatch.size();
 }
 
-void AsioUdpSocket::handleSend(const asio::error_code &error, size_t bytesSent,
-                               UdpSendCallback callback) {
-    bool success = !error;
+bool AsioUdpSocket::transmitSendBatch() {
+    while (sendBatchOffset < sendBatch.size()) {
+#ifdef __linux__
+        // 一次 sendmmsg 发送批次中剩余的全部数据报
+        size_t count = sendBatch.size() - sendBatchOffset;
+        for (size_t i = 0; i < count; ++i) {
+            SendRequest &request = *sendBatch[sendBatchOffset + i];
+            sendIov[i].iov_base = request.data.data();
+            sendIov[i].iov_len = request.data.size();
+
+            msghdr &header = sendMessages[i].msg_hdr;
+            header = msghdr();
+            header.msg_name = request.endpoint.data();
+            header.msg_namelen =
+                static_cast<socklen_t>(request.endpoint.size());
+            header.msg_iov = &sendIov[i];
+            header.msg_iovlen = 1;
+            sendMessages[i].msg_len = 0;
+        }
 
-    if (callback) {
-        callback(success, success ? bytesSent : 0);
-    }
+        int sent = ::sendmmsg(socket.native_handle(), sendMessages,
+                              static_cast<unsigned int>(count), MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return false;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            // 第一个数据报发送失败，报告后继续发送其余数据报
+            std::cerr << "[ERROR] AsioUdpSocket: Send failed: "
+                      << std::strerror(errno) << std::endl;
+            finishSend(false, 0);
+            continue;
+        }
 
-    if (error) {
-        std::cerr << "[ERROR] AsioUdpSocket: Send failed: " << error.message()
-                  << std::endl;
+        for (int i = 0; i < sent; ++i) {
+            finishSend(true, sendMessages[i].msg_len);
+        }
+#else
+        SendRequest &request = *sendBatch[sendBatchOffset];
+        asio::error_code error;
+        size_t bytesSent = socket.send_to(asio::buffer(request.data),
+                                          request.endpoint, 0, error);
+        if (error == asio::error::would_block) {
+            return false;
+        }
+        if (error) {
+            std::cerr << "[ERROR] AsioUdpSocket: Send failed: "
+                      << error.message() << std::endl;
+        }
+        finishSend(!error, bytesSent);
+#endif
     }
 
-    isSending.store(false);
+    sendBatch.clear();
+    sendBatchOffset = 0;
+    return true;
+}
 
-    // 继续处理队列中的下一个发送请求
-    asio::post(ioContext, [this]() { processSendQueue(); });
+void AsioUdpSocket::finishSend(bool success, size_t bytesSent) {
+    std::unique_ptr<SendRequest> request =
+        std::move(sendBatch[sendBatchOffset++]);
+    if (request->callback) {
+        request->callback(success, success ? bytesSent : 0);
+    }
 }
 
 int AsioUdpSocket::receiveFrom(uint8_t *buffer, size_t bufferSize,
@@ -231,13 +384,15 @@ void AsioUdpSocket::startAsyncReceive() {
 
     if (!isRunning.load()) {
         isRunning.store(true);
+        receivePaused.store(false);
+
+        // 先投递异步接收再启动IO线程，否则 run() 可能因没有待处理的操作
+        // 而立即返回，之后投递的接收与发送都不会执行
+        startReceive();
 
         // 启动IO线程
         ioThread = std::thread([this]() { runIoContext(); });
 
-        // 开始异步接收
-        startReceive();
-
         std::cout << "[INFO] AsioUdpSocket: Started async receive" << std::endl;
     }
 }
@@ -263,8 +418,11 @@ void AsioUdpSocket::startReceive() {
         return;
     }
 
+    // 缓冲区是上一个数据报或从队列换回的旧缓冲区，恢复长度 (不清零)
+    ReceiveBuffer &buffer = receiving.data;
+    buffer.resize(RECEIVE_BUFFER_SIZE);
     socket.async_receive_from(
-        asio::buffer(receiveBuffer), senderEndpoint,
+        asio::buffer(buffer.data(), buffer.size()), receiving.sender,
         [this](const asio::error_code &error, size_t bytesReceived) {
             handleReceive(error, bytesReceived);
         });
@@ -273,11 +431,11 @@ void AsioUdpSocket::startReceive() {
 void AsioUdpSocket::handleReceive(const asio::error_code &error,
                                   size_t bytesReceived) {
     if (!error && bytesReceived > 0) {
-        if (receiveCallback) {
-            std::vector<uint8_t> data(receiveBuffer.begin(),
-                                      receiveBuffer.begin() + bytesReceived);
-            NetworkAddress senderAddr = createNetworkAddress(senderEndpoint);
-            receiveCallback(data, senderAddr);
+        receiving.data.resize(bytesReceived);
+        if (!publishReceived()) {
+            // 分发跟不上: 保留此数据报并暂停接收，由 processEvents 恢复
+            receivePaused.store(true);
+            return;
         }
     } else if (error && error != asio::error::operation_aborted) {
         std::cerr << "[ERROR] AsioUdpSocket: Receive error: " << error.message()
@@ -290,11 +448,33 @@ void AsioUdpSocket::handleReceive(const asio::error_code &error,
     }
 }
 
+bool AsioUdpSocket::publishReceived() {
+    // 入队后 receiving 换回一个已分发的旧缓冲区
+    if (!receiveQueue.tryPush(receiving)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(eventMutex);
+    eventCondition.notify_one();
+    return true;
+}
+
+void AsioUdpSocket::resumeReceive() {
+    if (!publishReceived()) {
+        receivePaused.store(true);
+        return;
+    }
+    startReceive();
+}
+
 void AsioUdpSocket::runIoContext() {
     try {
         // 重新启动IO上下文
         ioContext.restart();
 
+        // 接收暂停时没有待处理的操作，保持 run() 直到 stop()
+        auto work = asio::make_work_guard(ioContext);
+
         // 运行IO上下文
         ioContext.run();
 
@@ -306,13 +486,56 @@ void AsioUdpSocket::runIoContext() {
 }
 
 void AsioUdpSocket::processEvents() {
-    // ASIO使用自己的事件循环，这里可以处理一些轻量级任务
+    // 每次最多分发一个队列容量的数据报，持续的接收不会占满调用线程
+    for (size_t i = 0; i < RECEIVE_QUEUE_CAPACITY; ++i) {
+        if (!receiveQueue.tryPop(dispatching)) {
+            break;
+        }
+
+        // 队列已有空位，让暂停的IO线程继续接收
+        if (receivePaused.exchange(false)) {
+            asio::post(ioContext, [this]() { resumeReceive(); });
+        }
+
+        if (receiveCallback) {
+            NetworkAddress senderAddr =
+                createNetworkAddress(dispatching.sender);
+            receiveCallback(dispatching.data, senderAddr);
+        }
+    }
+
     if (ioContext.stopped() && isRunning.load()) {
         // 如果IO上下文停止了但应该运行，重新启动
         ioContext.restart();
     }
 }
 
+bool AsioUdpSocket::waitForEvents(uint32_t timeoutMs) {
+    if (!isRunning.load()) {
+        // 未启动异步接收时调用方以 receiveFrom 轮询，直接等待套接字可读
+        if (!isInitialized.load()) {
+            return false;
+        }
+
+        auto handle = socket.native_handle();
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(handle, &readSet);
+        timeval timeout;
+        timeout.tv_sec = static_cast<long>(timeoutMs / 1000);
+        timeout.tv_usec = static_cast<long>((timeoutMs % 1000) * 1000);
+
+        // Windows 忽略第一个参数
+        int ready = select(static_cast<int>(handle) + 1, &readSet, nullptr,
+                           nullptr, &timeout);
+        return ready > 0;
+    }
+
+    std::unique_lock<std::mutex> lock(eventMutex);
+    return eventCondition.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                                   [this]() { return !receiveQueue.empty(); });
+}
+
 void AsioUdpSocket::close() {
     stopAsyncReceive();
 
@@ -328,13 +551,15 @@ void AsioUdpSocket::close() {
     isInitialized.store(false);
     isBound.store(false);
 
-    // 清空发送队列
-    {
-        std::lock_guard<std::mutex> lock(sendQueueMutex);
-        while (!sendQueue.empty()) {
-            sendQueue.pop();
-        }
+    // 清空发送队列与未分发的数据报 (IO线程已停止，可以在此出队)
+    while (SendRequest *request = sendQueue.pop()) {
+        delete request;
+    }
+    while (receiveQueue.tryPop(dispatching)) {
     }
+    sendBatch.clear();
+    sendBatchOffset = 0;
+    sendScheduled.store(false);
 
     std::cout << "[INFO] AsioUdpSocket: Socket closed" << std::endl;
 }
@@ -360,5 +585,5 @@ bool AsioUdpSocket::isOpen() const {
 
 #endif // USE_ASIO
 
-} // namespace Network
-} // namespace HAL
\ No newline at end of file
+} // namespace Windows
+} // namespace Platform
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../interface/IUdpSocket.h"
+#include "../../protocol/utils/SpscQueue.h"
 
 // ASIO相关头文件
 #ifdef USE_ASIO
@@ -9,10 +10,17 @@
 #include <asio/system_timer.hpp>
 #endif
 
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
 #include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <vector>
 
 using namespace Interface;
 
@@ -24,6 +32,10 @@ namespace Windows {
 /**
  * 基于ASIO的UDP套接字实现
  * 提供高性能的异步网络I/O
+ * 发送请求经无锁队列交给IO线程，IO线程每次唤醒批量发送队列中的请求
+ * (Linux 上使用 sendmmsg)，发送完成回调在IO线程中执行。
+ * IO线程接收的数据报经单生产者单消费者队列交给调用 processEvents 的线程，
+ * 接收回调只在该线程中执行，上层状态无需与IO线程同步。
  */
 class AsioUdpSocket : public IUdpSocket {
   private:
@@ -38,26 +50,67 @@ class AsioUdpSocket : public IUdpSocket {
 
     UdpReceiveCallback receiveCallback;
 
-    // 接收缓冲区
-    static constexpr size_t RECEIVE_BUFFER_SIZE = 65536;
-    std::array<uint8_t, RECEIVE_BUFFER_SIZE> receiveBuffer;
-    asio::ip::udp::endpoint senderEndpoint;
+    // 接收的数据报: 内核直接写入缓冲区，入队与出队都交换缓冲区，不拷贝
+    struct ReceivedDatagram {
+        ReceiveBuffer data;
+        asio::ip::udp::endpoint sender;
+    };
+
+    // 与其他实现的接收缓冲区一致 (协议帧长远小于此值)；队列中每个槽位
+    // 都持有一个接收缓冲区，过大的缓冲区会成倍占用内存
+    static constexpr size_t RECEIVE_BUFFER_SIZE = 4096;
+    // 等待分发的数据报上限；队列满时暂停接收，数据报留在内核缓冲区
+    static constexpr size_t RECEIVE_QUEUE_CAPACITY = 64;
+
+    WhtsProtocol::SpscQueue<ReceivedDatagram> receiveQueue;
+    ReceivedDatagram receiving;   // 正在接收 (只由IO线程访问)
+    ReceivedDatagram dispatching; // 正在分发 (只由 processEvents 访问)
+    std::atomic<bool> receivePaused; // 队列满而暂停，等待 processEvents 恢复
+
+    static constexpr size_t MAX_SEND_BATCH = 32; // 单次批量发送的数据报数
+    // 每次唤醒最多发送的批次数，之后让出IO线程处理接收
+    static constexpr size_t MAX_SEND_ROUNDS = 8;
 
-    // 发送队列（用于批量发送优化）
+    // 发送请求: 缓冲区由调用方移交，回调可为空
     struct SendRequest {
         std::vector<uint8_t> data;
         asio::ip::udp::endpoint endpoint;
         UdpSendCallback callback;
+        std::atomic<SendRequest *> next{nullptr};
+    };
 
-        SendRequest(const std::vector<uint8_t> &d,
-                    const asio::ip::udp::endpoint &ep,
-                    UdpSendCallback cb = nullptr)
-            : data(d), endpoint(ep), callback(cb) {}
+    // 无锁多生产者单消费者队列 (侵入式链表)
+    // 任意线程入队只需一次原子交换，只由IO线程出队
+    class SendQueue {
+      public:
+        SendQueue();
+        ~SendQueue();
+        SendQueue(const SendQueue &) = delete;
+        SendQueue &operator=(const SendQueue &) = delete;
+
+        void push(SendRequest *request);
+        // 队列为空或入队尚未完成时返回nullptr
+        SendRequest *pop();
+
+      private:
+        std::atomic<SendRequest *> head; // 最近入队的请求
+        SendRequest *tail;               // 下一个出队的请求
+        SendRequest stub;
     };
 
-    std::queue<SendRequest> sendQueue;
-    std::mutex sendQueueMutex;
-    std::atomic<bool> isSending;
+    SendQueue sendQueue;
+    std::atomic<bool> sendScheduled; // 已向IO线程投递发送任务
+    // 当前批次 (只由IO线程访问)，sendBatchOffset 之前的请求已完成
+    std::vector<std::unique_ptr<SendRequest>> sendBatch;
+    size_t sendBatchOffset;
+#ifdef __linux__
+    mmsghdr sendMessages[MAX_SEND_BATCH];
+    iovec sendIov[MAX_SEND_BATCH];
+#endif
+
+    // 数据报入队后唤醒 waitForEvents
+    std::mutex eventMutex;
+    std::condition_variable eventCondition;
 
     // 辅助方法
     asio::ip::udp::endpoint createEndpoint(const NetworkAddress &addr) const;
@@ -65,9 +118,19 @@ class AsioUdpSocket : public IUdpSocket {
     createNetworkAddress(const asio::ip::udp::endpoint &endpoint) const;
     void startReceive();
     void handleReceive(const asio::error_code &error, size_t bytesReceived);
-    void processSendQueue();
-    void handleSend(const asio::error_code &error, size_t bytesSent,
-                    UdpSendCallback callback);
+    // 将 receiving 中的数据报放入接收队列，队列满时返回false
+    bool publishReceived();
+    // 分发线程腾出队列空间后在IO线程中恢复接收
+    void resumeReceive();
+    bool enqueueSend(std::vector<uint8_t> &&data,
+                     const NetworkAddress &targetAddr,
+                     UdpSendCallback &callback);
+    void drainSendQueue();
+    size_t fillSendBatch();
+    // 发送当前批次，套接字缓冲区已满时返回false
+    bool transmitSendBatch();
+    // 完成批次中的下一个请求并调用其回调
+    void finishSend(bool success, size_t bytesSent);
     void runIoContext();
 
   public:
@@ -87,6 +150,19 @@ class AsioUdpSocket : public IUdpSocket {
     bool broadcast(const std::vector<uint8_t> &data, uint16_t port,
                    UdpSendCallback callback = nullptr) override;
 
+    // 缓冲区直接移入发送队列，不拷贝
+    bool sendToOwned(std::vector<uint8_t> &&data,
+                     const NetworkAddress &targetAddr,
+                     UdpSendCallback callback = nullptr) override;
+
+    bool sendToGather(const ConstBuffer *buffers, size_t count,
+                      const NetworkAddress &targetAddr,
+                      UdpSendCallback callback = nullptr) override;
+
+    bool broadcastGather(const ConstBuffer *buffers, size_t count,
+                         uint16_t port,
+                         UdpSendCallback callback = nullptr) override;
+
     int receiveFrom(uint8_t *buffer, size_t bufferSize,
                     NetworkAddress &senderAddr) override;
 
@@ -97,7 +173,11 @@ class AsioUdpSocket : public IUdpSocket {
 
     NetworkAddress getLocalAddress() const override;
     bool isOpen() const override;
+    // 分发IO线程接收的数据报，接收回调在调用线程中执行
     void processEvents() override;
+    // 异步接收运行时等待接收队列中有数据报，由随后的 processEvents 分发；
+    // 未启动异步接收时等待套接字可读，由随后的 receiveFrom 读取
+    bool waitForEvents(uint32_t timeoutMs) override;
 
     // ASIO特定方法
     asio::io_context &getIoContext() { return ioContext; }
@@ -147,6 +227,7 @@ class AsioUdpSocket : public IUdpSocket {
     NetworkAddress getLocalAddress() const override { return NetworkAddress(); }
     bool isOpen() const override { return false; }
     void processEvents() override {}
+    bool waitForEvents(uint32_t) override { return false; }
 };
 
 class AsioUdpSocketFactory : public IUdpSocketFactory {
@@ -1,4 +1,5 @@
 #include "WindowsUdpSocket.h"
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 
@@ -190,6 +191,124 @@ bool WindowsUdpSocket::broadcast(const std::vector<uint8_t> &data,
     return sendTo(data, broadcastAddr, callback);
 }
 
+bool WindowsUdpSocket::sendToGather(const ConstBuffer *buffers, size_t count,
+                                    const NetworkAddress &targetAddr,
+                                    UdpSendCallback callback) {
+    if (!isInitialized || !buffers || count == 0 || count > MAX_GATHER) {
+        if (callback) {
+            callback(false, 0);
+        }
+        return false;
+    }
+
+    sockaddr_in targetSockAddr = createSockAddr(targetAddr);
+    bool success;
+    size_t actualBytesSent = 0;
+
+#ifdef _WIN32
+    WSABUF wsaBuffers[MAX_GATHER];
+    for (size_t i = 0; i < count; ++i) {
+        wsaBuffers[i].buf =
+            reinterpret_cast<CHAR *>(const_cast<uint8_t *>(buffers[i].data));
+        wsaBuffers[i].len = static_cast<ULONG>(buffers[i].size);
+    }
+    DWORD bytesSent = 0;
+    success = WSASendTo(sock, wsaBuffers, static_cast<DWORD>(count),
+                        &bytesSent, 0, (sockaddr *)&targetSockAddr,
+                        sizeof(targetSockAddr), nullptr,
+                        nullptr) != SOCKET_ERROR;
+    if (success) {
+        actualBytesSent = bytesSent;
+    }
+#else
+    iovec iov[MAX_GATHER];
+    for (size_t i = 0; i < count; ++i) {
+        iov[i].iov_base = const_cast<uint8_t *>(buffers[i].data);
+        iov[i].iov_len = buffers[i].size;
+    }
+    msghdr msg = {};
+    msg.msg_name = &targetSockAddr;
+    msg.msg_namelen = sizeof(targetSockAddr);
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    ssize_t bytesSent = sendmsg(sock, &msg, 0);
+    success = (bytesSent >= 0);
+    if (success) {
+        actualBytesSent = static_cast<size_t>(bytesSent);
+    }
+#endif
+
+    if (callback) {
+        callback(success, actualBytesSent);
+    }
+
+    return success;
+}
+
+bool WindowsUdpSocket::broadcastGather(const ConstBuffer *buffers,
+                                       size_t count, uint16_t port,
+                                       UdpSendCallback callback) {
+    // 使用本地广播地址
+    NetworkAddress broadcastAddr("127.255.255.255", port);
+    return sendToGather(buffers, count, broadcastAddr, callback);
+}
+
+bool WindowsUdpSocket::sendToBatch(const ConstBuffer *datagrams, size_t count,
+                                   const NetworkAddress &targetAddr,
+                                   UdpSendCallback callback) {
+#if defined(__linux__)
+    if (!isInitialized || !datagrams) {
+        if (callback) {
+            callback(false, 0);
+        }
+        return false;
+    }
+
+    sockaddr_in targetSockAddr = createSockAddr(targetAddr);
+    iovec iov[MAX_BATCH];
+    mmsghdr messages[MAX_BATCH];
+
+    size_t sent = 0;
+    while (sent < count) {
+        size_t chunk = std::min(count - sent, MAX_BATCH);
+        for (size_t i = 0; i < chunk; ++i) {
+            iov[i].iov_base = const_cast<uint8_t *>(datagrams[sent + i].data);
+            iov[i].iov_len = datagrams[sent + i].size;
+            messages[i] = {};
+            messages[i].msg_hdr.msg_name = &targetSockAddr;
+            messages[i].msg_hdr.msg_namelen = sizeof(targetSockAddr);
+            messages[i].msg_hdr.msg_iov = &iov[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int result = sendmmsg(sock, messages, static_cast<unsigned>(chunk), 0);
+        if (result <= 0) {
+            // 剩余数据报全部视为发送失败
+            for (size_t i = sent; i < count && callback; ++i) {
+                callback(false, 0);
+            }
+            return false;
+        }
+
+        for (int i = 0; i < result && callback; ++i) {
+            callback(true, messages[i].msg_len);
+        }
+        sent += static_cast<size_t>(result);
+    }
+    return true;
+#else
+    return IUdpSocket::sendToBatch(datagrams, count, targetAddr, callback);
+#endif
+}
+
+bool WindowsUdpSocket::broadcastBatch(const ConstBuffer *datagrams,
+                                      size_t count, uint16_t port,
+                                      UdpSendCallback callback) {
+    // 使用本地广播地址
+    NetworkAddress broadcastAddr("127.255.255.255", port);
+    return sendToBatch(datagrams, count, broadcastAddr, callback);
+}
+
 int WindowsUdpSocket::receiveFrom(uint8_t *buffer, size_t bufferSize,
                                   NetworkAddress &senderAddr) {
     if (!isInitialized || !buffer || bufferSize == 0) {
@@ -236,17 +355,36 @@ void WindowsUdpSocket::processEvents() {
         return;
     }
 
-    // 简单的轮询接收
-    uint8_t buffer[4096];
+    // 简单的轮询接收，直接写入交给回调的缓冲区
+    receivedData.resize(RECEIVE_BUFFER_SIZE);
     NetworkAddress senderAddr;
-    int bytesReceived = receiveFrom(buffer, sizeof(buffer), senderAddr);
+    int bytesReceived =
+        receiveFrom(receivedData.data(), receivedData.size(), senderAddr);
 
     if (bytesReceived > 0) {
-        std::vector<uint8_t> data(buffer, buffer + bytesReceived);
-        receiveCallback(data, senderAddr);
+        receivedData.resize(static_cast<size_t>(bytesReceived));
+        receiveCallback(receivedData, senderAddr);
     }
 }
 
+bool WindowsUdpSocket::waitForEvents(uint32_t timeoutMs) {
+    if (!isInitialized) {
+        return false;
+    }
+
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(sock, &readSet);
+    timeval timeout;
+    timeout.tv_sec = static_cast<long>(timeoutMs / 1000);
+    timeout.tv_usec = static_cast<long>((timeoutMs % 1000) * 1000);
+
+    // Windows 忽略第一个参数
+    int ready = select(static_cast<int>(sock) + 1, &readSet, nullptr, nullptr,
+                       &timeout);
+    return ready > 0;
+}
+
 void WindowsUdpSocket::close() {
     if (sock != INVALID_SOCKET) {
         closesocket(sock);
@@ -11,7 +11,9 @@ typedef int socklen_t;
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <netinet/in.h>
+#include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #define SOCKET int
 #define INVALID_SOCKET -1
@@ -30,6 +32,10 @@ namespace Windows {
  */
 class WindowsUdpSocket : public IUdpSocket {
   private:
+    static constexpr size_t MAX_GATHER = 16; // 单个数据报的最大片段数
+    static constexpr size_t MAX_BATCH = 32;  // 单次 sendmmsg 的数据报数
+    static constexpr size_t RECEIVE_BUFFER_SIZE = 4096; // 轮询接收缓冲区
+
     SOCKET sock;
     sockaddr_in localAddr;
     bool isInitialized;
@@ -37,6 +43,8 @@ class WindowsUdpSocket : public IUdpSocket {
     bool isNonBlocking;
     UdpReceiveCallback receiveCallback;
     NetworkAddress localAddress;
+    // 轮询接收直接写入的缓冲区，交给回调 (可被换走)
+    ReceiveBuffer receivedData;
 
     // 辅助方法
     sockaddr_in createSockAddr(const NetworkAddress &addr) const;
@@ -61,6 +69,24 @@ class WindowsUdpSocket : public IUdpSocket {
     bool broadcast(const std::vector<uint8_t> &data, uint16_t port,
                    UdpSendCallback callback = nullptr) override;
 
+    // 分散-聚集发送 (WSASendTo / sendmsg)，不拼接片段
+    bool sendToGather(const ConstBuffer *buffers, size_t count,
+                      const NetworkAddress &targetAddr,
+                      UdpSendCallback callback = nullptr) override;
+
+    bool broadcastGather(const ConstBuffer *buffers, size_t count,
+                         uint16_t port,
+                         UdpSendCallback callback = nullptr) override;
+
+    // 批量发送 (Linux 上使用 sendmmsg)
+    bool sendToBatch(const ConstBuffer *datagrams, size_t count,
+                     const NetworkAddress &targetAddr,
+                     UdpSendCallback callback = nullptr) override;
+
+    bool broadcastBatch(const ConstBuffer *datagrams, size_t count,
+                        uint16_t port,
+                        UdpSendCallback callback = nullptr) override;
+
     int receiveFrom(uint8_t *buffer, size_t bufferSize,
                     NetworkAddress &senderAddr) override;
 
@@ -72,6 +98,8 @@ class WindowsUdpSocket : public IUdpSocket {
     NetworkAddress getLocalAddress() const override;
     bool isOpen() const override;
     void processEvents() override;
+    // 使用 select 等待可读
+    bool waitForEvents(uint32_t timeoutMs) override;
 };
 
 /**
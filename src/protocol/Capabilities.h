@@ -0,0 +1,58 @@
+#ifndef WHTS_PROTOCOL_CAPABILITIES_H
+#define WHTS_PROTOCOL_CAPABILITIES_H
+
+#include "Frame.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace WhtsProtocol {
+
+// 协议能力协商
+// 从机在 Announce 中声明能力位图与最大接收帧长，主机取双方都支持的能力，
+// 在 Short ID Assign 中回复协商结果与主机自身的最大接收帧长。
+// 旧版本固件不携带扩展字段，视为能力为0且使用默认MTU，保持原有格式收发。
+namespace Capability {
+constexpr uint16_t CHECKSUM_CRC16 = 1 << 0;  // 可校验 CRC-16 校验尾
+constexpr uint16_t CHECKSUM_CRC32C = 1 << 1; // 可校验 CRC-32C 校验尾
+constexpr uint16_t DATA_ENCODING = 1 << 2;   // 采集数据压缩编码 (DataCodec)
+
+// 本实现支持的全部能力
+constexpr uint16_t SUPPORTED =
+    CHECKSUM_CRC16 | CHECKSUM_CRC32C | DATA_ENCODING;
+} // namespace Capability
+
+// 协商后的对端档案: 向该对端发送时使用的帧长上限与校验尾类型
+struct PeerProfile {
+    uint16_t capabilities = 0; // 双方都支持的能力
+    size_t mtu = 0;            // 0 表示使用默认MTU
+    ChecksumType checksumType = ChecksumType::NONE;
+
+    constexpr bool supports(uint16_t capability) const {
+        return (capabilities & capability) == capability;
+    }
+};
+
+// 能分片的最小帧长: 帧头 + 分片子头 + 最长校验尾 + 至少1字节数据
+constexpr size_t MIN_NEGOTIATED_MTU =
+    FRAME_HEADER_SIZE + FragmentHeader::SIZE + MAX_CHECKSUM_SIZE + 1;
+
+// 由本端与对端声明的能力生成档案
+// 校验尾优先选择 CRC-32C；对端帧长不可用 (为0或过小) 时使用默认MTU
+constexpr PeerProfile negotiateProfile(uint16_t localCapabilities,
+                                       uint16_t remoteCapabilities,
+                                       uint16_t remoteMaxReceiveMtu) {
+    PeerProfile profile;
+    profile.capabilities =
+        static_cast<uint16_t>(localCapabilities & remoteCapabilities);
+    if (profile.supports(Capability::CHECKSUM_CRC32C))
+        profile.checksumType = ChecksumType::CRC32C;
+    else if (profile.supports(Capability::CHECKSUM_CRC16))
+        profile.checksumType = ChecksumType::CRC16;
+    if (remoteMaxReceiveMtu >= MIN_NEGOTIATED_MTU)
+        profile.mtu = remoteMaxReceiveMtu;
+    return profile;
+}
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_CAPABILITIES_H
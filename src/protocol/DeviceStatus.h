@@ -5,23 +5,70 @@
 
 namespace WhtsProtocol {
 
-// 设备状态位结构
-struct DeviceStatus {
-    bool colorSensor : 1;
-    bool sleeveLimit : 1;
-    bool electromagnetUnlockButton : 1;
-    bool batteryLowAlarm : 1;
-    bool pressureSensor : 1;
-    bool electromagneticLock1 : 1;
-    bool electromagneticLock2 : 1;
-    bool accessory1 : 1;
-    bool accessory2 : 1;
-    uint8_t reserved : 7;
-
-    uint16_t toUint16() const;
-    void fromUint16(uint16_t status);
+// 设备状态字
+// 线上的16位状态字原样保存，收发与转发都是一次16位拷贝；
+// 各标志位通过 constexpr 访问器读写，状态变化可由两个状态字异或得到
+class DeviceStatus {
+  public:
+    // 状态位定义 (bit9-15 保留)
+    enum Bit : uint16_t {
+        COLOR_SENSOR = 1 << 0,
+        SLEEVE_LIMIT = 1 << 1,
+        ELECTROMAGNET_UNLOCK_BUTTON = 1 << 2,
+        BATTERY_LOW_ALARM = 1 << 3,
+        PRESSURE_SENSOR = 1 << 4,
+        ELECTROMAGNETIC_LOCK1 = 1 << 5,
+        ELECTROMAGNETIC_LOCK2 = 1 << 6,
+        ACCESSORY1 = 1 << 7,
+        ACCESSORY2 = 1 << 8,
+    };
+    static constexpr uint16_t DEFINED_BITS = 0x01FF;
+
+    constexpr DeviceStatus() : raw_(0) {}
+    constexpr explicit DeviceStatus(uint16_t raw) : raw_(raw) {}
+
+    constexpr uint16_t raw() const { return raw_; }
+    constexpr bool test(Bit bit) const { return (raw_ & bit) != 0; }
+    constexpr void set(Bit bit, bool value) {
+        raw_ = value ? static_cast<uint16_t>(raw_ | bit)
+                     : static_cast<uint16_t>(raw_ & ~bit);
+    }
+
+    // 与另一状态相比变化的位
+    constexpr uint16_t changedBits(DeviceStatus other) const {
+        return static_cast<uint16_t>(raw_ ^ other.raw_);
+    }
+
+    constexpr bool colorSensor() const { return test(COLOR_SENSOR); }
+    constexpr bool sleeveLimit() const { return test(SLEEVE_LIMIT); }
+    constexpr bool electromagnetUnlockButton() const {
+        return test(ELECTROMAGNET_UNLOCK_BUTTON);
+    }
+    constexpr bool batteryLowAlarm() const { return test(BATTERY_LOW_ALARM); }
+    constexpr bool pressureSensor() const { return test(PRESSURE_SENSOR); }
+    constexpr bool electromagneticLock1() const {
+        return test(ELECTROMAGNETIC_LOCK1);
+    }
+    constexpr bool electromagneticLock2() const {
+        return test(ELECTROMAGNETIC_LOCK2);
+    }
+    constexpr bool accessory1() const { return test(ACCESSORY1); }
+    constexpr bool accessory2() const { return test(ACCESSORY2); }
+
+    constexpr bool operator==(DeviceStatus other) const {
+        return raw_ == other.raw_;
+    }
+    constexpr bool operator!=(DeviceStatus other) const {
+        return raw_ != other.raw_;
+    }
+
+  private:
+    uint16_t raw_;
 };
 
+static_assert(sizeof(DeviceStatus) == sizeof(uint16_t),
+              "DeviceStatus must stay a plain 16-bit word");
+
 } // namespace WhtsProtocol
 
-#endif // WHTS_PROTOCOL_DEVICE_STATUS_H
\ No newline at end of file
+#endif // WHTS_PROTOCOL_DEVICE_STATUS_H
@@ -0,0 +1,204 @@
+#include "FragmentReassembler.h"
+#include "../app/Logger.h"
+#include "utils/FieldCodec.h"
+#include <cstring>
+
+namespace WhtsProtocol {
+
+namespace {
+// 载荷中 Message ID 之后是否紧跟4字节的源/目标ID
+bool hasSourceId(uint8_t packetId) {
+    switch (static_cast<PacketId>(packetId)) {
+    case PacketId::MASTER_TO_SLAVE:
+    case PacketId::SLAVE_TO_MASTER:
+    case PacketId::SLAVE_TO_BACKEND:
+        return true;
+    default:
+        return false;
+    }
+}
+} // namespace
+
+FragmentReassembler::FragmentReassembler(size_t maxAssemblies,
+                                         uint32_t timeoutMs)
+    : assemblies_(maxAssemblies > 0 ? maxAssemblies : 1),
+      timeoutMs_(timeoutMs) {}
+
+bool FragmentReassembler::addFragment(uint64_t senderKey,
+                                      const FrameView &fragment,
+                                      uint64_t nowMs, Frame &completeFrame) {
+    uint8_t sequence = fragment.fragmentsSequence;
+    FragmentHeader header;
+    ByteView data;
+
+    if (!FragmentHeader::parse(fragment.payload, header, data) ||
+        data.empty() ||
+        static_cast<size_t>(header.offset) + data.size() >
+            header.totalLength) {
+        LOG_W("FragmentReassembler",
+              "Dropping malformed fragment, sequence: %d, payload size: %zu",
+              sequence, fragment.payload.size());
+        return false;
+    }
+
+    Assembly &assembly = acquire(senderKey, fragment.packetId, nowMs);
+
+    // 消息计数器变化说明发送方已开始发送新消息，旧消息不可能再收齐
+    if (assembly.receivedCount > 0 &&
+        (assembly.messageCounter != header.messageCounter ||
+         assembly.buffer.size() != header.totalLength)) {
+        LOG_W("FragmentReassembler",
+              "Message %d superseded by message %d before completion "
+              "(PacketId: 0x%02X, received %d fragments)",
+              assembly.messageCounter, header.messageCounter,
+              fragment.packetId, assembly.receivedCount);
+        restart(assembly);
+    }
+
+    if (assembly.received.test(sequence)) {
+        LOG_D("FragmentReassembler", "Ignoring duplicate fragment %d",
+              sequence);
+        return false;
+    }
+
+    if (assembly.receivedCount == 0) {
+        // 首个到达的分片 (不一定是0号) 决定缓冲区大小
+        assembly.messageCounter = header.messageCounter;
+        assembly.buffer.resize(header.totalLength);
+    }
+
+    if (header.offset == 0) {
+        assembly.messageId = data[0];
+        assembly.sourceId =
+            (hasSourceId(fragment.packetId) && data.size() >= 5)
+                ? Codec::loadLE<uint32_t>(data.data() + 1)
+                : 0;
+    }
+    if (fragment.moreFragmentsFlag == 0) {
+        assembly.totalFragments = static_cast<uint16_t>(sequence + 1);
+    }
+
+    std::memcpy(assembly.buffer.data() + header.offset, data.data(),
+                data.size());
+    assembly.received.set(sequence);
+    assembly.receivedCount++;
+    assembly.receivedBytes += data.size();
+    assembly.lastUpdateMs = nowMs;
+
+    LOG_D("FragmentReassembler",
+          "Stored fragment %d (%zu bytes at offset %d) of message %d, "
+          "PacketId: 0x%02X, collected %zu/%zu bytes",
+          sequence, data.size(), header.offset, header.messageCounter,
+          fragment.packetId, assembly.receivedBytes, assembly.buffer.size());
+
+    if (assembly.totalFragments == 0 ||
+        assembly.receivedCount != assembly.totalFragments ||
+        assembly.receivedBytes != assembly.buffer.size()) {
+        return false;
+    }
+
+    completeFrame.delimiter1 = FRAME_DELIMITER_1;
+    completeFrame.delimiter2 = FRAME_DELIMITER_2;
+    completeFrame.packetId = assembly.packetId;
+    completeFrame.fragmentsSequence = 0;
+    completeFrame.moreFragmentsFlag = 0;
+    completeFrame.packetLength = static_cast<uint16_t>(assembly.buffer.size());
+    completeFrame.checksumType = fragment.checksumType;
+
+    LOG_I("FragmentReassembler",
+          "Reassembled message 0x%02X from source 0x%08X, PacketId: 0x%02X, "
+          "%d fragments, %zu bytes",
+          assembly.messageId, assembly.sourceId, assembly.packetId,
+          assembly.totalFragments, assembly.buffer.size());
+
+    // 重组缓冲区直接交给完整帧，不再拷贝
+    completeFrame.payload.swap(assembly.buffer);
+    release(assembly);
+    return true;
+}
+
+size_t FragmentReassembler::cleanupExpired(uint64_t nowMs) {
+    size_t removed = 0;
+    for (auto &assembly : assemblies_) {
+        if (assembly.active && nowMs - assembly.lastUpdateMs > timeoutMs_) {
+            LOG_W("FragmentReassembler",
+                  "Fragment reassembly timed out for sender 0x%016llX, "
+                  "PacketId: 0x%02X (%d fragments received)",
+                  static_cast<unsigned long long>(assembly.senderKey),
+                  assembly.packetId, assembly.receivedCount);
+            release(assembly);
+            removed++;
+        }
+    }
+    return removed;
+}
+
+void FragmentReassembler::clear() {
+    for (auto &assembly : assemblies_) {
+        release(assembly);
+    }
+}
+
+size_t FragmentReassembler::activeCount() const {
+    size_t count = 0;
+    for (const auto &assembly : assemblies_) {
+        if (assembly.active)
+            count++;
+    }
+    return count;
+}
+
+// 查找发送方对应的槽位，不存在时分配空闲槽位或淘汰最久未更新的消息
+FragmentReassembler::Assembly &
+FragmentReassembler::acquire(uint64_t senderKey, uint8_t packetId,
+                             uint64_t nowMs) {
+    Assembly *freeSlot = nullptr;
+    Assembly *oldest = nullptr;
+    for (auto &assembly : assemblies_) {
+        if (!assembly.active) {
+            if (!freeSlot)
+                freeSlot = &assembly;
+            continue;
+        }
+        if (assembly.senderKey == senderKey && assembly.packetId == packetId)
+            return assembly;
+        if (!oldest || assembly.lastUpdateMs < oldest->lastUpdateMs)
+            oldest = &assembly;
+    }
+
+    Assembly *slot = freeSlot;
+    if (!slot) {
+        LOG_W("FragmentReassembler",
+              "Reassembly slots exhausted (%zu), evicting message from "
+              "sender 0x%016llX",
+              assemblies_.size(),
+              static_cast<unsigned long long>(oldest->senderKey));
+        slot = oldest;
+    }
+
+    restart(*slot);
+    slot->active = true;
+    slot->senderKey = senderKey;
+    slot->packetId = packetId;
+    slot->lastUpdateMs = nowMs;
+    return *slot;
+}
+
+// 清空槽位中的部分消息
+void FragmentReassembler::restart(Assembly &assembly) {
+    assembly.messageCounter = 0;
+    assembly.messageId = 0;
+    assembly.sourceId = 0;
+    assembly.totalFragments = 0;
+    assembly.receivedCount = 0;
+    assembly.receivedBytes = 0;
+    assembly.received.reset();
+    assembly.buffer.clear();
+}
+
+void FragmentReassembler::release(Assembly &assembly) {
+    restart(assembly);
+    assembly.active = false;
+}
+
+} // namespace WhtsProtocol
@@ -0,0 +1,69 @@
+#ifndef WHTS_PROTOCOL_FRAGMENT_REASSEMBLER_H
+#define WHTS_PROTOCOL_FRAGMENT_REASSEMBLER_H
+
+#include "Frame.h"
+#include "utils/ByteView.h"
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WhtsProtocol {
+
+// 分片重组器
+// 按 (发送方, PacketId) 区分正在重组的消息，分片子头中的消息计数器
+// 标识消息本身。收到消息的任一分片时按子头中的总长度一次性分配缓冲区，
+// 各分片按偏移直接写入最终位置，重组开销与消息长度成正比。
+// 槽位数量固定；槽位用尽时淘汰最久未更新的消息，超时未收齐的消息由
+// cleanupExpired 清除。
+class FragmentReassembler {
+  public:
+    static constexpr size_t DEFAULT_MAX_ASSEMBLIES = 64;
+    static constexpr uint32_t DEFAULT_TIMEOUT_MS = 5000;
+    static constexpr size_t MAX_FRAGMENTS = 256; // 分片序号为8位
+
+    explicit FragmentReassembler(size_t maxAssemblies = DEFAULT_MAX_ASSEMBLIES,
+                                 uint32_t timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    // 处理一个分片，消息收齐时写入 completeFrame 并返回 true
+    // senderKey 标识发送方 (如地址与端口)，nowMs 为单调时钟毫秒数
+    bool addFragment(uint64_t senderKey, const FrameView &fragment,
+                     uint64_t nowMs, Frame &completeFrame);
+
+    // 清除超过超时时间未更新的消息，返回清除的数量
+    size_t cleanupExpired(uint64_t nowMs);
+
+    void clear();
+
+    // 正在重组的消息数量
+    size_t activeCount() const;
+
+    void setTimeout(uint32_t timeoutMs) { timeoutMs_ = timeoutMs; }
+
+  private:
+    struct Assembly {
+        bool active = false;
+        uint64_t senderKey = 0;
+        uint8_t packetId = 0;
+        uint8_t messageCounter = 0;
+        uint8_t messageId = 0;       // 取自偏移为0的分片
+        uint32_t sourceId = 0;       // 取自偏移为0的分片，无ID字段时为0
+        uint16_t totalFragments = 0; // 0表示尚未收到末尾分片
+        uint16_t receivedCount = 0;
+        size_t receivedBytes = 0;
+        std::bitset<MAX_FRAGMENTS> received;
+        std::vector<uint8_t> buffer; // 按子头总长度分配的重组载荷
+        uint64_t lastUpdateMs = 0;
+    };
+
+    Assembly &acquire(uint64_t senderKey, uint8_t packetId, uint64_t nowMs);
+    static void restart(Assembly &assembly);
+    static void release(Assembly &assembly);
+
+    std::vector<Assembly> assemblies_;
+    uint32_t timeoutMs_;
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_FRAGMENT_REASSEMBLER_H
@@ -1,11 +1,123 @@
 #include "Frame.h"
 #include "utils/ByteUtils.h"
+#include "utils/Crc.h"
 
 namespace WhtsProtocol {
 
+bool decodeFrameFlags(uint8_t flags, uint8_t &moreFragmentsFlag,
+                      ChecksumType &checksum) {
+    uint8_t type = static_cast<uint8_t>((flags & FRAME_FLAG_CHECKSUM_MASK) >>
+                                        FRAME_FLAG_CHECKSUM_SHIFT);
+    if ((flags & FRAME_FLAG_RESERVED_MASK) != 0 ||
+        type > static_cast<uint8_t>(ChecksumType::CRC32C))
+        return false;
+
+    moreFragmentsFlag = flags & FRAME_FLAG_MORE_FRAGMENTS;
+    checksum = static_cast<ChecksumType>(type);
+    return true;
+}
+
+FrameChecksum::FrameChecksum(ChecksumType type)
+    : type_(type), value_(type == ChecksumType::CRC16 ? Crc::CRC16_INIT : 0) {}
+
+void FrameChecksum::update(ByteView data) {
+    switch (type_) {
+    case ChecksumType::CRC16:
+        value_ = Crc::crc16(data.data(), data.size(),
+                            static_cast<uint16_t>(value_));
+        break;
+    case ChecksumType::CRC32C:
+        value_ = Crc::crc32c(data.data(), data.size(), value_);
+        break;
+    default:
+        break;
+    }
+}
+
+size_t FrameChecksum::write(uint8_t *out) const {
+    switch (type_) {
+    case ChecksumType::CRC16:
+        ByteUtils::storeUint16LE(out, static_cast<uint16_t>(value_));
+        return 2;
+    case ChecksumType::CRC32C:
+        ByteUtils::storeUint32LE(out, value_);
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+bool FrameChecksum::matches(ByteView trailer) const {
+    uint8_t expected[MAX_CHECKSUM_SIZE];
+    size_t size = write(expected);
+    if (trailer.size() != size)
+        return false;
+
+    for (size_t i = 0; i < size; ++i) {
+        if (trailer[i] != expected[i])
+            return false;
+    }
+    return true;
+}
+
+FrameView::FrameView()
+    : packetId(0), fragmentsSequence(0), moreFragmentsFlag(0),
+      packetLength(0), checksumType(ChecksumType::NONE) {}
+
+bool FrameView::parse(ByteView data, FrameView &frame) {
+    if (data.size() < FRAME_HEADER_SIZE)
+        return false;
+
+    if (data[0] != FRAME_DELIMITER_1 || data[1] != FRAME_DELIMITER_2)
+        return false;
+
+    frame.packetId = data[2];
+    frame.fragmentsSequence = data[3];
+    if (!decodeFrameFlags(data[4], frame.moreFragmentsFlag,
+                          frame.checksumType))
+        return false;
+
+    // 小端序读取长度
+    frame.packetLength = static_cast<uint16_t>(data[5] | (data[6] << 8));
+
+    if (data.size() < frame.totalSize())
+        return false;
+
+    size_t covered = FRAME_HEADER_SIZE + frame.packetLength;
+    if (frame.checksumType != ChecksumType::NONE) {
+        FrameChecksum checksum(frame.checksumType);
+        checksum.update(data.subview(0, covered));
+        if (!checksum.matches(data.subview(
+                covered, checksumSize(frame.checksumType))))
+            return false;
+    }
+
+    frame.payload = data.subview(FRAME_HEADER_SIZE, frame.packetLength);
+    return true;
+}
+
+void FragmentHeader::write(uint8_t *out) const {
+    out[0] = messageCounter;
+    ByteUtils::storeUint16LE(out + 1, totalLength);
+    ByteUtils::storeUint16LE(out + 3, offset);
+}
+
+bool FragmentHeader::parse(ByteView payload, FragmentHeader &header,
+                           ByteView &data) {
+    if (payload.size() < SIZE)
+        return false;
+
+    header.messageCounter = payload[0];
+    header.totalLength = static_cast<uint16_t>(payload[1] | (payload[2] << 8));
+    header.offset = static_cast<uint16_t>(payload[3] | (payload[4] << 8));
+    data = payload.subview(SIZE);
+    return true;
+}
+
 Frame::Frame()
     : delimiter1(FRAME_DELIMITER_1), delimiter2(FRAME_DELIMITER_2), packetId(0),
-      fragmentsSequence(0), moreFragmentsFlag(0), packetLength(0) {}
+      fragmentsSequence(0), moreFragmentsFlag(0), packetLength(0),
+      checksumType(ChecksumType::NONE) {}
 
 bool Frame::isValid() const {
     return delimiter1 == FRAME_DELIMITER_1 && delimiter2 == FRAME_DELIMITER_2;
@@ -13,41 +125,49 @@ bool Frame::isValid() const {
 
 std::vector<uint8_t> Frame::serialize() const {
     std::vector<uint8_t> result;
-    result.reserve(7 + payload.size());
+    result.reserve(FRAME_HEADER_SIZE + payload.size() +
+                   checksumSize(checksumType));
 
     result.push_back(delimiter1);
     result.push_back(delimiter2);
     result.push_back(packetId);
     result.push_back(fragmentsSequence);
-    result.push_back(moreFragmentsFlag);
+    result.push_back(encodeFrameFlags(moreFragmentsFlag, checksumType));
 
     // 小端序写入长度
     result.push_back(packetLength & 0xFF);
     result.push_back((packetLength >> 8) & 0xFF);
 
     result.insert(result.end(), payload.begin(), payload.end());
+
+    if (checksumType != ChecksumType::NONE) {
+        FrameChecksum checksum(checksumType);
+        checksum.update(result);
+        uint8_t trailer[MAX_CHECKSUM_SIZE];
+        size_t size = checksum.write(trailer);
+        result.insert(result.end(), trailer, trailer + size);
+    }
     return result;
 }
 
-bool Frame::deserialize(const std::vector<uint8_t> &data, Frame &frame) {
-    if (data.size() < 7)
+bool Frame::deserialize(ByteView data, Frame &frame) {
+    FrameView view;
+    if (!FrameView::parse(data, view))
         return false;
 
-    frame.delimiter1 = data[0];
-    frame.delimiter2 = data[1];
-    frame.packetId = data[2];
-    frame.fragmentsSequence = data[3];
-    frame.moreFragmentsFlag = data[4];
-
-    // 小端序读取长度
-    frame.packetLength = data[5] | (data[6] << 8);
-
-    if (data.size() < 7 + frame.packetLength)
-        return false;
+    frame.assign(view);
+    return true;
+}
 
-    frame.payload.assign(data.begin() + 7,
-                         data.begin() + 7 + frame.packetLength);
-    return frame.isValid();
+void Frame::assign(const FrameView &view) {
+    delimiter1 = FRAME_DELIMITER_1;
+    delimiter2 = FRAME_DELIMITER_2;
+    packetId = view.packetId;
+    fragmentsSequence = view.fragmentsSequence;
+    moreFragmentsFlag = view.moreFragmentsFlag;
+    packetLength = view.packetLength;
+    checksumType = view.checksumType;
+    payload.assign(view.payload.begin(), view.payload.end());
 }
 
-} // namespace WhtsProtocol
\ No newline at end of file
+} // namespace WhtsProtocol
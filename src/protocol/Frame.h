@@ -2,12 +2,104 @@
 #define WHTS_PROTOCOL_FRAME_H
 
 #include "Common.h"
+#include "utils/ByteView.h"
 #include <cstdint>
 #include <vector>
 
 
 namespace WhtsProtocol {
 
+// 帧头长度: 2字节分隔符 + PacketId + 分片序号 + 分片标志 + 2字节长度
+constexpr size_t FRAME_HEADER_SIZE = 7;
+
+// 帧标志字节 (帧头第5字节)
+// bit0: 后续还有分片; bit1-2: 校验类型 (ChecksumType); bit3-7: 保留，必须为0
+constexpr uint8_t FRAME_FLAG_MORE_FRAGMENTS = 0x01;
+constexpr uint8_t FRAME_FLAG_CHECKSUM_SHIFT = 1;
+constexpr uint8_t FRAME_FLAG_CHECKSUM_MASK = 0x06;
+constexpr uint8_t FRAME_FLAG_RESERVED_MASK = 0xF8;
+
+// 帧校验类型: 校验尾紧跟在载荷之后，不计入长度字段，覆盖帧头与载荷
+// 旧版本接收方会把非零标志字节当作分片标志，因此发送方只在对端支持时启用
+enum class ChecksumType : uint8_t {
+    NONE = 0,
+    CRC16 = 1,  // CRC-16/CCITT-FALSE，2字节
+    CRC32C = 2, // CRC-32C，4字节
+};
+
+constexpr size_t MAX_CHECKSUM_SIZE = 4;
+
+constexpr size_t checksumSize(ChecksumType type) {
+    return type == ChecksumType::CRC16    ? 2
+           : type == ChecksumType::CRC32C ? 4
+                                          : 0;
+}
+
+// 组合/拆分帧标志字节，保留位非零或校验类型未知时返回false
+constexpr uint8_t encodeFrameFlags(uint8_t moreFragmentsFlag,
+                                   ChecksumType checksum) {
+    return static_cast<uint8_t>(
+        (moreFragmentsFlag ? FRAME_FLAG_MORE_FRAGMENTS : 0) |
+        (static_cast<uint8_t>(checksum) << FRAME_FLAG_CHECKSUM_SHIFT));
+}
+bool decodeFrameFlags(uint8_t flags, uint8_t &moreFragmentsFlag,
+                      ChecksumType &checksum);
+
+// 帧校验计算，可分段追加数据
+class FrameChecksum {
+  public:
+    explicit FrameChecksum(ChecksumType type);
+
+    void update(ByteView data);
+    // 以小端序写入校验尾 (调用方保证 out 至少有 checksumSize 字节)
+    size_t write(uint8_t *out) const;
+    // 比较校验尾
+    bool matches(ByteView trailer) const;
+
+  private:
+    ChecksumType type_;
+    uint32_t value_;
+};
+
+// 分片子头: 仅出现在分片帧 (isFragment()) 的载荷开头
+// 消息计数器区分同一发送方的先后消息，总长度与偏移使接收方可以
+// 在收到任一分片时就分配好完整缓冲区并把分片直接写到最终位置。
+struct FragmentHeader {
+    static constexpr size_t SIZE = 5;
+
+    uint8_t messageCounter; // 发送方每发送一条分片消息递增
+    uint16_t totalLength;   // 重组后的载荷总长度
+    uint16_t offset;        // 本分片数据在重组载荷中的偏移
+
+    // 写入子头 (调用方保证 out 至少有 SIZE 字节)
+    void write(uint8_t *out) const;
+    // 解析分片载荷，data 返回子头之后的分片数据
+    static bool parse(ByteView payload, FragmentHeader &header,
+                      ByteView &data);
+};
+
+// 非拥有的帧视图，载荷直接指向原始接收缓冲区
+struct FrameView {
+    uint8_t packetId;
+    uint8_t fragmentsSequence;
+    uint8_t moreFragmentsFlag;
+    uint16_t packetLength;
+    ChecksumType checksumType;
+    ByteView payload;
+
+    FrameView();
+    // 帧在线上的总长度 (帧头 + 载荷 + 校验尾)
+    size_t totalSize() const {
+        return FRAME_HEADER_SIZE + packetLength + checksumSize(checksumType);
+    }
+    bool isFragment() const {
+        return moreFragmentsFlag != 0 || fragmentsSequence > 0;
+    }
+    // 在视图上解析帧，不拷贝载荷
+    // 标志字节非法或校验尾不匹配时返回false
+    static bool parse(ByteView data, FrameView &frame);
+};
+
 // 帧结构
 struct Frame {
     uint8_t delimiter1;
@@ -16,14 +108,68 @@ struct Frame {
     uint8_t fragmentsSequence;
     uint8_t moreFragmentsFlag;
     uint16_t packetLength;
+    ChecksumType checksumType; // serialize 时追加的校验尾类型
     std::vector<uint8_t> payload;
 
     Frame();
     bool isValid() const;
     std::vector<uint8_t> serialize() const;
-    static bool deserialize(const std::vector<uint8_t> &data, Frame &frame);
+    static bool deserialize(ByteView data, Frame &frame);
+
+    // 从帧视图构建拥有载荷的帧
+    void assign(const FrameView &view);
+};
+
+// 分散-聚集发送描述符: 一个待发送的数据报 =
+//   header[0, headerSize) + payload + trailer[0, trailerSize)
+// 未分片的帧 headerSize 与 trailerSize 为0，payload 即整帧 (含校验尾)
+struct FragmentDescriptor {
+    static constexpr size_t MAX_HEADER_SIZE =
+        FRAME_HEADER_SIZE + FragmentHeader::SIZE;
+
+    uint8_t header[MAX_HEADER_SIZE];
+    uint8_t headerSize;
+    ByteView payload; // 指向 GatherFrames::buffer 中的切片
+    uint8_t trailer[MAX_CHECKSUM_SIZE];
+    uint8_t trailerSize;
+
+    size_t size() const { return headerSize + payload.size() + trailerSize; }
+};
+
+// 分散-聚集打包结果: 消息只序列化一次，各分片描述符引用同一缓冲区
+// 描述符中的视图指向 buffer，因此不可拷贝；可在多次打包间复用以保留容量
+struct GatherFrames {
+    std::vector<uint8_t> buffer;
+    std::vector<FragmentDescriptor> fragments;
+
+    GatherFrames() = default;
+    GatherFrames(const GatherFrames &) = delete;
+    GatherFrames &operator=(const GatherFrames &) = delete;
+
+    void clear() {
+        buffer.clear();
+        fragments.clear();
+    }
+};
+
+// 批量打包结果: 所有数据报首尾相接写入同一 arena
+// 第i个数据报为 arena[offsets[i], offsets[i + 1])，可复用以保留容量
+struct PackedBatch {
+    std::vector<uint8_t> arena;
+    std::vector<size_t> offsets{0};
+
+    size_t datagramCount() const { return offsets.size() - 1; }
+    ByteView datagram(size_t index) const {
+        return ByteView(arena.data() + offsets[index],
+                        offsets[index + 1] - offsets[index]);
+    }
+
+    void clear() {
+        arena.clear();
+        offsets.assign(1, 0);
+    }
 };
 
 } // namespace WhtsProtocol
 
-#endif // WHTS_PROTOCOL_FRAME_H
\ No newline at end of file
+#endif // WHTS_PROTOCOL_FRAME_H
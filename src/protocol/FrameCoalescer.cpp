@@ -0,0 +1,50 @@
+#include "FrameCoalescer.h"
+#include <cstring>
+
+namespace WhtsProtocol {
+
+FrameCoalescer::FrameCoalescer(size_t maxDatagramSize)
+    : maxDatagramSize_(maxDatagramSize), frameCount_(0), firstQueuedMs_(0) {}
+
+void FrameCoalescer::append(ByteView frame, uint32_t nowMs) {
+    if (frame.empty())
+        return;
+
+    if (frameCount_ == 0)
+        firstQueuedMs_ = nowMs;
+
+    // 最后一个数据报放得下时接在其后，否则另起一个数据报
+    size_t count = batch_.datagramCount();
+    size_t lastSize =
+        count > 0 ? batch_.arena.size() - batch_.offsets[count - 1] : 0;
+    bool extendLast = count > 0 && lastSize + frame.size() <= maxDatagramSize_;
+
+    size_t start = batch_.arena.size();
+    batch_.arena.resize(start + frame.size());
+    std::memcpy(batch_.arena.data() + start, frame.data(), frame.size());
+
+    if (extendLast)
+        batch_.offsets.back() = batch_.arena.size();
+    else
+        batch_.offsets.push_back(batch_.arena.size());
+    ++frameCount_;
+}
+
+bool FrameCoalescer::due(uint32_t nowMs, uint32_t deadlineMs) const {
+    return frameCount_ > 0 && nowMs - firstQueuedMs_ >= deadlineMs;
+}
+
+uint32_t FrameCoalescer::msUntilDue(uint32_t nowMs,
+                                    uint32_t deadlineMs) const {
+    if (frameCount_ == 0)
+        return UINT32_MAX;
+    uint32_t waited = nowMs - firstQueuedMs_;
+    return waited >= deadlineMs ? 0 : deadlineMs - waited;
+}
+
+void FrameCoalescer::clear() {
+    batch_.clear();
+    frameCount_ = 0;
+}
+
+} // namespace WhtsProtocol
@@ -0,0 +1,55 @@
+#ifndef WHTS_PROTOCOL_FRAME_COALESCER_H
+#define WHTS_PROTOCOL_FRAME_COALESCER_H
+
+#include "Frame.h"
+#include "utils/ByteView.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace WhtsProtocol {
+
+// 发送端粘包合并器
+// 接收端的 processReceivedData 可以从一个数据报中拆出多个首尾相接的帧，
+// 因此发往同一目的地的多个小帧可以合并为不超过最大长度的一个数据报，
+// 减少共享无线信道上每个广播包的固定开销。
+// 帧按追加顺序贪心装入当前数据报，放不下时另起一个；单帧超过最大长度时
+// 单独占用一个数据报 (调用方应先按 MTU 分片)。
+// 最早的帧等待达到截止时间后由调用方取出 batch() 发送并 clear()。
+class FrameCoalescer {
+  public:
+    static constexpr size_t DEFAULT_MAX_DATAGRAM_SIZE = 100;
+
+    explicit FrameCoalescer(
+        size_t maxDatagramSize = DEFAULT_MAX_DATAGRAM_SIZE);
+
+    void setMaxDatagramSize(size_t size) { maxDatagramSize_ = size; }
+    size_t getMaxDatagramSize() const { return maxDatagramSize_; }
+
+    // 追加一个完整帧 (或分片)，nowMs 为单调时钟毫秒数
+    void append(ByteView frame, uint32_t nowMs);
+
+    // 最早的帧已等待 deadlineMs 及以上时返回 true
+    bool due(uint32_t nowMs, uint32_t deadlineMs) const;
+
+    // 距 due() 成立的毫秒数，已到期返回0，没有帧时返回 UINT32_MAX
+    uint32_t msUntilDue(uint32_t nowMs, uint32_t deadlineMs) const;
+
+    bool empty() const { return frameCount_ == 0; }
+    size_t frameCount() const { return frameCount_; }
+
+    // 合并后的数据报，每个数据报由一个或多个完整帧组成
+    const PackedBatch &batch() const { return batch_; }
+
+    // 发送后清空，保留缓冲区容量
+    void clear();
+
+  private:
+    PackedBatch batch_;
+    size_t maxDatagramSize_;
+    size_t frameCount_;
+    uint32_t firstQueuedMs_;
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_FRAME_COALESCER_H
@@ -0,0 +1,376 @@
+#include "FrameDecoder.h"
+#include "../app/Logger.h"
+#include "utils/DelimiterScan.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace WhtsProtocol {
+
+namespace {
+// 单调时钟毫秒数，用于分片超时判断
+uint64_t steadyNowMs() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+} // namespace
+
+// Helper function to convert bytes to hex string
+std::string bytesToHexString(ByteView data, size_t maxBytes) {
+    std::stringstream ss;
+    size_t count = std::min(data.size(), maxBytes);
+    for (size_t i = 0; i < count; ++i) {
+        ss << std::hex << std::setw(2) << std::setfill('0')
+           << static_cast<int>(data[i]);
+        if (i < count - 1)
+            ss << " ";
+    }
+    if (data.size() > maxBytes) {
+        ss << "...";
+    }
+    return ss.str();
+}
+
+FrameDecoder::FrameDecoder()
+    : receiveBuffer_(MAX_RECEIVE_BUFFER_SIZE),
+      linearBuffer_(receiveBuffer_.capacity()),
+      reassembler_(FragmentReassembler::DEFAULT_MAX_ASSEMBLIES,
+                   FRAGMENT_TIMEOUT_MS),
+      currentSenderKey_(0), checksumErrors_(0) {}
+
+// Process received raw data (supports packet concatenation handling)
+void FrameDecoder::processReceivedData(ByteView data, uint64_t senderKey) {
+    currentSenderKey_ = senderKey;
+
+    LOG_D("FrameDecoder",
+          "Received new data, size: %zu bytes, prefix: %s", data.size(),
+          bytesToHexString(data, 8).c_str());
+
+    bool framesExtracted = false;
+    size_t offset = 0;
+    while (offset < data.size()) {
+        // 写入环形缓冲区，放不下的部分在提取帧腾出空间后继续写入
+        size_t written = receiveBuffer_.write(data.subview(offset));
+        offset += written;
+        LOG_D("FrameDecoder",
+              "Current receive buffer size: %zu bytes (wrote %zu)",
+              receiveBuffer_.size(), written);
+
+        // Try to extract complete frames from buffer
+        if (extractCompleteFrames()) {
+            framesExtracted = true;
+        }
+
+        if (written == 0 && receiveBuffer_.available() == 0) {
+            // 缓冲区已满且无法提取任何帧，只丢弃到下一个帧头为止的数据
+            LOG_W("FrameDecoder",
+                  "Receive buffer full (%zu bytes) without a complete frame, "
+                  "resynchronizing",
+                  receiveBuffer_.capacity());
+            resyncReceiveBuffer();
+        }
+    }
+
+    LOG_D("FrameDecoder", "Frame extraction result: %s",
+          framesExtracted ? "frames found" : "no frames found");
+
+    // Clean up expired fragments
+    cleanupExpiredFragments();
+}
+
+// 丢弃缓冲区头部直到下一个帧头 (跳过当前帧头)
+void FrameDecoder::resyncReceiveBuffer() {
+    size_t nextHeader = findFrameHeader(receiveBuffer_, 1);
+    if (nextHeader == SIZE_MAX) {
+        // 保留末尾可能属于下一个帧头的 0xAB
+        size_t keep = (!receiveBuffer_.empty() &&
+                       receiveBuffer_.at(receiveBuffer_.size() - 1) ==
+                           FRAME_DELIMITER_1)
+                          ? 1
+                          : 0;
+        nextHeader = receiveBuffer_.size() - keep;
+    }
+    LOG_W("FrameDecoder", "Discarding %zu bytes to resynchronize",
+          nextHeader);
+    receiveBuffer_.consume(nextHeader);
+}
+
+// Extract complete frames from receive buffer
+bool FrameDecoder::extractCompleteFrames() {
+    bool foundFrames = false;
+
+    LOG_D(
+        "FrameDecoder",
+        "Starting frame extraction from receive buffer, buffer size: %zu bytes",
+        receiveBuffer_.size());
+
+    while (!receiveBuffer_.empty()) {
+        // Find frame header
+        size_t frameStart = findFrameHeader(receiveBuffer_, 0);
+        if (frameStart == SIZE_MAX) {
+            LOG_D("FrameDecoder",
+                  "No frame header found, skipping current data");
+            // 没有帧头的数据不可能再组成帧，只保留末尾可能的半个帧头
+            resyncReceiveBuffer();
+            break;
+        }
+
+        if (frameStart > 0) {
+            LOG_W("FrameDecoder",
+                  "Discarding %zu bytes before frame header", frameStart);
+            receiveBuffer_.consume(frameStart);
+        }
+
+        // Check if there's enough data to read frame length
+        if (receiveBuffer_.size() < FRAME_HEADER_SIZE) {
+            LOG_D("FrameDecoder", "Insufficient data to read frame "
+                                        "length, waiting for more data");
+            break; // Not enough data, wait for more
+        }
+
+        // 标志字节决定校验尾长度，保留位非零说明不是真正的帧头
+        uint8_t moreFragments;
+        ChecksumType checksum;
+        if (!decodeFrameFlags(receiveBuffer_.at(4), moreFragments, checksum)) {
+            LOG_W("FrameDecoder",
+                  "Invalid frame flags 0x%02X, skipping header",
+                  receiveBuffer_.at(4));
+            checksumErrors_++;
+            resyncReceiveBuffer();
+            continue;
+        }
+
+        // 读取帧长度
+        uint16_t frameLength = static_cast<uint16_t>(
+            receiveBuffer_.at(5) | (receiveBuffer_.at(6) << 8));
+        size_t totalFrameSize =
+            FRAME_HEADER_SIZE + frameLength + checksumSize(checksum);
+
+        LOG_D("FrameDecoder",
+              "Frame payload length: %d, total frame size: %zu", frameLength,
+              totalFrameSize);
+
+        // 超出缓冲区容量的帧永远无法收齐，视为误判的帧头并跳过
+        if (totalFrameSize > receiveBuffer_.capacity()) {
+            LOG_W("FrameDecoder",
+                  "Frame size %zu exceeds receive buffer capacity %zu, "
+                  "skipping header",
+                  totalFrameSize, receiveBuffer_.capacity());
+            resyncReceiveBuffer();
+            continue;
+        }
+
+        // 检查是否有完整的帧
+        if (totalFrameSize > receiveBuffer_.size()) {
+            LOG_D(
+                "FrameDecoder",
+                "Incomplete frame, waiting for more data. Need: %zu, have: %zu",
+                totalFrameSize, receiveBuffer_.size());
+            break; // 帧不完整，等待更多数据
+        }
+
+        // 帧未跨越回绕点时直接在环形缓冲区上解析，否则拼接到线性缓冲区
+        ByteView frameData = receiveBuffer_.peekContiguous(
+            0, totalFrameSize, linearBuffer_.data());
+
+        LOG_D(
+            "FrameDecoder",
+            "Extracted complete frame data, size: %zu bytes, frame prefix: %s",
+            frameData.size(), bytesToHexString(frameData, 16).c_str());
+
+        // 解析帧
+        FrameView frame;
+        if (FrameView::parse(frameData, frame)) {
+            LOG_D(
+                "FrameDecoder",
+                "Frame parsed successfully, PacketId: 0x%02X, "
+                "fragment_sequence: %d, more_fragments: %d, payload_length: %d",
+                frame.packetId, frame.fragmentsSequence,
+                frame.moreFragmentsFlag, frame.packetLength);
+
+            if (acceptFrame(frame))
+                foundFrames = true;
+        } else {
+            // 校验失败说明帧头或长度可能已损坏，只跳过当前帧头，
+            // 从下一个帧头重新同步，避免吞掉后续的完整帧
+            LOG_W("FrameDecoder",
+                  "Frame checksum mismatch (PacketId: 0x%02X, length: %d), "
+                  "resynchronizing",
+                  frameData[2], frameLength);
+            checksumErrors_++;
+            resyncReceiveBuffer();
+            continue;
+        }
+
+        // 释放已处理的帧 (常数时间，不搬移剩余数据)
+        receiveBuffer_.consume(totalFrameSize);
+    }
+
+    return foundFrames;
+}
+
+// 已校验的帧: 分片交给重组，单帧直接入队
+bool FrameDecoder::acceptFrame(const FrameView &frame) {
+    // 检查是否是分片
+    if (frame.isFragment()) {
+        LOG_D("FrameDecoder",
+              "Fragment frame detected, starting fragment reassembly");
+        // 直接重组到队列的空闲槽位中，未完成时槽位留待下次使用
+        Frame &completedFrame = completeFrames_.prepare();
+        if (!reassembleFragments(frame, completedFrame)) {
+            LOG_D("FrameDecoder", "Fragment reassembly not complete, waiting "
+                                  "for more fragments");
+            return false;
+        }
+        LOG_D("FrameDecoder",
+              "Reassembled frame parsed successfully, PacketId: 0x%02X, "
+              "payload_length: %d",
+              completedFrame.packetId, completedFrame.packetLength);
+        completeFrames_.commit();
+        return true;
+    }
+
+    LOG_D("FrameDecoder",
+          "Single complete frame, adding to complete frame queue");
+    // 单个完整帧，仅在入队时拷贝一次载荷 (复用槽位容量)
+    completeFrames_.prepare().assign(frame);
+    completeFrames_.commit();
+    return true;
+}
+
+// 数据报快速路径: 帧不会跨越数据报，直接在数据报上逐帧解析
+size_t FrameDecoder::processDatagram(ByteView datagram, uint64_t senderKey) {
+    currentSenderKey_ = senderKey;
+
+    size_t frames = 0;
+    size_t offset = 0;
+    while (offset < datagram.size()) {
+        size_t frameStart = findFrameHeader(datagram, offset);
+        if (frameStart == SIZE_MAX) {
+            LOG_W("FrameDecoder",
+                  "Discarding %zu trailing bytes without frame header",
+                  datagram.size() - offset);
+            break;
+        }
+        if (frameStart > offset) {
+            LOG_W("FrameDecoder", "Discarding %zu bytes before frame header",
+                  frameStart - offset);
+        }
+
+        FrameView frame;
+        ByteView rest = datagram.subview(frameStart);
+        if (!FrameView::parse(rest, frame)) {
+            // 标志非法、校验失败或帧被截断，跳过该帧头继续查找
+            LOG_W("FrameDecoder",
+                  "Invalid or truncated frame at offset %zu in %zu byte "
+                  "datagram, skipping header",
+                  frameStart, datagram.size());
+            checksumErrors_++;
+            offset = frameStart + 1;
+            continue;
+        }
+
+        if (acceptFrame(frame))
+            ++frames;
+        offset = frameStart + frame.totalSize();
+    }
+
+    cleanupExpiredFragments();
+    return frames;
+}
+
+// 查找帧头
+// 向量化扫描，实现在编译期选择 (见 utils/DelimiterScan.h)
+size_t FrameDecoder::findFrameHeader(ByteView buffer, size_t startPos) {
+    if (startPos >= buffer.size())
+        return SIZE_MAX;
+
+    size_t pos =
+        Scan::findBytePair(buffer.data() + startPos, buffer.size() - startPos,
+                           FRAME_DELIMITER_1, FRAME_DELIMITER_2);
+    return pos == SIZE_MAX ? SIZE_MAX : startPos + pos;
+}
+
+// 在环形缓冲区中查找帧头，处理跨越回绕点的帧头
+size_t FrameDecoder::findFrameHeader(const ByteRingBuffer &buffer,
+                                     size_t startPos) {
+    ByteView first, second;
+    buffer.segments(startPos, first, second);
+
+    size_t pos = findFrameHeader(first, 0);
+    if (pos != SIZE_MAX)
+        return startPos + pos;
+
+    if (second.empty())
+        return SIZE_MAX;
+
+    // 帧头的两个字节分别位于回绕点两侧
+    if (!first.empty() && first[first.size() - 1] == FRAME_DELIMITER_1 &&
+        second[0] == FRAME_DELIMITER_2) {
+        return startPos + first.size() - 1;
+    }
+
+    pos = findFrameHeader(second, 0);
+    if (pos != SIZE_MAX)
+        return startPos + first.size() + pos;
+    return SIZE_MAX;
+}
+
+// 分片重组
+bool FrameDecoder::reassembleFragments(const FrameView &frame,
+                                       Frame &completeFrame) {
+    LOG_D("FrameDecoder",
+          "Starting fragment reassembly, fragment_sequence: %d, "
+          "more_fragments: %d",
+          frame.fragmentsSequence, frame.moreFragmentsFlag);
+
+    return reassembler_.addFragment(currentSenderKey_, frame, steadyNowMs(),
+                                    completeFrame);
+}
+
+// Get next complete frame
+bool FrameDecoder::getNextCompleteFrame(Frame &frame) {
+    return completeFrames_.pop(frame);
+}
+
+Frame *FrameDecoder::peekCompleteFrame() {
+    return completeFrames_.empty() ? nullptr : &completeFrames_.front();
+}
+
+void FrameDecoder::popCompleteFrame() {
+    if (!completeFrames_.empty())
+        completeFrames_.discardFront();
+}
+
+size_t FrameDecoder::drainCompleteFrames(SpscQueue<Frame> &queue) {
+    size_t moved = 0;
+    while (!completeFrames_.empty() &&
+           queue.tryPush(completeFrames_.front())) {
+        // 交换回来的旧帧留在槽位中，其载荷容量供后续帧复用
+        completeFrames_.discardFront();
+        ++moved;
+    }
+    return moved;
+}
+
+// Clear receive buffer
+void FrameDecoder::clear() {
+    receiveBuffer_.clear();
+    completeFrames_.clear();
+    reassembler_.clear();
+}
+
+// Clean up expired fragments
+void FrameDecoder::cleanupExpiredFragments() {
+    size_t removed = reassembler_.cleanupExpired(steadyNowMs());
+    if (removed > 0) {
+        LOG_W("FrameDecoder", "Dropped %zu expired partial messages",
+              removed);
+    }
+}
+
+} // namespace WhtsProtocol
@@ -0,0 +1,95 @@
+#ifndef WHTS_PROTOCOL_FRAME_DECODER_H
+#define WHTS_PROTOCOL_FRAME_DECODER_H
+
+#include "FragmentReassembler.h"
+#include "Frame.h"
+#include "FrameQueue.h"
+#include "utils/ByteView.h"
+#include "utils/RingBuffer.h"
+#include "utils/SpscQueue.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WhtsProtocol {
+
+// 接收端帧解码器 (每个连接 / 接收线程一个实例)
+// 持有接收环形缓冲区、分片重组状态与完整帧队列，负责粘包拆分、
+// 校验与分片重组。
+// 线程约定: 实例不是线程安全的，所有成员函数必须由同一个线程调用
+// (通常是网络接收线程)。需要把帧交给其他线程时使用 drainCompleteFrames
+// 与 SpscQueue，不要在两个线程中共享同一个解码器。
+class FrameDecoder {
+  public:
+    FrameDecoder();
+
+    FrameDecoder(const FrameDecoder &) = delete;
+    FrameDecoder &operator=(const FrameDecoder &) = delete;
+
+    // 处理接收到的原始数据 (支持粘包处理)
+    // senderKey 标识数据的发送方 (如地址与端口)，用于区分不同发送方的分片
+    void processReceivedData(ByteView data, uint64_t senderKey = 0);
+
+    // 数据报快速路径: 按UDP数据报边界直接在 datagram 上解析，不经过流缓冲区
+    // 数据报内可以有多个首尾相接的帧；帧头前的垃圾与被截断的帧直接丢弃，
+    // 不会与后续数据报拼接。返回新增的完整帧数 (分片在重组完成时计数)
+    // 同一个解码器应只使用 processReceivedData 与本函数中的一种
+    size_t processDatagram(ByteView datagram, uint64_t senderKey = 0);
+
+    // 取出下一个完整帧 (与队列槽位交换，不拷贝载荷)
+    // frame 原有的载荷容量回到队列中复用，因此在循环中重复使用同一个
+    // Frame 对象时稳态下不分配内存
+    bool getNextCompleteFrame(Frame &frame);
+
+    // 原地访问队首完整帧，没有时返回nullptr
+    // 指针在下一次 popCompleteFrame / processReceivedData 前有效
+    Frame *peekCompleteFrame();
+    void popCompleteFrame();
+
+    // 把完整帧依次交换进跨线程队列，返回移交的帧数
+    // 由网络线程在 processReceivedData 之后调用，应用线程从 queue 取出；
+    // queue 已满时剩余帧留在本地队列，下次调用时继续移交
+    size_t drainCompleteFrames(SpscQueue<Frame> &queue);
+
+    // 清空接收缓冲区、完整帧队列与未完成的分片
+    void clear();
+
+    // 因校验失败、标志非法或 (数据报路径下) 被截断而丢弃的帧数
+    uint32_t getChecksumErrorCount() const { return checksumErrors_; }
+
+  private:
+    // 处理一个已校验的帧，产生完整帧时返回 true
+    bool acceptFrame(const FrameView &frame);
+
+    // 分片重组
+    bool reassembleFragments(const FrameView &frame, Frame &completeFrame);
+
+    // 从接收缓冲区中提取完整帧
+    bool extractCompleteFrames();
+
+    // 缓冲区满或出现无效数据时，丢弃到下一个帧头为止
+    void resyncReceiveBuffer();
+
+    // 查找帧头
+    size_t findFrameHeader(ByteView buffer, size_t startPos);
+    size_t findFrameHeader(const ByteRingBuffer &buffer, size_t startPos);
+
+    // 清理超时的分片
+    void cleanupExpiredFragments();
+
+    ByteRingBuffer receiveBuffer_;      // 接收环形缓冲区
+    std::vector<uint8_t> linearBuffer_; // 帧跨越回绕点时的拼接缓冲区
+    FrameQueue completeFrames_;         // 完整帧队列 (复用载荷容量)
+    FragmentReassembler reassembler_;   // 分片重组
+    uint64_t currentSenderKey_;         // 当前处理数据的发送方
+    uint32_t checksumErrors_;           // 校验失败的帧数
+
+    static constexpr uint32_t FRAGMENT_TIMEOUT_MS =
+        5000; // 分片超时时间（毫秒）
+    static constexpr size_t MAX_RECEIVE_BUFFER_SIZE =
+        4096; // 最大接收缓冲区大小
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_FRAME_DECODER_H
@@ -0,0 +1,44 @@
+#include "FrameQueue.h"
+#include <utility>
+
+namespace WhtsProtocol {
+
+FrameQueue::FrameQueue(size_t initialCapacity)
+    : slots_(initialCapacity > 0 ? initialCapacity : 1), head_(0), count_(0) {
+}
+
+Frame &FrameQueue::prepare() {
+    if (count_ == slots_.size()) {
+        // 按出队顺序移动到新数组，旧数组中的空对象随之释放
+        std::vector<Frame> grown(slots_.size() * 2);
+        for (size_t i = 0; i < count_; ++i)
+            grown[i] = std::move(slots_[(head_ + i) % slots_.size()]);
+        slots_.swap(grown);
+        head_ = 0;
+    }
+
+    Frame &slot = slots_[(head_ + count_) % slots_.size()];
+    slot.payload.clear();
+    return slot;
+}
+
+bool FrameQueue::pop(Frame &frame) {
+    if (count_ == 0)
+        return false;
+
+    std::swap(frame, slots_[head_]);
+    discardFront();
+    return true;
+}
+
+void FrameQueue::discardFront() {
+    head_ = (head_ + 1) % slots_.size();
+    --count_;
+}
+
+void FrameQueue::clear() {
+    head_ = 0;
+    count_ = 0;
+}
+
+} // namespace WhtsProtocol
@@ -0,0 +1,45 @@
+#ifndef WHTS_PROTOCOL_FRAME_QUEUE_H
+#define WHTS_PROTOCOL_FRAME_QUEUE_H
+
+#include "Frame.h"
+#include <cstddef>
+#include <vector>
+
+namespace WhtsProtocol {
+
+// 完整帧队列 (单线程)
+// 环形数组中的 Frame 对象在出队后不析构，而是作为对象池保留载荷容量:
+// 入队时在空闲槽位上原地填充，出队时与调用方的 Frame 交换，
+// 调用方手中的旧载荷回到池中供下一帧复用。
+// 槽位用尽时容量翻倍，已有帧按顺序移动到新数组。
+class FrameQueue {
+  public:
+    explicit FrameQueue(size_t initialCapacity = 8);
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    // 获取下一个空闲槽位 (载荷已清空，保留容量)，填充后调用 commit 入队
+    // 未调用 commit 时该槽位在下次 prepare 时被重新使用
+    Frame &prepare();
+    void commit() { ++count_; }
+
+    // 队首帧与 frame 交换后出队，队列为空时返回false
+    bool pop(Frame &frame);
+
+    // 队首帧 (调用方保证非空)
+    Frame &front() { return slots_[head_]; }
+    void discardFront();
+
+    // 丢弃所有帧，保留槽位与载荷容量
+    void clear();
+
+  private:
+    std::vector<Frame> slots_;
+    size_t head_;
+    size_t count_;
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_FRAME_QUEUE_H
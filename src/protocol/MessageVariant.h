@@ -0,0 +1,82 @@
+#ifndef WHTS_PROTOCOL_MESSAGE_VARIANT_H
+#define WHTS_PROTOCOL_MESSAGE_VARIANT_H
+
+#include "messages/Backend2Master.h"
+#include "messages/Master2Backend.h"
+#include "messages/Master2Slave.h"
+#include "messages/Slave2Backend.h"
+#include "messages/Slave2Master.h"
+#include <type_traits>
+#include <variant>
+
+namespace WhtsProtocol {
+
+// 按 PacketId 划分的消息变体，用于无堆分配、无 RTTI 的解码与分派
+// std::monostate 表示尚未解码或未知消息
+using Master2SlaveVariant =
+    std::variant<std::monostate, Master2Slave::SyncMessage,
+                 Master2Slave::ConductionConfigMessage,
+                 Master2Slave::ResistanceConfigMessage,
+                 Master2Slave::ClipConfigMessage,
+                 Master2Slave::ReadConductionDataMessage,
+                 Master2Slave::ReadResistanceDataMessage,
+                 Master2Slave::ReadClipDataMessage, Master2Slave::RstMessage,
+                 Master2Slave::PingReqMessage,
+                 Master2Slave::ShortIdAssignMessage>;
+
+using Slave2MasterVariant =
+    std::variant<std::monostate, Slave2Master::ConductionConfigResponseMessage,
+                 Slave2Master::ResistanceConfigResponseMessage,
+                 Slave2Master::ClipConfigResponseMessage,
+                 Slave2Master::RstResponseMessage, Slave2Master::PingRspMessage,
+                 Slave2Master::AnnounceMessage,
+                 Slave2Master::ShortIdConfirmMessage>;
+
+using Slave2BackendVariant =
+    std::variant<std::monostate, Slave2Backend::ConductionDataMessage,
+                 Slave2Backend::ResistanceDataMessage,
+                 Slave2Backend::ClipDataMessage>;
+
+using Backend2MasterVariant =
+    std::variant<std::monostate, Backend2Master::SlaveConfigMessage,
+                 Backend2Master::ModeConfigMessage, Backend2Master::RstMessage,
+                 Backend2Master::CtrlMessage, Backend2Master::PingCtrlMessage,
+                 Backend2Master::DeviceListReqMessage>;
+
+using Master2BackendVariant =
+    std::variant<std::monostate, Master2Backend::SlaveConfigResponseMessage,
+                 Master2Backend::ModeConfigResponseMessage,
+                 Master2Backend::RstResponseMessage,
+                 Master2Backend::CtrlResponseMessage,
+                 Master2Backend::PingResponseMessage,
+                 Master2Backend::DeviceListResponseMessage>;
+
+// 判断类型 T 是否为变体 Variant 的备选类型
+template <typename T, typename Variant> struct IsVariantMember;
+template <typename T, typename... Ts>
+struct IsVariantMember<T, std::variant<Ts...>>
+    : std::bool_constant<(std::is_same<T, Ts>::value || ...)> {};
+
+// 将变体中的消息视为基类引用 (变体为 std::monostate 时返回 nullptr)
+template <typename Variant> const Message *asMessage(const Variant &message) {
+    return std::visit(
+        [](const auto &msg) -> const Message * {
+            using T = std::decay_t<decltype(msg)>;
+            if constexpr (std::is_same<T, std::monostate>::value) {
+                return nullptr;
+            } else {
+                return &msg;
+            }
+        },
+        message);
+}
+
+// std::visit 使用的重载集合工具
+template <typename... Ts> struct Overloaded : Ts... {
+    using Ts::operator()...;
+};
+template <typename... Ts> Overloaded(Ts...) -> Overloaded<Ts...>;
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_MESSAGE_VARIANT_H
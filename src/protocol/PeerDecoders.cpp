@@ -0,0 +1,78 @@
+#include "PeerDecoders.h"
+#include "../app/Logger.h"
+
+namespace WhtsProtocol {
+
+PeerDecoders::PeerDecoders(size_t maxPeers, uint32_t idleTimeoutMs)
+    : maxPeers_(maxPeers ? maxPeers : 1), idleTimeoutMs_(idleTimeoutMs),
+      lastSweepMs_(0) {}
+
+FrameDecoder &PeerDecoders::get(uint64_t senderKey, uint64_t nowMs) {
+    auto it = peers_.find(senderKey);
+    if (it != peers_.end()) {
+        it->second.lastActiveMs = nowMs;
+        return *it->second.decoder;
+    }
+
+    if (peers_.size() >= maxPeers_) {
+        // 上下文已满，淘汰最久未活动的发送方 (数量有上限，线性扫描即可)
+        auto oldest = peers_.begin();
+        for (auto peer = peers_.begin(); peer != peers_.end(); ++peer) {
+            if (peer->second.lastActiveMs < oldest->second.lastActiveMs)
+                oldest = peer;
+        }
+        LOG_W("PeerDecoders",
+              "Decoder limit %zu reached, evicting sender 0x%016llX",
+              maxPeers_, static_cast<unsigned long long>(oldest->first));
+        release(std::move(oldest->second.decoder));
+        peers_.erase(oldest);
+    }
+
+    Peer peer;
+    if (!freeDecoders_.empty()) {
+        peer.decoder = std::move(freeDecoders_.back());
+        freeDecoders_.pop_back();
+    } else {
+        peer.decoder = std::make_unique<FrameDecoder>();
+    }
+    peer.lastActiveMs = nowMs;
+    LOG_D("PeerDecoders", "Created decoder for sender 0x%016llX (%zu active)",
+          static_cast<unsigned long long>(senderKey), peers_.size() + 1);
+    return *peers_.emplace(senderKey, std::move(peer)).first->second.decoder;
+}
+
+size_t PeerDecoders::evictIdle(uint64_t nowMs) {
+    if (nowMs - lastSweepMs_ < idleTimeoutMs_ / 4)
+        return 0;
+    lastSweepMs_ = nowMs;
+
+    size_t removed = 0;
+    for (auto it = peers_.begin(); it != peers_.end();) {
+        if (nowMs - it->second.lastActiveMs > idleTimeoutMs_) {
+            LOG_I("PeerDecoders", "Evicting idle decoder for sender 0x%016llX",
+                  static_cast<unsigned long long>(it->first));
+            release(std::move(it->second.decoder));
+            it = peers_.erase(it);
+            ++removed;
+        } else {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+void PeerDecoders::clear() {
+    for (auto &peer : peers_)
+        release(std::move(peer.second.decoder));
+    peers_.clear();
+}
+
+void PeerDecoders::release(std::unique_ptr<FrameDecoder> decoder) {
+    // 空闲列表只保留少量解码器，多余的直接释放
+    if (freeDecoders_.size() >= MAX_FREE_DECODERS)
+        return;
+    decoder->clear();
+    freeDecoders_.push_back(std::move(decoder));
+}
+
+} // namespace WhtsProtocol
@@ -0,0 +1,67 @@
+#ifndef WHTS_PROTOCOL_PEER_DECODERS_H
+#define WHTS_PROTOCOL_PEER_DECODERS_H
+
+#include "FrameDecoder.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace WhtsProtocol {
+
+// 按发送方划分的解码器上下文
+// 每个发送方 (如地址与端口) 拥有独立的接收缓冲区与分片重组状态，
+// 一个发送方的截断数据或垃圾数据不会与其他发送方的数据拼接，
+// 缓冲区溢出时的重同步也只影响该发送方。
+// 上下文数量有上限: 满时淘汰最久未活动的发送方；超过空闲时间的上下文
+// 由 evictIdle 回收。回收的解码器保留在空闲列表中复用，避免重复分配缓冲区。
+// 线程约定与 FrameDecoder 相同: 只能由接收线程使用。
+class PeerDecoders {
+  public:
+    static constexpr size_t DEFAULT_MAX_PEERS = 64;
+    static constexpr uint32_t DEFAULT_IDLE_TIMEOUT_MS = 60000;
+
+    explicit PeerDecoders(size_t maxPeers = DEFAULT_MAX_PEERS,
+                          uint32_t idleTimeoutMs = DEFAULT_IDLE_TIMEOUT_MS);
+
+    PeerDecoders(const PeerDecoders &) = delete;
+    PeerDecoders &operator=(const PeerDecoders &) = delete;
+
+    // 获取发送方的解码器 (不存在时创建)，并记录活动时间
+    // nowMs 为单调时钟毫秒数；返回的引用在下一次 get / evictIdle 前有效
+    FrameDecoder &get(uint64_t senderKey, uint64_t nowMs);
+
+    // 回收超过空闲时间的上下文，返回回收的数量
+    // 扫描按空闲时间的 1/4 限频，可以在每次接收后调用
+    size_t evictIdle(uint64_t nowMs);
+
+    size_t size() const { return peers_.size(); }
+    void clear();
+
+    void setMaxPeers(size_t maxPeers) { maxPeers_ = maxPeers ? maxPeers : 1; }
+    void setIdleTimeout(uint32_t idleTimeoutMs) {
+        idleTimeoutMs_ = idleTimeoutMs;
+    }
+
+  private:
+    struct Peer {
+        std::unique_ptr<FrameDecoder> decoder;
+        uint64_t lastActiveMs = 0;
+    };
+
+    // 回收解码器到空闲列表
+    void release(std::unique_ptr<FrameDecoder> decoder);
+
+    std::unordered_map<uint64_t, Peer> peers_;
+    std::vector<std::unique_ptr<FrameDecoder>> freeDecoders_;
+    size_t maxPeers_;
+    uint32_t idleTimeoutMs_;
+    uint64_t lastSweepMs_;
+
+    static constexpr size_t MAX_FREE_DECODERS = 4;
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_PEER_DECODERS_H
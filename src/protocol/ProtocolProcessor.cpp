@@ -5,185 +5,330 @@
 #include "messages/Master2Slave.h"
 #include "messages/Slave2Backend.h"
 #include "messages/Slave2Master.h"
+#include "utils/ByteUtils.h"
 #include <algorithm>
-#include <chrono>
 #include <cstring>
 #include <ctime>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
 #include <string>
 
 namespace WhtsProtocol {
 
-// Helper function to convert bytes to hex string
-std::string bytesToHexString(const std::vector<uint8_t> &data,
-                             size_t maxBytes) {
-    std::stringstream ss;
-    size_t count = std::min(data.size(), maxBytes);
-    for (size_t i = 0; i < count; ++i) {
-        ss << std::hex << std::setw(2) << std::setfill('0')
-           << static_cast<int>(data[i]);
-        if (i < count - 1)
-            ss << " ";
-    }
-    if (data.size() > maxBytes) {
-        ss << "...";
-    }
-    return ss.str();
-}
-
 // ProtocolProcessor 实现
-ProtocolProcessor::ProtocolProcessor() : mtu_(DEFAULT_MTU) {}
+ProtocolProcessor::ProtocolProcessor()
+    : mtu_(DEFAULT_MTU), checksumType_(ChecksumType::NONE),
+      fragmentCounter_(0), profiles_(std::make_shared<ProfileTable>()) {}
 ProtocolProcessor::~ProtocolProcessor() {}
 
-void ProtocolProcessor::writeUint16LE(std::vector<uint8_t> &buffer,
-                                      uint16_t value) {
-    buffer.push_back(value & 0xFF);
-    buffer.push_back((value >> 8) & 0xFF);
-}
-
-void ProtocolProcessor::writeUint32LE(std::vector<uint8_t> &buffer,
-                                      uint32_t value) {
-    buffer.push_back(value & 0xFF);
-    buffer.push_back((value >> 8) & 0xFF);
-    buffer.push_back((value >> 16) & 0xFF);
-    buffer.push_back((value >> 24) & 0xFF);
-}
-
-uint16_t ProtocolProcessor::readUint16LE(const std::vector<uint8_t> &buffer,
-                                         size_t offset) {
+uint16_t ProtocolProcessor::readUint16LE(ByteView buffer, size_t offset) const {
     if (offset + 1 >= buffer.size())
         return 0;
     return buffer[offset] | (buffer[offset + 1] << 8);
 }
 
-uint32_t ProtocolProcessor::readUint32LE(const std::vector<uint8_t> &buffer,
-                                         size_t offset) {
+uint32_t ProtocolProcessor::readUint32LE(ByteView buffer, size_t offset) const {
     if (offset + 3 >= buffer.size())
         return 0;
     return buffer[offset] | (buffer[offset + 1] << 8) |
            (buffer[offset + 2] << 16) | (buffer[offset + 3] << 24);
 }
 
-std::vector<uint8_t> ProtocolProcessor::packMaster2SlaveMessageSingle(
-    uint32_t destinationId, const Message &message, uint8_t fragmentsSequence,
-    uint8_t moreFragmentsFlag) {
-    Frame frame;
-    frame.packetId = static_cast<uint8_t>(PacketId::MASTER_TO_SLAVE);
-    frame.fragmentsSequence = fragmentsSequence;
-    frame.moreFragmentsFlag = moreFragmentsFlag;
+namespace {
+// 各包类型载荷中位于消息体之前的字节数 (Message ID + ID字段)
+size_t payloadPrefixSize(PacketId packetId) {
+    switch (packetId) {
+    case PacketId::MASTER_TO_SLAVE:
+    case PacketId::SLAVE_TO_MASTER:
+        return 5; // MessageId + 4字节ID
+    case PacketId::SLAVE_TO_BACKEND:
+        return 7; // MessageId + 4字节ID + 2字节DeviceStatus
+    default:
+        return 1; // MessageId
+    }
+}
+} // namespace
 
-    // 构建载荷
-    std::vector<uint8_t> payload;
-    payload.push_back(message.getMessageId());
-    writeUint32LE(payload, destinationId);
+size_t ProtocolProcessor::packedFrameSize(PacketId packetId,
+                                          const Message &message) const {
+    return frameSize(packetId, message, checksumType_);
+}
 
-    auto messageData = message.serialize();
-    payload.insert(payload.end(), messageData.begin(), messageData.end());
+size_t
+ProtocolProcessor::packedMaster2SlaveFrameSize(uint32_t destinationId,
+                                               const Message &message) const {
+    return frameSize(PacketId::MASTER_TO_SLAVE, message,
+                     formatFor(destinationId).checksumType);
+}
 
-    frame.payload = payload;
-    frame.packetLength = static_cast<uint16_t>(payload.size());
+size_t ProtocolProcessor::frameSize(PacketId packetId, const Message &message,
+                                    ChecksumType checksumType) {
+    return FRAME_HEADER_SIZE + payloadPrefixSize(packetId) +
+           message.serializedSize() + checksumSize(checksumType);
+}
 
-    return frame.serialize();
+// 档案更新: 复制当前快照，修改副本后整体发布，正在使用旧快照的打包不受影响
+// 档案只在从机上线时变化，整表复制的开销可以接受
+void ProtocolProcessor::setPeerProfile(uint32_t peerId,
+                                       const PeerProfile &profile) {
+    std::lock_guard<std::mutex> lock(profilesMutex_);
+    auto next = std::make_shared<ProfileTable>(*loadProfiles());
+    (*next)[peerId] = profile;
+    std::atomic_store(&profiles_,
+                      std::shared_ptr<const ProfileTable>(std::move(next)));
 }
 
-std::vector<uint8_t> ProtocolProcessor::packSlave2MasterMessageSingle(
-    uint32_t slaveId, const Message &message, uint8_t fragmentsSequence,
-    uint8_t moreFragmentsFlag) {
-    Frame frame;
-    frame.packetId = static_cast<uint8_t>(PacketId::SLAVE_TO_MASTER);
-    frame.fragmentsSequence = fragmentsSequence;
-    frame.moreFragmentsFlag = moreFragmentsFlag;
+bool ProtocolProcessor::getPeerProfile(uint32_t peerId,
+                                       PeerProfile &profile) const {
+    auto profiles = loadProfiles();
+    auto it = profiles->find(peerId);
+    if (it == profiles->end())
+        return false;
+    profile = it->second;
+    return true;
+}
 
-    // 构建载荷
-    std::vector<uint8_t> payload;
-    payload.push_back(message.getMessageId());
-    writeUint32LE(payload, slaveId);
+void ProtocolProcessor::removePeerProfile(uint32_t peerId) {
+    std::lock_guard<std::mutex> lock(profilesMutex_);
+    auto current = loadProfiles();
+    if (current->count(peerId) == 0)
+        return;
+    auto next = std::make_shared<ProfileTable>(*current);
+    next->erase(peerId);
+    std::atomic_store(&profiles_,
+                      std::shared_ptr<const ProfileTable>(std::move(next)));
+}
 
-    auto messageData = message.serialize();
-    payload.insert(payload.end(), messageData.begin(), messageData.end());
+size_t ProtocolProcessor::getMinPeerMTU() const {
+    auto profiles = loadProfiles();
+    if (profiles->empty())
+        return mtu_;
 
-    frame.payload = payload;
-    frame.packetLength = static_cast<uint16_t>(payload.size());
+    size_t minMtu = SIZE_MAX;
+    for (const auto &entry : *profiles) {
+        size_t mtu = entry.second.mtu ? entry.second.mtu : mtu_;
+        minMtu = std::min(minMtu, mtu);
+    }
+    return minMtu;
+}
 
-    return frame.serialize();
+ProtocolProcessor::WireFormat
+ProtocolProcessor::formatFor(uint32_t peerId) const {
+    return formatFor(*loadProfiles(), peerId);
 }
 
-std::vector<uint8_t> ProtocolProcessor::packSlave2BackendMessageSingle(
-    uint32_t slaveId, const DeviceStatus &deviceStatus, const Message &message,
-    uint8_t fragmentsSequence, uint8_t moreFragmentsFlag) {
-    Frame frame;
-    frame.packetId = static_cast<uint8_t>(PacketId::SLAVE_TO_BACKEND);
-    frame.fragmentsSequence = fragmentsSequence;
-    frame.moreFragmentsFlag = moreFragmentsFlag;
+// 有协商档案的对端使用档案中的MTU与校验尾，否则使用默认配置
+ProtocolProcessor::WireFormat
+ProtocolProcessor::formatFor(const ProfileTable &profiles,
+                             uint32_t peerId) const {
+    auto it = profiles.find(peerId);
+    if (it == profiles.end())
+        return defaultFormat();
+    const PeerProfile &profile = it->second;
+    return {profile.mtu ? profile.mtu : mtu_, profile.checksumType};
+}
+
+uint8_t *ProtocolProcessor::writeFrameHeader(uint8_t *out, size_t capacity,
+                                             PacketId packetId,
+                                             const Message &message,
+                                             uint8_t fragmentsSequence,
+                                             uint8_t moreFragmentsFlag,
+                                             ChecksumType checksumType) {
+    size_t payloadSize =
+        payloadPrefixSize(packetId) + message.serializedSize();
+    if (payloadSize > UINT16_MAX) {
+        LOG_E("ProtocolProcessor",
+              "Payload too large for a single frame: %zu bytes", payloadSize);
+        return nullptr;
+    }
+    size_t needed =
+        FRAME_HEADER_SIZE + payloadSize + checksumSize(checksumType);
+    if (capacity < needed) {
+        LOG_E("ProtocolProcessor",
+              "Output buffer too small: need %zu bytes, have %zu", needed,
+              capacity);
+        return nullptr;
+    }
 
-    // 构建载荷
-    std::vector<uint8_t> payload;
-    payload.push_back(message.getMessageId());
-    writeUint32LE(payload, slaveId);
-    writeUint16LE(payload, deviceStatus.toUint16());
+    out[0] = FRAME_DELIMITER_1;
+    out[1] = FRAME_DELIMITER_2;
+    out[2] = static_cast<uint8_t>(packetId);
+    out[3] = fragmentsSequence;
+    out[4] = encodeFrameFlags(moreFragmentsFlag, checksumType);
+    ByteUtils::storeUint16LE(out + 5, static_cast<uint16_t>(payloadSize));
+    out[FRAME_HEADER_SIZE] = message.getMessageId();
+    return out + FRAME_HEADER_SIZE + 1;
+}
 
-    auto messageData = message.serialize();
-    payload.insert(payload.end(), messageData.begin(), messageData.end());
+size_t ProtocolProcessor::sealFrame(uint8_t *frame, size_t size,
+                                    ChecksumType checksumType) {
+    if (checksumType == ChecksumType::NONE)
+        return size;
 
-    frame.payload = payload;
-    frame.packetLength = static_cast<uint16_t>(payload.size());
+    FrameChecksum checksum(checksumType);
+    checksum.update(ByteView(frame, size));
+    return size + checksum.write(frame + size);
+}
 
-    return frame.serialize();
+size_t ProtocolProcessor::packMaster2SlaveMessageInto(
+    uint32_t destinationId, const Message &message, uint8_t *out,
+    size_t capacity, uint8_t fragmentsSequence,
+    uint8_t moreFragmentsFlag) const {
+    return packMaster2SlaveInto(destinationId, message, out, capacity,
+                                fragmentsSequence, moreFragmentsFlag,
+                                formatFor(destinationId).checksumType);
 }
 
-std::vector<uint8_t>
-ProtocolProcessor::packBackend2MasterMessageSingle(const Message &message,
-                                                   uint8_t fragmentsSequence,
-                                                   uint8_t moreFragmentsFlag) {
-    Frame frame;
-    frame.packetId = static_cast<uint8_t>(PacketId::BACKEND_TO_MASTER);
-    frame.fragmentsSequence = fragmentsSequence;
-    frame.moreFragmentsFlag = moreFragmentsFlag;
+size_t ProtocolProcessor::packMaster2SlaveInto(
+    uint32_t destinationId, const Message &message, uint8_t *out,
+    size_t capacity, uint8_t fragmentsSequence, uint8_t moreFragmentsFlag,
+    ChecksumType checksumType) {
+    uint8_t *p = writeFrameHeader(out, capacity, PacketId::MASTER_TO_SLAVE,
+                                  message, fragmentsSequence,
+                                  moreFragmentsFlag, checksumType);
+    if (!p)
+        return 0;
 
-    // 构建载荷
-    std::vector<uint8_t> payload;
-    payload.push_back(message.getMessageId());
+    ByteUtils::storeUint32LE(p, destinationId);
+    p += 4;
 
-    auto messageData = message.serialize();
-    payload.insert(payload.end(), messageData.begin(), messageData.end());
+    size_t used = static_cast<size_t>(p - out);
+    return sealFrame(out, used + message.serializeInto(p, capacity - used),
+                     checksumType);
+}
+
+size_t ProtocolProcessor::packSlave2MasterMessageInto(
+    uint32_t slaveId, const Message &message, uint8_t *out, size_t capacity,
+    uint8_t fragmentsSequence, uint8_t moreFragmentsFlag) const {
+    uint8_t *p = writeFrameHeader(out, capacity, PacketId::SLAVE_TO_MASTER,
+                                  message, fragmentsSequence,
+                                  moreFragmentsFlag, checksumType_);
+    if (!p)
+        return 0;
 
-    frame.payload = payload;
-    frame.packetLength = static_cast<uint16_t>(payload.size());
+    ByteUtils::storeUint32LE(p, slaveId);
+    p += 4;
 
-    return frame.serialize();
+    size_t used = static_cast<size_t>(p - out);
+    return sealFrame(out, used + message.serializeInto(p, capacity - used),
+                     checksumType_);
 }
 
-std::vector<uint8_t>
-ProtocolProcessor::packMaster2BackendMessageSingle(const Message &message,
-                                                   uint8_t fragmentsSequence,
-                                                   uint8_t moreFragmentsFlag) {
-    Frame frame;
-    frame.packetId = static_cast<uint8_t>(PacketId::MASTER_TO_BACKEND);
-    frame.fragmentsSequence = fragmentsSequence;
-    frame.moreFragmentsFlag = moreFragmentsFlag;
+size_t ProtocolProcessor::packSlave2BackendMessageInto(
+    uint32_t slaveId, const DeviceStatus &deviceStatus, const Message &message,
+    uint8_t *out, size_t capacity, uint8_t fragmentsSequence,
+    uint8_t moreFragmentsFlag) const {
+    uint8_t *p = writeFrameHeader(out, capacity, PacketId::SLAVE_TO_BACKEND,
+                                  message, fragmentsSequence,
+                                  moreFragmentsFlag, checksumType_);
+    if (!p)
+        return 0;
 
-    // 构建载荷
-    std::vector<uint8_t> payload;
-    payload.push_back(message.getMessageId());
+    ByteUtils::storeUint32LE(p, slaveId);
+    ByteUtils::storeUint16LE(p + 4, deviceStatus.raw());
+    p += 6;
 
-    auto messageData = message.serialize();
-    payload.insert(payload.end(), messageData.begin(), messageData.end());
+    size_t used = static_cast<size_t>(p - out);
+    return sealFrame(out, used + message.serializeInto(p, capacity - used),
+                     checksumType_);
+}
 
-    frame.payload = payload;
-    frame.packetLength = static_cast<uint16_t>(payload.size());
+size_t ProtocolProcessor::packBackend2MasterMessageInto(
+    const Message &message, uint8_t *out, size_t capacity,
+    uint8_t fragmentsSequence, uint8_t moreFragmentsFlag) const {
+    uint8_t *p = writeFrameHeader(out, capacity, PacketId::BACKEND_TO_MASTER,
+                                  message, fragmentsSequence,
+                                  moreFragmentsFlag, checksumType_);
+    if (!p)
+        return 0;
+
+    size_t used = static_cast<size_t>(p - out);
+    return sealFrame(out, used + message.serializeInto(p, capacity - used),
+                     checksumType_);
+}
 
-    return frame.serialize();
+size_t ProtocolProcessor::packMaster2BackendMessageInto(
+    const Message &message, uint8_t *out, size_t capacity,
+    uint8_t fragmentsSequence, uint8_t moreFragmentsFlag) const {
+    uint8_t *p = writeFrameHeader(out, capacity, PacketId::MASTER_TO_BACKEND,
+                                  message, fragmentsSequence,
+                                  moreFragmentsFlag, checksumType_);
+    if (!p)
+        return 0;
+
+    size_t used = static_cast<size_t>(p - out);
+    return sealFrame(out, used + message.serializeInto(p, capacity - used),
+                     checksumType_);
+}
+
+// 单帧打包: 按帧大小一次性分配，帧头与消息体直接写入同一缓冲区
+std::vector<uint8_t> ProtocolProcessor::packMaster2SlaveMessageSingle(
+    uint32_t destinationId, const Message &message, uint8_t fragmentsSequence,
+    uint8_t moreFragmentsFlag) const {
+    ChecksumType checksumType = formatFor(destinationId).checksumType;
+    std::vector<uint8_t> frame(
+        frameSize(PacketId::MASTER_TO_SLAVE, message, checksumType));
+    frame.resize(packMaster2SlaveInto(destinationId, message, frame.data(),
+                                      frame.size(), fragmentsSequence,
+                                      moreFragmentsFlag, checksumType));
+    return frame;
 }
 
-bool ProtocolProcessor::parseFrame(const std::vector<uint8_t> &data,
-                                   Frame &frame) {
+std::vector<uint8_t> ProtocolProcessor::packSlave2MasterMessageSingle(
+    uint32_t slaveId, const Message &message, uint8_t fragmentsSequence,
+    uint8_t moreFragmentsFlag) const {
+    std::vector<uint8_t> frame(
+        packedFrameSize(PacketId::SLAVE_TO_MASTER, message));
+    frame.resize(packSlave2MasterMessageInto(slaveId, message, frame.data(),
+                                             frame.size(), fragmentsSequence,
+                                             moreFragmentsFlag));
+    return frame;
+}
+
+std::vector<uint8_t> ProtocolProcessor::packSlave2BackendMessageSingle(
+    uint32_t slaveId, const DeviceStatus &deviceStatus, const Message &message,
+    uint8_t fragmentsSequence, uint8_t moreFragmentsFlag) const {
+    std::vector<uint8_t> frame(
+        packedFrameSize(PacketId::SLAVE_TO_BACKEND, message));
+    frame.resize(packSlave2BackendMessageInto(
+        slaveId, deviceStatus, message, frame.data(), frame.size(),
+        fragmentsSequence, moreFragmentsFlag));
+    return frame;
+}
+
+std::vector<uint8_t>
+ProtocolProcessor::packBackend2MasterMessageSingle(
+    const Message &message, uint8_t fragmentsSequence,
+    uint8_t moreFragmentsFlag) const {
+    std::vector<uint8_t> frame(
+        packedFrameSize(PacketId::BACKEND_TO_MASTER, message));
+    frame.resize(packBackend2MasterMessageInto(message, frame.data(),
+                                               frame.size(), fragmentsSequence,
+                                               moreFragmentsFlag));
+    return frame;
+}
+
+std::vector<uint8_t>
+ProtocolProcessor::packMaster2BackendMessageSingle(
+    const Message &message, uint8_t fragmentsSequence,
+    uint8_t moreFragmentsFlag) const {
+    std::vector<uint8_t> frame(
+        packedFrameSize(PacketId::MASTER_TO_BACKEND, message));
+    frame.resize(packMaster2BackendMessageInto(message, frame.data(),
+                                               frame.size(), fragmentsSequence,
+                                               moreFragmentsFlag));
+    return frame;
+}
+
+bool ProtocolProcessor::parseFrame(ByteView data, Frame &frame) const {
     return Frame::deserialize(data, frame);
 }
 
-std::unique_ptr<Message> ProtocolProcessor::createMessage(PacketId packetId,
-                                                          uint8_t messageId) {
+bool ProtocolProcessor::parseFrame(ByteView data, FrameView &frame) const {
+    return FrameView::parse(data, frame);
+}
+
+std::unique_ptr<Message>
+ProtocolProcessor::createMessage(PacketId packetId, uint8_t messageId) const {
     switch (packetId) {
     case PacketId::MASTER_TO_SLAVE:
         switch (static_cast<Master2SlaveMessageId>(messageId)) {
@@ -286,7 +431,7 @@ std::unique_ptr<Message> ProtocolProcessor::createMessage(PacketId packetId,
 }
 
 std::unique_ptr<Message>
-ProtocolProcessor::createMessageFromId(uint8_t messageId) {
+ProtocolProcessor::createMessageFromId(uint8_t messageId) const {
     // This function is problematic because MessageIDs are not unique across
     // different PacketIds It should not be used. All parsing should use
     // createMessage(PacketId, messageId) instead. Keeping this function for
@@ -296,8 +441,8 @@ ProtocolProcessor::createMessageFromId(uint8_t messageId) {
 }
 
 bool ProtocolProcessor::parseMaster2SlavePacket(
-    const std::vector<uint8_t> &payload, uint32_t &destinationId,
-    std::unique_ptr<Message> &message) {
+    ByteView payload, uint32_t &destinationId,
+    std::unique_ptr<Message> &message) const {
     if (payload.size() < 5)
         return false;
 
@@ -308,13 +453,12 @@ bool ProtocolProcessor::parseMaster2SlavePacket(
     if (!message)
         return false;
 
-    std::vector<uint8_t> messageData(payload.begin() + 5, payload.end());
-    return message->deserialize(messageData);
+    return message->deserialize(payload.subview(5));
 }
 
 bool ProtocolProcessor::parseSlave2MasterPacket(
-    const std::vector<uint8_t> &payload, uint32_t &slaveId,
-    std::unique_ptr<Message> &message) {
+    ByteView payload, uint32_t &slaveId,
+    std::unique_ptr<Message> &message) const {
     if (payload.size() < 5)
         return false;
 
@@ -325,30 +469,28 @@ bool ProtocolProcessor::parseSlave2MasterPacket(
     if (!message)
         return false;
 
-    std::vector<uint8_t> messageData(payload.begin() + 5, payload.end());
-    return message->deserialize(messageData);
+    return message->deserialize(payload.subview(5));
 }
 
 bool ProtocolProcessor::parseSlave2BackendPacket(
-    const std::vector<uint8_t> &payload, uint32_t &slaveId,
-    DeviceStatus &deviceStatus, std::unique_ptr<Message> &message) {
+    ByteView payload, uint32_t &slaveId, DeviceStatus &deviceStatus,
+    std::unique_ptr<Message> &message) const {
     if (payload.size() < 7)
         return false;
 
     uint8_t messageId = payload[0];
     slaveId = readUint32LE(payload, 1);
-    deviceStatus.fromUint16(readUint16LE(payload, 5));
+    deviceStatus = DeviceStatus(readUint16LE(payload, 5));
 
     message = createMessage(PacketId::SLAVE_TO_BACKEND, messageId);
     if (!message)
         return false;
 
-    std::vector<uint8_t> messageData(payload.begin() + 7, payload.end());
-    return message->deserialize(messageData);
+    return message->deserialize(payload.subview(7));
 }
 
 bool ProtocolProcessor::parseBackend2MasterPacket(
-    const std::vector<uint8_t> &payload, std::unique_ptr<Message> &message) {
+    ByteView payload, std::unique_ptr<Message> &message) const {
     if (payload.size() < 1)
         return false;
 
@@ -358,12 +500,11 @@ bool ProtocolProcessor::parseBackend2MasterPacket(
     if (!message)
         return false;
 
-    std::vector<uint8_t> messageData(payload.begin() + 1, payload.end());
-    return message->deserialize(messageData);
+    return message->deserialize(payload.subview(1));
 }
 
 bool ProtocolProcessor::parseMaster2BackendPacket(
-    const std::vector<uint8_t> &payload, std::unique_ptr<Message> &message) {
+    ByteView payload, std::unique_ptr<Message> &message) const {
     if (payload.size() < 1)
         return false;
 
@@ -373,31 +514,260 @@ bool ProtocolProcessor::parseMaster2BackendPacket(
     if (!message)
         return false;
 
-    std::vector<uint8_t> messageData(payload.begin() + 1, payload.end());
-    return message->deserialize(messageData);
+    return message->deserialize(payload.subview(1));
+}
+
+// 零拷贝解析 - 解码到调用方提供的消息对象
+bool ProtocolProcessor::parseMaster2SlavePacket(ByteView payload,
+                                                uint32_t &destinationId,
+                                                Message &message) const {
+    if (payload.size() < 5 || payload[0] != message.getMessageId())
+        return false;
+
+    destinationId = readUint32LE(payload, 1);
+    return message.deserialize(payload.subview(5));
+}
+
+bool ProtocolProcessor::parseSlave2MasterPacket(ByteView payload,
+                                                uint32_t &slaveId,
+                                                Message &message) const {
+    if (payload.size() < 5 || payload[0] != message.getMessageId())
+        return false;
+
+    slaveId = readUint32LE(payload, 1);
+    return message.deserialize(payload.subview(5));
+}
+
+bool ProtocolProcessor::parseSlave2BackendPacket(ByteView payload,
+                                                 uint32_t &slaveId,
+                                                 DeviceStatus &deviceStatus,
+                                                 Message &message) const {
+    if (payload.size() < 7 || payload[0] != message.getMessageId())
+        return false;
+
+    slaveId = readUint32LE(payload, 1);
+    deviceStatus = DeviceStatus(readUint16LE(payload, 5));
+    return message.deserialize(payload.subview(7));
+}
+
+bool ProtocolProcessor::parseBackend2MasterPacket(ByteView payload,
+                                                  Message &message) const {
+    if (payload.size() < 1 || payload[0] != message.getMessageId())
+        return false;
+
+    return message.deserialize(payload.subview(1));
+}
+
+bool ProtocolProcessor::parseMaster2BackendPacket(ByteView payload,
+                                                  Message &message) const {
+    if (payload.size() < 1 || payload[0] != message.getMessageId())
+        return false;
+
+    return message.deserialize(payload.subview(1));
+}
+
+namespace {
+// 解码为变体中的指定类型，变体已持有该类型时原地复用
+template <typename T, typename Variant>
+bool decodeAs(Variant &message, ByteView body) {
+    if (auto *existing = std::get_if<T>(&message))
+        return existing->deserialize(body);
+    return message.template emplace<T>().deserialize(body);
+}
+
+bool decodeMessage(uint8_t messageId, ByteView body,
+                   Master2SlaveVariant &message) {
+    switch (static_cast<Master2SlaveMessageId>(messageId)) {
+    case Master2SlaveMessageId::SYNC_MSG:
+        return decodeAs<Master2Slave::SyncMessage>(message, body);
+    case Master2SlaveMessageId::CONDUCTION_CFG_MSG:
+        return decodeAs<Master2Slave::ConductionConfigMessage>(message, body);
+    case Master2SlaveMessageId::RESISTANCE_CFG_MSG:
+        return decodeAs<Master2Slave::ResistanceConfigMessage>(message, body);
+    case Master2SlaveMessageId::CLIP_CFG_MSG:
+        return decodeAs<Master2Slave::ClipConfigMessage>(message, body);
+    case Master2SlaveMessageId::READ_COND_DATA_MSG:
+        return decodeAs<Master2Slave::ReadConductionDataMessage>(message,
+                                                                 body);
+    case Master2SlaveMessageId::READ_RES_DATA_MSG:
+        return decodeAs<Master2Slave::ReadResistanceDataMessage>(message,
+                                                                 body);
+    case Master2SlaveMessageId::READ_CLIP_DATA_MSG:
+        return decodeAs<Master2Slave::ReadClipDataMessage>(message, body);
+    case Master2SlaveMessageId::RST_MSG:
+        return decodeAs<Master2Slave::RstMessage>(message, body);
+    case Master2SlaveMessageId::PING_REQ_MSG:
+        return decodeAs<Master2Slave::PingReqMessage>(message, body);
+    case Master2SlaveMessageId::SHORT_ID_ASSIGN_MSG:
+        return decodeAs<Master2Slave::ShortIdAssignMessage>(message, body);
+    }
+    message.template emplace<std::monostate>();
+    return false;
+}
+
+bool decodeMessage(uint8_t messageId, ByteView body,
+                   Slave2MasterVariant &message) {
+    switch (static_cast<Slave2MasterMessageId>(messageId)) {
+    case Slave2MasterMessageId::CONDUCTION_CFG_RSP_MSG:
+        return decodeAs<Slave2Master::ConductionConfigResponseMessage>(message,
+                                                                       body);
+    case Slave2MasterMessageId::RESISTANCE_CFG_RSP_MSG:
+        return decodeAs<Slave2Master::ResistanceConfigResponseMessage>(message,
+                                                                       body);
+    case Slave2MasterMessageId::CLIP_CFG_RSP_MSG:
+        return decodeAs<Slave2Master::ClipConfigResponseMessage>(message, body);
+    case Slave2MasterMessageId::RST_RSP_MSG:
+        return decodeAs<Slave2Master::RstResponseMessage>(message, body);
+    case Slave2MasterMessageId::PING_RSP_MSG:
+        return decodeAs<Slave2Master::PingRspMessage>(message, body);
+    case Slave2MasterMessageId::ANNOUNCE_MSG:
+        return decodeAs<Slave2Master::AnnounceMessage>(message, body);
+    case Slave2MasterMessageId::SHORT_ID_CONFIRM_MSG:
+        return decodeAs<Slave2Master::ShortIdConfirmMessage>(message, body);
+    }
+    message.template emplace<std::monostate>();
+    return false;
+}
+
+bool decodeMessage(uint8_t messageId, ByteView body,
+                   Slave2BackendVariant &message) {
+    switch (static_cast<Slave2BackendMessageId>(messageId)) {
+    case Slave2BackendMessageId::CONDUCTION_DATA_MSG:
+        return decodeAs<Slave2Backend::ConductionDataMessage>(message, body);
+    case Slave2BackendMessageId::RESISTANCE_DATA_MSG:
+        return decodeAs<Slave2Backend::ResistanceDataMessage>(message, body);
+    case Slave2BackendMessageId::CLIP_DATA_MSG:
+        return decodeAs<Slave2Backend::ClipDataMessage>(message, body);
+    }
+    message.template emplace<std::monostate>();
+    return false;
+}
+
+bool decodeMessage(uint8_t messageId, ByteView body,
+                   Backend2MasterVariant &message) {
+    switch (static_cast<Backend2MasterMessageId>(messageId)) {
+    case Backend2MasterMessageId::SLAVE_CFG_MSG:
+        return decodeAs<Backend2Master::SlaveConfigMessage>(message, body);
+    case Backend2MasterMessageId::MODE_CFG_MSG:
+        return decodeAs<Backend2Master::ModeConfigMessage>(message, body);
+    case Backend2MasterMessageId::SLAVE_RST_MSG:
+        return decodeAs<Backend2Master::RstMessage>(message, body);
+    case Backend2MasterMessageId::CTRL_MSG:
+        return decodeAs<Backend2Master::CtrlMessage>(message, body);
+    case Backend2MasterMessageId::PING_CTRL_MSG:
+        return decodeAs<Backend2Master::PingCtrlMessage>(message, body);
+    case Backend2MasterMessageId::DEVICE_LIST_REQ_MSG:
+        return decodeAs<Backend2Master::DeviceListReqMessage>(message, body);
+    }
+    message.template emplace<std::monostate>();
+    return false;
+}
+
+bool decodeMessage(uint8_t messageId, ByteView body,
+                   Master2BackendVariant &message) {
+    switch (static_cast<Master2BackendMessageId>(messageId)) {
+    case Master2BackendMessageId::SLAVE_CFG_RSP_MSG:
+        return decodeAs<Master2Backend::SlaveConfigResponseMessage>(message,
+                                                                    body);
+    case Master2BackendMessageId::MODE_CFG_RSP_MSG:
+        return decodeAs<Master2Backend::ModeConfigResponseMessage>(message,
+                                                                   body);
+    case Master2BackendMessageId::RST_RSP_MSG:
+        return decodeAs<Master2Backend::RstResponseMessage>(message, body);
+    case Master2BackendMessageId::CTRL_RSP_MSG:
+        return decodeAs<Master2Backend::CtrlResponseMessage>(message, body);
+    case Master2BackendMessageId::PING_RES_MSG:
+        return decodeAs<Master2Backend::PingResponseMessage>(message, body);
+    case Master2BackendMessageId::DEVICE_LIST_RSP_MSG:
+        return decodeAs<Master2Backend::DeviceListResponseMessage>(message,
+                                                                   body);
+    }
+    message.template emplace<std::monostate>();
+    return false;
+}
+} // namespace
+
+bool ProtocolProcessor::parseMaster2SlavePacket(
+    ByteView payload, uint32_t &destinationId,
+    Master2SlaveVariant &message) const {
+    if (payload.size() < 5)
+        return false;
+
+    destinationId = readUint32LE(payload, 1);
+    return decodeMessage(payload[0], payload.subview(5), message);
+}
+
+bool ProtocolProcessor::parseSlave2MasterPacket(
+    ByteView payload, uint32_t &slaveId, Slave2MasterVariant &message) const {
+    if (payload.size() < 5)
+        return false;
+
+    slaveId = readUint32LE(payload, 1);
+    return decodeMessage(payload[0], payload.subview(5), message);
+}
+
+bool ProtocolProcessor::parseSlave2BackendPacket(
+    ByteView payload, uint32_t &slaveId, DeviceStatus &deviceStatus,
+    Slave2BackendVariant &message) const {
+    if (payload.size() < 7)
+        return false;
+
+    slaveId = readUint32LE(payload, 1);
+    deviceStatus = DeviceStatus(readUint16LE(payload, 5));
+    return decodeMessage(payload[0], payload.subview(7), message);
+}
+
+bool ProtocolProcessor::parseBackend2MasterPacket(
+    ByteView payload, Backend2MasterVariant &message) const {
+    if (payload.size() < 1)
+        return false;
+
+    return decodeMessage(payload[0], payload.subview(1), message);
+}
+
+bool ProtocolProcessor::parseMaster2BackendPacket(
+    ByteView payload, Master2BackendVariant &message) const {
+    if (payload.size() < 1)
+        return false;
+
+    return decodeMessage(payload[0], payload.subview(1), message);
+}
+
+bool ProtocolProcessor::peekMessageId(ByteView payload, uint8_t &messageId) {
+    if (payload.empty())
+        return false;
+
+    messageId = payload[0];
+    return true;
 }
 
 // 支持自动分片的打包函数
 std::vector<std::vector<uint8_t>>
 ProtocolProcessor::packMaster2SlaveMessage(uint32_t destinationId,
-                                           const Message &message) {
+                                           const Message &message) const {
+    // 按目标从机的协商档案确定帧格式
+    WireFormat format = formatFor(destinationId);
+
     // 首先生成单个完整帧
-    auto completeFrame =
-        packMaster2SlaveMessageSingle(destinationId, message, 0, 0);
+    std::vector<uint8_t> completeFrame(
+        frameSize(PacketId::MASTER_TO_SLAVE, message, format.checksumType));
+    completeFrame.resize(packMaster2SlaveInto(
+        destinationId, message, completeFrame.data(), completeFrame.size(), 0,
+        0, format.checksumType));
 
     // 检查是否需要分片
-    if (completeFrame.size() <= mtu_) {
+    if (completeFrame.size() <= format.mtu) {
         // 不需要分片，直接返回
         return {completeFrame};
     }
 
     // 需要分片
-    return fragmentFrame(completeFrame);
+    return fragmentFrame(completeFrame, format);
 }
 
 std::vector<std::vector<uint8_t>>
 ProtocolProcessor::packSlave2MasterMessage(uint32_t slaveId,
-                                           const Message &message) {
+                                           const Message &message) const {
     // 首先生成单个完整帧
     auto completeFrame = packSlave2MasterMessageSingle(slaveId, message, 0, 0);
 
@@ -408,13 +778,13 @@ ProtocolProcessor::packSlave2MasterMessage(uint32_t slaveId,
     }
 
     // 需要分片
-    return fragmentFrame(completeFrame);
+    return fragmentFrame(completeFrame, defaultFormat());
 }
 
 std::vector<std::vector<uint8_t>>
 ProtocolProcessor::packSlave2BackendMessage(uint32_t slaveId,
                                             const DeviceStatus &deviceStatus,
-                                            const Message &message) {
+                                            const Message &message) const {
     // 首先生成单个完整帧
     auto completeFrame =
         packSlave2BackendMessageSingle(slaveId, deviceStatus, message, 0, 0);
@@ -426,11 +796,11 @@ ProtocolProcessor::packSlave2BackendMessage(uint32_t slaveId,
     }
 
     // 需要分片
-    return fragmentFrame(completeFrame);
+    return fragmentFrame(completeFrame, defaultFormat());
 }
 
 std::vector<std::vector<uint8_t>>
-ProtocolProcessor::packBackend2MasterMessage(const Message &message) {
+ProtocolProcessor::packBackend2MasterMessage(const Message &message) const {
     // 首先生成单个完整帧
     auto completeFrame = packBackend2MasterMessageSingle(message, 0, 0);
 
@@ -441,11 +811,11 @@ ProtocolProcessor::packBackend2MasterMessage(const Message &message) {
     }
 
     // 需要分片
-    return fragmentFrame(completeFrame);
+    return fragmentFrame(completeFrame, defaultFormat());
 }
 
 std::vector<std::vector<uint8_t>>
-ProtocolProcessor::packMaster2BackendMessage(const Message &message) {
+ProtocolProcessor::packMaster2BackendMessage(const Message &message) const {
     // 首先生成单个完整帧
     auto completeFrame = packMaster2BackendMessageSingle(message, 0, 0);
 
@@ -456,412 +826,269 @@ ProtocolProcessor::packMaster2BackendMessage(const Message &message) {
     }
 
     // 需要分片
-    return fragmentFrame(completeFrame);
+    return fragmentFrame(completeFrame, defaultFormat());
 }
 
-// 分片功能实现
-std::vector<std::vector<uint8_t>>
-ProtocolProcessor::fragmentFrame(const std::vector<uint8_t> &frameData) {
-    std::vector<std::vector<uint8_t>> fragments;
-
-    Log::i("ProtocolProcessor",
-           "Starting frame fragmentation, original frame size: %zu bytes, MTU: "
-           "%zu",
-           frameData.size(), mtu_);
-
-    if (frameData.size() < 7) { // Minimum frame header is 7 bytes
-        Log::w("ProtocolProcessor",
-               "Frame data too small for fragmentation: %zu bytes",
-               frameData.size());
-        return {frameData};
-    }
-
-    // Parse original frame header
-    uint8_t packetId = frameData[2];
-    Log::d("ProtocolProcessor", "Original frame PacketId: 0x%02X", packetId);
-
-    // Calculate effective payload size per fragment (MTU - 7 bytes frame
-    // header)
-    size_t fragmentPayloadSize = mtu_ - 7;
-    Log::d("ProtocolProcessor", "Maximum payload size per fragment: %zu bytes",
-           fragmentPayloadSize);
-
-    // Get original payload (starting from 7th byte)
-    std::vector<uint8_t> originalPayload(frameData.begin() + 7,
-                                         frameData.end());
-    Log::d("ProtocolProcessor", "Original payload size: %zu bytes",
-           originalPayload.size());
-
-    // Calculate how many fragments are needed
-    uint8_t totalFragments = static_cast<uint8_t>(
-        (originalPayload.size() + fragmentPayloadSize - 1) /
-        fragmentPayloadSize);
-    Log::i("ProtocolProcessor", "Total fragments needed: %d", totalFragments);
-
-    // Generate each fragment
-    for (uint8_t i = 0; i < totalFragments; ++i) {
-        std::vector<uint8_t> fragment;
-
-        // Add frame header
-        fragment.push_back(FRAME_DELIMITER_1);
-        fragment.push_back(FRAME_DELIMITER_2);
-        fragment.push_back(packetId);
-        fragment.push_back(i); // Fragment sequence number
-        fragment.push_back((i == totalFragments - 1) ? 0
-                                                     : 1); // moreFragmentsFlag
-
-        // Calculate payload for this fragment
-        size_t startPos = i * fragmentPayloadSize;
-        size_t endPos =
-            std::min(startPos + fragmentPayloadSize, originalPayload.size());
-        size_t fragmentSize = endPos - startPos;
-
-        // Add length field
-        fragment.push_back(fragmentSize & 0xFF);
-        fragment.push_back((fragmentSize >> 8) & 0xFF);
+// 分散-聚集打包: 直接序列化到 out.buffer，再生成引用该缓冲区的分片描述符
+bool ProtocolProcessor::packMaster2SlaveMessageGather(uint32_t destinationId,
+                                                      const Message &message,
+                                                      GatherFrames &out) const {
+    WireFormat format = formatFor(destinationId);
+    out.buffer.resize(
+        frameSize(PacketId::MASTER_TO_SLAVE, message, format.checksumType));
+    return finishGather(packMaster2SlaveInto(destinationId, message,
+                                             out.buffer.data(),
+                                             out.buffer.size(), 0, 0,
+                                             format.checksumType),
+                        out, format);
+}
 
-        // Add fragment payload
-        fragment.insert(fragment.end(), originalPayload.begin() + startPos,
-                        originalPayload.begin() + endPos);
+bool ProtocolProcessor::packSlave2MasterMessageGather(uint32_t slaveId,
+                                                      const Message &message,
+                                                      GatherFrames &out) const {
+    out.buffer.resize(packedFrameSize(PacketId::SLAVE_TO_MASTER, message));
+    return finishGather(packSlave2MasterMessageInto(slaveId, message,
+                                                    out.buffer.data(),
+                                                    out.buffer.size()),
+                        out, defaultFormat());
+}
 
-        Log::d("ProtocolProcessor",
-               "Fragment #%d/%d, sequence=%d, more_fragments=%d, "
-               "fragment_size=%zu, payload_size=%zu",
-               i, totalFragments - 1, i, (i == totalFragments - 1) ? 0 : 1,
-               fragment.size(), fragmentSize);
+bool ProtocolProcessor::packSlave2BackendMessageGather(
+    uint32_t slaveId, const DeviceStatus &deviceStatus, const Message &message,
+    GatherFrames &out) const {
+    out.buffer.resize(packedFrameSize(PacketId::SLAVE_TO_BACKEND, message));
+    return finishGather(packSlave2BackendMessageInto(
+                            slaveId, deviceStatus, message, out.buffer.data(),
+                            out.buffer.size()),
+                        out, defaultFormat());
+}
 
-        fragments.push_back(fragment);
-    }
+bool ProtocolProcessor::packBackend2MasterMessageGather(
+    const Message &message, GatherFrames &out) const {
+    out.buffer.resize(packedFrameSize(PacketId::BACKEND_TO_MASTER, message));
+    return finishGather(packBackend2MasterMessageInto(
+                            message, out.buffer.data(), out.buffer.size()),
+                        out, defaultFormat());
+}
 
-    Log::i("ProtocolProcessor",
-           "Fragmentation completed, generated %zu fragments",
-           fragments.size());
-    return fragments;
+bool ProtocolProcessor::packMaster2BackendMessageGather(
+    const Message &message, GatherFrames &out) const {
+    out.buffer.resize(packedFrameSize(PacketId::MASTER_TO_BACKEND, message));
+    return finishGather(packMaster2BackendMessageInto(
+                            message, out.buffer.data(), out.buffer.size()),
+                        out, defaultFormat());
 }
 
-// Process received raw data (supports packet concatenation handling)
-void ProtocolProcessor::processReceivedData(const std::vector<uint8_t> &data) {
-    Log::i("ProtocolProcessor",
-           "Received new data, size: %zu bytes, prefix: %s", data.size(),
-           bytesToHexString(data, 8).c_str());
-
-    // Prevent receive buffer from becoming too large
-    if (receiveBuffer_.size() + data.size() > MAX_RECEIVE_BUFFER_SIZE) {
-        Log::w("ProtocolProcessor",
-               "Receive buffer will exceed maximum limit, clearing buffer. "
-               "Current size: %zu, new data size: %zu, max limit: %zu",
-               receiveBuffer_.size(), data.size(), MAX_RECEIVE_BUFFER_SIZE);
-        // Clear buffer to prevent memory overflow
-        receiveBuffer_.clear();
+bool ProtocolProcessor::finishGather(size_t written, GatherFrames &out,
+                                     const WireFormat &format) const {
+    out.fragments.clear();
+    if (written == 0) {
+        out.buffer.clear();
+        return false;
     }
+    out.buffer.resize(written);
+    return describeFragments(ByteView(out.buffer), out.fragments, format);
+}
 
-    // Add new data to receive buffer
-    receiveBuffer_.insert(receiveBuffer_.end(), data.begin(), data.end());
-    Log::d("ProtocolProcessor", "Current receive buffer size: %zu bytes",
-           receiveBuffer_.size());
-
-    // Try to extract complete frames from buffer
-    bool framesExtracted = extractCompleteFrames();
-    Log::d("ProtocolProcessor", "Frame extraction result: %s",
-           framesExtracted ? "frames found" : "no frames found");
-
-    // Clean up expired fragments
-    cleanupExpiredFragments();
-}
-
-// Extract complete frames from receive buffer
-bool ProtocolProcessor::extractCompleteFrames() {
-    bool foundFrames = false;
-    size_t pos = 0;
-
-    Log::d(
-        "ProtocolProcessor",
-        "Starting frame extraction from receive buffer, buffer size: %zu bytes",
-        receiveBuffer_.size());
-
-    while (pos < receiveBuffer_.size()) {
-        // Find frame header
-        size_t frameStart = findFrameHeader(receiveBuffer_, pos);
-        if (frameStart == SIZE_MAX) {
-            Log::d("ProtocolProcessor",
-                   "No frame header found, skipping current data");
-            break; // No frame header found
-        }
+// 批量打包: 未超过MTU的帧直接写入 arena，超过MTU的帧先写入暂存区再分片追加
+bool ProtocolProcessor::packMaster2SlaveBatch(
+    const Master2SlaveBatchEntry *entries, size_t count,
+    PackedBatch &out) const {
+    // 整批使用同一份档案快照
+    auto profiles = loadProfiles();
 
-        Log::d("ProtocolProcessor", "Frame header found at position: %zu",
-               frameStart);
+    size_t estimate = out.arena.size();
+    for (size_t i = 0; i < count; ++i) {
+        estimate += frameSize(
+            PacketId::MASTER_TO_SLAVE, *entries[i].message,
+            formatFor(*profiles, entries[i].destinationId).checksumType);
+    }
+    out.arena.reserve(estimate);
+    out.offsets.reserve(out.offsets.size() + count);
 
-        // Check if there's enough data to read frame length
-        if (frameStart + 7 > receiveBuffer_.size()) {
-            Log::d("ProtocolProcessor", "Insufficient data to read frame "
-                                        "length, waiting for more data");
-            break; // Not enough data, wait for more
+    for (size_t i = 0; i < count; ++i) {
+        const Message &message = *entries[i].message;
+        uint32_t destinationId = entries[i].destinationId;
+        WireFormat format = formatFor(*profiles, destinationId);
+        size_t size = frameSize(PacketId::MASTER_TO_SLAVE, message,
+                                format.checksumType);
+
+        if (size <= format.mtu) {
+            size_t start = out.arena.size();
+            out.arena.resize(start + size);
+            size_t written = packMaster2SlaveInto(
+                destinationId, message, out.arena.data() + start, size, 0, 0,
+                format.checksumType);
+            out.arena.resize(start + written);
+            if (written == 0)
+                return false;
+            out.offsets.push_back(out.arena.size());
+            continue;
         }
 
-        // 读取帧长度
-        uint16_t frameLength = readUint16LE(receiveBuffer_, frameStart + 5);
-        size_t totalFrameSize = 7 + frameLength;
-
-        Log::d("ProtocolProcessor",
-               "Frame payload length: %d, total frame size: %zu", frameLength,
-               totalFrameSize);
-
-        // 检查是否有完整的帧
-        if (frameStart + totalFrameSize > receiveBuffer_.size()) {
-            Log::d(
-                "ProtocolProcessor",
-                "Incomplete frame, waiting for more data. Need: %zu, have: %zu",
-                frameStart + totalFrameSize, receiveBuffer_.size());
-            break; // 帧不完整，等待更多数据
-        }
+        // 暂存区按线程保留容量，并发打包互不影响
+        static thread_local std::vector<uint8_t> scratch;
+        scratch.resize(size);
+        size_t written =
+            packMaster2SlaveInto(destinationId, message, scratch.data(),
+                                 scratch.size(), 0, 0, format.checksumType);
+        if (written == 0 ||
+            !appendToBatch(ByteView(scratch.data(), written), out, format))
+            return false;
+    }
 
-        // 提取完整帧数据
-        std::vector<uint8_t> frameData(receiveBuffer_.begin() + frameStart,
-                                       receiveBuffer_.begin() + frameStart +
-                                           totalFrameSize);
-
-        Log::i(
-            "ProtocolProcessor",
-            "Extracted complete frame data, size: %zu bytes, frame prefix: %s",
-            frameData.size(), bytesToHexString(frameData, 16).c_str());
-
-        // 解析帧
-        Frame frame;
-        if (Frame::deserialize(frameData, frame)) {
-            Log::i(
-                "ProtocolProcessor",
-                "Frame parsed successfully, PacketId: 0x%02X, "
-                "fragment_sequence: %d, more_fragments: %d, payload_length: %d",
-                frame.packetId, frame.fragmentsSequence,
-                frame.moreFragmentsFlag, frame.packetLength);
-
-            // 检查是否是分片
-            if (frame.moreFragmentsFlag || frame.fragmentsSequence > 0) {
-                Log::i("ProtocolProcessor",
-                       "Fragment frame detected, starting fragment reassembly");
-                // 处理分片重组
-                std::vector<uint8_t> completeFrame;
-                if (reassembleFragments(frame, completeFrame)) {
-                    Log::i("ProtocolProcessor",
-                           "Fragment reassembly completed, reassembled frame "
-                           "size: %zu bytes",
-                           completeFrame.size());
-                    // 分片重组完成，解析完整帧
-                    Frame completedFrame;
-                    if (Frame::deserialize(completeFrame, completedFrame)) {
-                        Log::i("ProtocolProcessor",
-                               "Reassembled frame parsed successfully, "
-                               "PacketId: 0x%02X, payload_length: %d",
-                               completedFrame.packetId,
-                               completedFrame.packetLength);
-                        completeFrames_.push(completedFrame);
-                        foundFrames = true;
-                    } else {
-                        Log::e("ProtocolProcessor",
-                               "Failed to parse reassembled frame");
-                    }
-                } else {
-                    Log::d("ProtocolProcessor",
-                           "Fragment reassembly not complete, waiting for more "
-                           "fragments");
-                }
-            } else {
-                Log::i("ProtocolProcessor",
-                       "Single complete frame, adding to complete frame queue");
-                // 单个完整帧
-                completeFrames_.push(frame);
-                foundFrames = true;
-            }
-        } else {
-            Log::e("ProtocolProcessor", "Frame parsing failed");
-        }
+    LOG_D("ProtocolProcessor",
+          "Packed %zu Master2Slave messages into %zu datagrams (%zu bytes)",
+          count, out.datagramCount(), out.arena.size());
+    return true;
+}
 
-        // 移动到下一个位置
-        pos = frameStart + totalFrameSize;
-        Log::d("ProtocolProcessor", "Moving to next position: %zu", pos);
-    }
+bool ProtocolProcessor::appendToBatch(ByteView frame, PackedBatch &out,
+                                      const WireFormat &format) const {
+    static thread_local std::vector<FragmentDescriptor> fragments;
+    if (!describeFragments(frame, fragments, format))
+        return false;
 
-    // 清理已处理的数据
-    if (pos > 0) {
-        Log::d("ProtocolProcessor",
-               "Cleaning processed data, from 0 to %zu, remaining %zu bytes",
-               pos, receiveBuffer_.size() - pos);
-        receiveBuffer_.erase(receiveBuffer_.begin(),
-                             receiveBuffer_.begin() + pos);
+    for (const auto &desc : fragments) {
+        size_t start = out.arena.size();
+        out.arena.resize(start + desc.size());
+        uint8_t *dst = out.arena.data() + start;
+        std::memcpy(dst, desc.header, desc.headerSize);
+        std::memcpy(dst + desc.headerSize, desc.payload.data(),
+                    desc.payload.size());
+        std::memcpy(dst + desc.headerSize + desc.payload.size(), desc.trailer,
+                    desc.trailerSize);
+        out.offsets.push_back(out.arena.size());
     }
-
-    return foundFrames;
+    return true;
 }
 
-// 查找帧头
-size_t ProtocolProcessor::findFrameHeader(const std::vector<uint8_t> &buffer,
-                                          size_t startPos) {
-    for (size_t i = startPos; i < buffer.size() - 1; ++i) {
-        if (buffer[i] == FRAME_DELIMITER_1 &&
-            buffer[i + 1] == FRAME_DELIMITER_2) {
-            return i;
-        }
-    }
-    return SIZE_MAX;
-}
-
-// 分片重组
-bool ProtocolProcessor::reassembleFragments(
-    const Frame &frame, std::vector<uint8_t> &completeFrame) {
-    Log::i("ProtocolProcessor",
-           "Starting fragment reassembly, fragment_sequence: %d, "
-           "more_fragments: %d",
-           frame.fragmentsSequence, frame.moreFragmentsFlag);
-
-    // 从帧载荷中提取源ID (假设载荷格式为: MessageId + SourceId + ...)
-    if (frame.payload.size() < 5) {
-        Log::e("ProtocolProcessor",
-               "Fragment payload too small to extract source ID, payload size: "
-               "%zu",
-               frame.payload.size());
-        return false; // 载荷太小
+// 分片功能实现
+// 超过MTU的帧按描述符逐个物化为独立的数据报
+std::vector<std::vector<uint8_t>>
+ProtocolProcessor::fragmentFrame(const std::vector<uint8_t> &frameData,
+                                 const WireFormat &format) const {
+    std::vector<FragmentDescriptor> descriptors;
+    if (!describeFragments(ByteView(frameData), descriptors, format))
+        return {};
+
+    std::vector<std::vector<uint8_t>> fragments;
+    fragments.reserve(descriptors.size());
+    for (const auto &desc : descriptors) {
+        std::vector<uint8_t> fragment(desc.size());
+        std::memcpy(fragment.data(), desc.header, desc.headerSize);
+        std::memcpy(fragment.data() + desc.headerSize, desc.payload.data(),
+                    desc.payload.size());
+        std::memcpy(fragment.data() + desc.headerSize + desc.payload.size(),
+                    desc.trailer, desc.trailerSize);
+        fragments.push_back(std::move(fragment));
     }
+    return fragments;
+}
 
-    uint8_t messageId = frame.payload[0];
-    uint32_t sourceId = readUint32LE(frame.payload, 1); // 跳过MessageId
-    uint64_t fragmentId = generateFragmentId(frame.packetId);
-
-    Log::d("ProtocolProcessor",
-           "Fragment info - MessageId: 0x%02X, SourceId: 0x%08X, generated "
-           "FragmentId: 0x%016llX",
-           messageId, sourceId, fragmentId);
-
-    // 查找或创建分片信息
-    auto &fragmentInfo = fragmentMap_[fragmentId];
-    fragmentInfo.packetId = frame.packetId;
-    fragmentInfo.timestamp =
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch())
-            .count();
-
-    // 存储分片数据
-    fragmentInfo.fragments[frame.fragmentsSequence] = frame.payload;
-    Log::d("ProtocolProcessor",
-           "Storing fragment data, sequence: %d, payload size: %zu, collected "
-           "fragments: %zu",
-           frame.fragmentsSequence, frame.payload.size(),
-           fragmentInfo.fragments.size());
-
-    // 如果这是最后一个分片，计算总分片数
-    if (frame.moreFragmentsFlag == 0) {
-        fragmentInfo.totalFragments = frame.fragmentsSequence + 1;
-        Log::i("ProtocolProcessor",
-               "Received last fragment, total fragments set to: %d",
-               fragmentInfo.totalFragments);
+// 每个分片载荷以分片子头开头，其后是原载荷的连续切片
+// 描述符只保存帧头、子头与校验尾，切片直接引用原帧，不拷贝载荷
+bool ProtocolProcessor::describeFragments(
+    ByteView frameData, std::vector<FragmentDescriptor> &fragments,
+    const WireFormat &format) const {
+    fragments.clear();
+
+    size_t mtu = format.mtu;
+    if (frameData.size() <= mtu) {
+        FragmentDescriptor whole;
+        whole.headerSize = 0;
+        whole.payload = frameData;
+        whole.trailerSize = 0;
+        fragments.push_back(whole);
+        return true;
     }
 
-    // 检查是否收集完所有分片
-    if (fragmentInfo.totalFragments > 0 && fragmentInfo.isComplete()) {
-        Log::i("ProtocolProcessor",
-               "All fragments collected, starting complete frame reassembly, "
-               "total fragments: %d",
-               fragmentInfo.totalFragments);
-
-        // 重组完整载荷
-        std::vector<uint8_t> completePayload;
-
-        // First add the complete payload of the first fragment
-        auto firstFragment = fragmentInfo.fragments.find(0);
-        if (firstFragment != fragmentInfo.fragments.end()) {
-            Log::d("ProtocolProcessor",
-                   "Adding first fragment complete payload, size: %zu",
-                   firstFragment->second.size());
-            completePayload.insert(completePayload.end(),
-                                   firstFragment->second.begin(),
-                                   firstFragment->second.end());
-        } else {
-            Log::e("ProtocolProcessor",
-                   "Critical error: missing first fragment (sequence 0)");
-            return false;
-        }
+    LOG_I("ProtocolProcessor",
+          "Starting frame fragmentation, original frame size: %zu bytes, MTU: "
+          "%zu",
+          frameData.size(), mtu);
 
-        // Then add the data portion of subsequent fragments
-        for (uint8_t i = 1; i < fragmentInfo.totalFragments; ++i) {
-            auto it = fragmentInfo.fragments.find(i);
-            if (it != fragmentInfo.fragments.end()) {
-                completePayload.insert(completePayload.end(),
-                                       it->second.begin(), it->second.end());
-            }
-        }
+    size_t trailerSize = checksumSize(format.checksumType);
+    if (mtu <= FRAME_HEADER_SIZE + FragmentHeader::SIZE + trailerSize) {
+        LOG_E("ProtocolProcessor", "MTU %zu too small for fragmentation", mtu);
+        return false;
+    }
 
-        Log::d("ProtocolProcessor", "Reassembled complete payload size: %zu",
-               completePayload.size());
-
-        // Build complete frame
-        completeFrame.clear();
-        completeFrame.push_back(FRAME_DELIMITER_1);
-        completeFrame.push_back(FRAME_DELIMITER_2);
-        completeFrame.push_back(frame.packetId);
-        completeFrame.push_back(0); // fragmentsSequence = 0
-        completeFrame.push_back(0); // moreFragmentsFlag = 0
-
-        // Add payload length
-        uint16_t payloadLength = static_cast<uint16_t>(completePayload.size());
-        completeFrame.push_back(payloadLength & 0xFF);
-        completeFrame.push_back((payloadLength >> 8) & 0xFF);
-
-        Log::d("ProtocolProcessor",
-               "Setting complete frame header, PacketId: 0x%02X, payload "
-               "length: %d",
-               frame.packetId, payloadLength);
-
-        // Add payload
-        completeFrame.insert(completeFrame.end(), completePayload.begin(),
-                             completePayload.end());
-
-        Log::i("ProtocolProcessor",
-               "Complete frame reassembly finished, total size: %zu bytes, "
-               "frame data prefix: %s",
-               completeFrame.size(),
-               bytesToHexString(completeFrame, 16).c_str());
-
-        // Clean up fragment information
-        fragmentMap_.erase(fragmentId);
-        Log::d("ProtocolProcessor",
-               "Cleaning fragment info, current fragment map size: %zu",
-               fragmentMap_.size());
+    // Parse original frame header
+    uint8_t packetId = frameData[2];
+    LOG_D("ProtocolProcessor", "Original frame PacketId: 0x%02X", packetId);
 
-        return true;
-    }
+    // 每个分片可携带的数据 = MTU - 帧头 - 分片子头 - 校验尾
+    size_t fragmentPayloadSize =
+        mtu - FRAME_HEADER_SIZE - FragmentHeader::SIZE - trailerSize;
+    LOG_D("ProtocolProcessor", "Maximum payload size per fragment: %zu bytes",
+          fragmentPayloadSize);
 
-    return false; // Haven't collected all fragments yet
-}
+    // 原载荷位于帧头之后 (原帧的校验尾不随分片发送，每个分片有自己的校验尾)
+    ByteView originalPayload = frameData.subview(
+        FRAME_HEADER_SIZE, readUint16LE(frameData, 5));
+    size_t payloadSize = originalPayload.size();
+    LOG_D("ProtocolProcessor", "Original payload size: %zu bytes",
+          payloadSize);
 
-// Get next complete frame
-bool ProtocolProcessor::getNextCompleteFrame(Frame &frame) {
-    if (completeFrames_.empty()) {
+    // Calculate how many fragments are needed
+    size_t totalFragments =
+        (payloadSize + fragmentPayloadSize - 1) / fragmentPayloadSize;
+    if (totalFragments > FragmentReassembler::MAX_FRAGMENTS) {
+        LOG_E("ProtocolProcessor",
+              "Payload of %zu bytes needs %zu fragments, exceeding the limit "
+              "of %zu",
+              payloadSize, totalFragments,
+              FragmentReassembler::MAX_FRAGMENTS);
         return false;
     }
+    LOG_I("ProtocolProcessor", "Total fragments needed: %zu", totalFragments);
 
-    frame = completeFrames_.front();
-    completeFrames_.pop();
-    return true;
-}
+    FragmentHeader header;
+    header.messageCounter =
+        fragmentCounter_.fetch_add(1, std::memory_order_relaxed);
+    header.totalLength = static_cast<uint16_t>(payloadSize);
 
-// Clear receive buffer
-void ProtocolProcessor::clearReceiveBuffer() {
-    receiveBuffer_.clear();
-    while (!completeFrames_.empty()) {
-        completeFrames_.pop();
+    fragments.resize(totalFragments);
+    for (size_t i = 0; i < totalFragments; ++i) {
+        size_t startPos = i * fragmentPayloadSize;
+        size_t fragmentSize =
+            std::min(fragmentPayloadSize, payloadSize - startPos);
+        uint16_t frameLength =
+            static_cast<uint16_t>(FragmentHeader::SIZE + fragmentSize);
+        uint8_t moreFragments = (i == totalFragments - 1) ? 0 : 1;
+
+        FragmentDescriptor &desc = fragments[i];
+        uint8_t *out = desc.header;
+        out[0] = FRAME_DELIMITER_1;
+        out[1] = FRAME_DELIMITER_2;
+        out[2] = packetId;
+        out[3] = static_cast<uint8_t>(i); // Fragment sequence number
+        out[4] = encodeFrameFlags(moreFragments, format.checksumType);
+        ByteUtils::storeUint16LE(out + 5, frameLength);
+
+        header.offset = static_cast<uint16_t>(startPos);
+        header.write(out + FRAME_HEADER_SIZE);
+        desc.headerSize = FragmentDescriptor::MAX_HEADER_SIZE;
+        desc.payload = originalPayload.subview(startPos, fragmentSize);
+
+        // 校验尾覆盖帧头、分片子头与分片数据
+        FrameChecksum checksum(format.checksumType);
+        checksum.update(ByteView(desc.header, desc.headerSize));
+        checksum.update(desc.payload);
+        desc.trailerSize = static_cast<uint8_t>(checksum.write(desc.trailer));
+
+        LOG_D("ProtocolProcessor",
+              "Fragment #%zu/%zu, message=%d, more_fragments=%d, "
+              "fragment_size=%zu, payload_size=%zu",
+              i, totalFragments - 1, header.messageCounter, moreFragments,
+              desc.size(), fragmentSize);
     }
-    fragmentMap_.clear();
-}
 
-// Generate fragment ID
-uint64_t ProtocolProcessor::generateFragmentId(uint8_t packetId) {
-    return packetId;
-}
-
-// Clean up expired fragments
-void ProtocolProcessor::cleanupExpiredFragments() {
-    // Fragment timeout cleanup is currently disabled
-    // This function can be implemented to clean up expired fragments
-    // based on timestamp if needed in the future
+    LOG_I("ProtocolProcessor",
+          "Fragmentation completed, generated %zu fragments",
+          fragments.size());
+    return true;
 }
 
 } // namespace WhtsProtocol
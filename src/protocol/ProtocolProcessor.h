@@ -1,30 +1,42 @@
 #ifndef PROTOCOL_PROCESSOR_H
 #define PROTOCOL_PROCESSOR_H
 
+#include "Capabilities.h"
 #include "Common.h"
 #include "DeviceStatus.h"
+#include "FragmentReassembler.h"
 #include "Frame.h"
+#include "FrameDecoder.h"
+#include "MessageVariant.h"
 #include "messages/Message.h"
+#include "utils/ByteView.h"
+#include "utils/SpscQueue.h"
+#include <atomic>
 #include <cstdint>
-#include <map>
 #include <memory>
-#include <queue>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace WhtsProtocol {
 
-// 分片相关的私有结构
-struct FragmentInfo {
-    uint8_t packetId;
-    uint32_t sourceId;
-    uint8_t totalFragments;
-    std::map<uint8_t, std::vector<uint8_t>> fragments; // 序号 -> 分片数据
-    uint64_t timestamp;                                // 用于超时处理
-
-    bool isComplete() const { return fragments.size() == totalFragments; }
+// 批量打包条目: 目标从机ID与消息 (消息需在打包期间保持有效)
+struct Master2SlaveBatchEntry {
+    uint32_t destinationId;
+    const Message *message;
 };
 
 // 协议处理器类
+// 线程约定:
+//   编码与解析 (pack*、parse*、createMessage 等 const 成员) 不修改共享状态
+//   (分片计数器为原子自增)，可以在任意多个线程中同时调用，无需加锁；
+//   setMTU / setChecksumType 属于配置，必须在并发使用之前完成；
+//   对端档案表 (setPeerProfile 等) 可以随时更新：更新时复制整表后原子地
+//   发布新快照 (写者之间加锁)，打包 Master2Slave 消息时只原子读取快照，
+//   编码路径不加锁；
+//   接收路径 (processReceivedData、getNextCompleteFrame 等) 由内部的
+//   FrameDecoder 处理，只能由一个线程调用，但可以与编码并发进行。
+// 因此网络线程接收、主循环发送可以共用同一个处理器，互不加锁。
 class ProtocolProcessor {
   public:
     ProtocolProcessor();
@@ -34,67 +46,165 @@ class ProtocolProcessor {
     void setMTU(size_t mtu) { mtu_ = mtu; }
     size_t getMTU() const { return mtu_; }
 
+    // 设置发送帧附带的校验尾类型 (默认不附带)
+    // 接收方按帧标志中声明的类型校验，无需配置；只有确认对端支持时才启用
+    void setChecksumType(ChecksumType type) { checksumType_ = type; }
+    ChecksumType getChecksumType() const { return checksumType_; }
+
+    // 对端协商档案 (见 Capabilities.h)
+    // 发往有档案的从机的 Master2Slave 帧使用档案中的MTU与校验尾，
+    // 其他帧使用 setMTU / setChecksumType 的默认配置
+    void setPeerProfile(uint32_t peerId, const PeerProfile &profile);
+    bool getPeerProfile(uint32_t peerId, PeerProfile &profile) const;
+    void removePeerProfile(uint32_t peerId);
+
+    // 所有有档案的对端中最小的帧长上限 (未协商MTU的按默认MTU计)
+    // 没有档案时返回默认MTU；广播给全部从机的数据报不应超过此值
+    size_t getMinPeerMTU() const;
+
+    // 因校验失败或标志非法而丢弃的帧数
+    uint32_t getChecksumErrorCount() const {
+        return decoder_.getChecksumErrorCount();
+    }
+
     // 打包Master2Slave消息 (支持自动分片)
     std::vector<std::vector<uint8_t>>
-    packMaster2SlaveMessage(uint32_t destinationId, const Message &message);
+    packMaster2SlaveMessage(uint32_t destinationId,
+                            const Message &message) const;
 
     // 打包Slave2Master消息 (支持自动分片)
     std::vector<std::vector<uint8_t>>
-    packSlave2MasterMessage(uint32_t slaveId, const Message &message);
+    packSlave2MasterMessage(uint32_t slaveId, const Message &message) const;
 
     // 打包Slave2Backend消息 (支持自动分片)
     std::vector<std::vector<uint8_t>>
     packSlave2BackendMessage(uint32_t slaveId, const DeviceStatus &deviceStatus,
-                             const Message &message);
+                             const Message &message) const;
 
     // 打包Backend2Master消息 (支持自动分片)
     std::vector<std::vector<uint8_t>>
-    packBackend2MasterMessage(const Message &message);
+    packBackend2MasterMessage(const Message &message) const;
 
     // 打包Master2Backend消息 (支持自动分片)
     std::vector<std::vector<uint8_t>>
-    packMaster2BackendMessage(const Message &message);
+    packMaster2BackendMessage(const Message &message) const;
 
     // 兼容旧接口 - 单帧打包
     std::vector<uint8_t> packMaster2SlaveMessageSingle(
         uint32_t destinationId, const Message &message,
-        uint8_t fragmentsSequence = 0, uint8_t moreFragmentsFlag = 0);
+        uint8_t fragmentsSequence = 0, uint8_t moreFragmentsFlag = 0) const;
 
     std::vector<uint8_t>
     packSlave2MasterMessageSingle(uint32_t slaveId, const Message &message,
                                   uint8_t fragmentsSequence = 0,
-                                  uint8_t moreFragmentsFlag = 0);
+                                  uint8_t moreFragmentsFlag = 0) const;
 
     std::vector<uint8_t> packSlave2BackendMessageSingle(
         uint32_t slaveId, const DeviceStatus &deviceStatus,
         const Message &message, uint8_t fragmentsSequence = 0,
-        uint8_t moreFragmentsFlag = 0);
+        uint8_t moreFragmentsFlag = 0) const;
 
     std::vector<uint8_t>
     packBackend2MasterMessageSingle(const Message &message,
                                     uint8_t fragmentsSequence = 0,
-                                    uint8_t moreFragmentsFlag = 0);
+                                    uint8_t moreFragmentsFlag = 0) const;
 
     std::vector<uint8_t>
     packMaster2BackendMessageSingle(const Message &message,
                                     uint8_t fragmentsSequence = 0,
-                                    uint8_t moreFragmentsFlag = 0);
-
-    // 处理接收到的原始数据 (支持粘包处理)
-    void processReceivedData(const std::vector<uint8_t> &data);
-
-    // 获取完整的已解析帧
-    bool getNextCompleteFrame(Frame &frame);
-
-    // 清空接收缓冲区
-    void clearReceiveBuffer();
+                                    uint8_t moreFragmentsFlag = 0) const;
+
+    // 计算消息打包为单帧后的总字节数 (帧头 + 载荷 + 校验尾)
+    // 按默认校验尾计算；Master2Slave 帧请使用 packedMaster2SlaveFrameSize
+    size_t packedFrameSize(PacketId packetId, const Message &message) const;
+
+    // 按目标从机协商的校验尾计算Master2Slave单帧总字节数
+    // 与 packMaster2SlaveMessageInto 写入的长度一致
+    size_t packedMaster2SlaveFrameSize(uint32_t destinationId,
+                                       const Message &message) const;
+
+    // 将单帧直接写入调用方提供的缓冲区 (帧头、Message ID、ID与消息体一次写入)
+    // 返回写入的字节数，缓冲区不足或载荷超出帧长度上限时返回0
+    size_t packMaster2SlaveMessageInto(uint32_t destinationId,
+                                       const Message &message, uint8_t *out,
+                                       size_t capacity,
+                                       uint8_t fragmentsSequence = 0,
+                                       uint8_t moreFragmentsFlag = 0) const;
+
+    size_t packSlave2MasterMessageInto(uint32_t slaveId,
+                                       const Message &message, uint8_t *out,
+                                       size_t capacity,
+                                       uint8_t fragmentsSequence = 0,
+                                       uint8_t moreFragmentsFlag = 0) const;
+
+    size_t packSlave2BackendMessageInto(uint32_t slaveId,
+                                        const DeviceStatus &deviceStatus,
+                                        const Message &message, uint8_t *out,
+                                        size_t capacity,
+                                        uint8_t fragmentsSequence = 0,
+                                        uint8_t moreFragmentsFlag = 0) const;
+
+    size_t packBackend2MasterMessageInto(const Message &message, uint8_t *out,
+                                         size_t capacity,
+                                         uint8_t fragmentsSequence = 0,
+                                         uint8_t moreFragmentsFlag = 0) const;
+
+    size_t packMaster2BackendMessageInto(const Message &message, uint8_t *out,
+                                         size_t capacity,
+                                         uint8_t fragmentsSequence = 0,
+                                         uint8_t moreFragmentsFlag = 0) const;
+
+    // 分散-聚集打包 (支持自动分片): 消息只序列化一次写入 out.buffer，
+    // out.fragments 中每个描述符为 (帧头+分片子头, 载荷切片)，
+    // 网络层可用 sendmsg/WSASendTo 直接发送而无需为每个分片拷贝
+    // out 在下次打包前保持有效，失败时返回false且 out.fragments 为空
+    bool packMaster2SlaveMessageGather(uint32_t destinationId,
+                                       const Message &message,
+                                       GatherFrames &out) const;
+    bool packSlave2MasterMessageGather(uint32_t slaveId,
+                                       const Message &message,
+                                       GatherFrames &out) const;
+    bool packSlave2BackendMessageGather(uint32_t slaveId,
+                                        const DeviceStatus &deviceStatus,
+                                        const Message &message,
+                                        GatherFrames &out) const;
+    bool packBackend2MasterMessageGather(const Message &message,
+                                         GatherFrames &out) const;
+    bool packMaster2BackendMessageGather(const Message &message,
+                                         GatherFrames &out) const;
+
+    // 批量打包 (支持自动分片): 所有消息的帧首尾相接写入 out.arena，
+    // out.offsets 记录每个数据报的边界，网络层可一次批量发送 (如 sendmmsg)
+    // 追加到 out 已有内容之后；任一消息打包失败时返回false，已打包的保留
+    bool packMaster2SlaveBatch(const Master2SlaveBatchEntry *entries,
+                               size_t count, PackedBatch &out) const;
+
+    // 接收路径 (转发到内部的 FrameDecoder，见线程约定)
+    // 多个接收线程或多个对端应各自持有独立的 FrameDecoder
+    FrameDecoder &decoder() { return decoder_; }
+
+    void processReceivedData(ByteView data, uint64_t senderKey = 0) {
+        decoder_.processReceivedData(data, senderKey);
+    }
+    bool getNextCompleteFrame(Frame &frame) {
+        return decoder_.getNextCompleteFrame(frame);
+    }
+    Frame *peekCompleteFrame() { return decoder_.peekCompleteFrame(); }
+    void popCompleteFrame() { decoder_.popCompleteFrame(); }
+    size_t drainCompleteFrames(SpscQueue<Frame> &queue) {
+        return decoder_.drainCompleteFrames(queue);
+    }
+    void clearReceiveBuffer() { decoder_.clear(); }
 
     // 解析单个帧
-    bool parseFrame(const std::vector<uint8_t> &data, Frame &frame);
+    bool parseFrame(ByteView data, Frame &frame) const;
+
+    // 解析单个帧视图 (不拷贝载荷)
+    bool parseFrame(ByteView data, FrameView &frame) const;
 
     // 根据Packet ID和Message ID创建对应的消息对象
     std::unique_ptr<Message> createMessage(PacketId packetId,
-                                           uint8_t messageId);
+                                           uint8_t messageId) const;
 
     // 根据Message ID创建对应的消息对象
     // WARNING: This function is deprecated and should not be used!
@@ -103,69 +213,137 @@ class ProtocolProcessor {
     // proper context.
     [[deprecated("Use createMessage(PacketId, messageId) instead - MessageIDs "
                  "are not unique across PacketIds")]]
-    std::unique_ptr<Message> createMessageFromId(uint8_t messageId);
+    std::unique_ptr<Message> createMessageFromId(uint8_t messageId) const;
 
     // 解析Master2Slave包
-    bool parseMaster2SlavePacket(const std::vector<uint8_t> &payload,
-                                 uint32_t &destinationId,
-                                 std::unique_ptr<Message> &message);
+    bool parseMaster2SlavePacket(ByteView payload, uint32_t &destinationId,
+                                 std::unique_ptr<Message> &message) const;
 
     // 解析Slave2Master包
-    bool parseSlave2MasterPacket(const std::vector<uint8_t> &payload,
-                                 uint32_t &slaveId,
-                                 std::unique_ptr<Message> &message);
+    bool parseSlave2MasterPacket(ByteView payload, uint32_t &slaveId,
+                                 std::unique_ptr<Message> &message) const;
 
     // 解析Slave2Backend包
-    bool parseSlave2BackendPacket(const std::vector<uint8_t> &payload,
-                                  uint32_t &slaveId, DeviceStatus &deviceStatus,
-                                  std::unique_ptr<Message> &message);
+    bool parseSlave2BackendPacket(ByteView payload, uint32_t &slaveId,
+                                  DeviceStatus &deviceStatus,
+                                  std::unique_ptr<Message> &message) const;
 
     // 解析Backend2Master包
-    bool parseBackend2MasterPacket(const std::vector<uint8_t> &payload,
-                                   std::unique_ptr<Message> &message);
+    bool parseBackend2MasterPacket(ByteView payload,
+                                   std::unique_ptr<Message> &message) const;
 
     // 解析Master2Backend包
-    bool parseMaster2BackendPacket(const std::vector<uint8_t> &payload,
-                                   std::unique_ptr<Message> &message);
+    bool parseMaster2BackendPacket(ByteView payload,
+                                   std::unique_ptr<Message> &message) const;
+
+    // 零拷贝解析: 直接从载荷视图解码到调用方提供的消息对象 (无堆分配)
+    // 载荷中的Message ID必须与message.getMessageId()一致，否则返回false
+    bool parseMaster2SlavePacket(ByteView payload, uint32_t &destinationId,
+                                 Message &message) const;
+    bool parseSlave2MasterPacket(ByteView payload, uint32_t &slaveId,
+                                 Message &message) const;
+    bool parseSlave2BackendPacket(ByteView payload, uint32_t &slaveId,
+                                  DeviceStatus &deviceStatus,
+                                  Message &message) const;
+    bool parseBackend2MasterPacket(ByteView payload, Message &message) const;
+    bool parseMaster2BackendPacket(ByteView payload, Message &message) const;
+
+    // 类型化解码: 按 PacketId 解码到对应的消息变体 (无堆分配、无RTTI)
+    // 变体已持有同类型消息时原地复用，保留其内部缓冲区容量
+    // 未知的Message ID会将变体置为 std::monostate 并返回false
+    bool parseMaster2SlavePacket(ByteView payload, uint32_t &destinationId,
+                                 Master2SlaveVariant &message) const;
+    bool parseSlave2MasterPacket(ByteView payload, uint32_t &slaveId,
+                                 Slave2MasterVariant &message) const;
+    bool parseSlave2BackendPacket(ByteView payload, uint32_t &slaveId,
+                                  DeviceStatus &deviceStatus,
+                                  Slave2BackendVariant &message) const;
+    bool parseBackend2MasterPacket(ByteView payload,
+                                   Backend2MasterVariant &message) const;
+    bool parseMaster2BackendPacket(ByteView payload,
+                                   Master2BackendVariant &message) const;
+
+    // 读取载荷中的Message ID (载荷为空时返回false)
+    static bool peekMessageId(ByteView payload, uint8_t &messageId);
 
   private:
-    // 帧分片
-    std::vector<std::vector<uint8_t>>
-    fragmentFrame(const std::vector<uint8_t> &frameData);
+    // 发送帧格式: 分片阈值与校验尾类型
+    struct WireFormat {
+        size_t mtu;
+        ChecksumType checksumType;
+    };
 
-    // 分片重组
-    bool reassembleFragments(const Frame &frame,
-                             std::vector<uint8_t> &completeFrame);
+    WireFormat defaultFormat() const { return {mtu_, checksumType_}; }
 
-    // 从接收缓冲区中提取完整帧
-    bool extractCompleteFrames();
+    // 对端档案表快照: 发布后不再修改，读取方无需加锁
+    using ProfileTable = std::unordered_map<uint32_t, PeerProfile>;
 
-    // 查找帧头
-    size_t findFrameHeader(const std::vector<uint8_t> &buffer, size_t startPos);
+    std::shared_ptr<const ProfileTable> loadProfiles() const {
+        return std::atomic_load(&profiles_);
+    }
 
-    // 工具函数
-    void writeUint16LE(std::vector<uint8_t> &buffer, uint16_t value);
-    void writeUint32LE(std::vector<uint8_t> &buffer, uint32_t value);
-    uint16_t readUint16LE(const std::vector<uint8_t> &buffer, size_t offset);
-    uint32_t readUint32LE(const std::vector<uint8_t> &buffer, size_t offset);
+    // 查找目标从机的帧格式 (没有协商档案时使用默认配置)
+    WireFormat formatFor(uint32_t peerId) const;
+    WireFormat formatFor(const ProfileTable &profiles, uint32_t peerId) const;
+
+    // 按指定校验尾类型计算单帧总字节数
+    static size_t frameSize(PacketId packetId, const Message &message,
+                            ChecksumType checksumType);
 
-    // 生成分片的唯一ID
-    uint64_t generateFragmentId(uint8_t packetId);
+    // 按指定校验尾类型将Master2Slave单帧写入缓冲区
+    static size_t packMaster2SlaveInto(uint32_t destinationId,
+                                       const Message &message, uint8_t *out,
+                                       size_t capacity,
+                                       uint8_t fragmentsSequence,
+                                       uint8_t moreFragmentsFlag,
+                                       ChecksumType checksumType);
 
-    // 清理超时的分片
-    void cleanupExpiredFragments();
+    // 帧分片
+    std::vector<std::vector<uint8_t>>
+    fragmentFrame(const std::vector<uint8_t> &frameData,
+                  const WireFormat &format) const;
+
+    // 生成完整帧的分片描述符 (仅写入帧头与分片子头，载荷为原帧切片)
+    // 帧不超过MTU时生成单个描述符指向整帧
+    bool describeFragments(ByteView frameData,
+                           std::vector<FragmentDescriptor> &fragments,
+                           const WireFormat &format) const;
+
+    // 完成分散-聚集打包: 按实际写入长度截断缓冲区并生成分片描述符
+    bool finishGather(size_t written, GatherFrames &out,
+                      const WireFormat &format) const;
+
+    // 将已打包的帧 (超过MTU时按分片) 追加为批量结果中的数据报
+    bool appendToBatch(ByteView frame, PackedBatch &out,
+                       const WireFormat &format) const;
+
+    // 写入帧头和Message ID，返回其后的写入位置 (各包类型的ID字段由调用方写入)
+    // 缓冲区不足或载荷超出帧长度上限时返回nullptr
+    static uint8_t *writeFrameHeader(uint8_t *out, size_t capacity,
+                                     PacketId packetId, const Message &message,
+                                     uint8_t fragmentsSequence,
+                                     uint8_t moreFragmentsFlag,
+                                     ChecksumType checksumType);
+
+    // 在 frame[0, size) 之后追加校验尾，返回帧总长度 (调用方已预留空间)
+    static size_t sealFrame(uint8_t *frame, size_t size,
+                            ChecksumType checksumType);
+
+    // 工具函数
+    uint16_t readUint16LE(ByteView buffer, size_t offset) const;
+    uint32_t readUint32LE(ByteView buffer, size_t offset) const;
 
   private:
-    size_t mtu_;                         // 最大传输单元大小，默认100字节
-    std::vector<uint8_t> receiveBuffer_; // 接收缓冲区
-    std::queue<Frame> completeFrames_;   // 完整帧队列
-    std::map<uint64_t, FragmentInfo> fragmentMap_; // 分片重组映射
+    size_t mtu_;                // 最大传输单元大小，默认100字节
+    ChecksumType checksumType_; // 发送帧的校验尾类型
+    // 分片消息计数器 (写入分片子头)，并发打包时原子自增
+    mutable std::atomic<uint8_t> fragmentCounter_;
+    std::mutex profilesMutex_; // 串行化档案更新 (只有写者加锁)
+    // 对端协商档案的当前快照，以 atomic_load / atomic_store 读写
+    std::shared_ptr<const ProfileTable> profiles_;
+    FrameDecoder decoder_; // 接收路径
 
-    static constexpr uint32_t FRAGMENT_TIMEOUT_MS =
-        5000;                                  // 分片超时时间（毫秒）
     static constexpr size_t DEFAULT_MTU = 100; // 默认MTU大小
-    static constexpr size_t MAX_RECEIVE_BUFFER_SIZE =
-        4096; // 最大接收缓冲区大小
 };
 
 } // namespace WhtsProtocol
@@ -2,9 +2,15 @@
 #define WHTS_PROTOCOL_H
 
 // 包含所有子模块
+#include "Capabilities.h"
 #include "Common.h"
 #include "DeviceStatus.h"
 #include "Frame.h"
+#include "FrameCoalescer.h"
+#include "FrameDecoder.h"
+#include "FrameQueue.h"
+#include "MessageVariant.h"
+#include "PeerDecoders.h"
 #include "ProtocolProcessor.h"
 
 // 消息模块
@@ -18,6 +24,8 @@
 
 // 工具模块
 #include "utils/ByteUtils.h"
+#include "utils/ByteView.h"
+#include "utils/FieldCodec.h"
 
 // 标准库依赖
 #include <map>
@@ -3,149 +3,62 @@
 namespace WhtsProtocol {
 namespace Backend2Master {
 
+// 线上长度校验: 字段布局变化时在编译期报错
+static_assert(ModeConfigMessage::Layout::size == 1,
+              "ModeConfigMessage wire size");
+static_assert(CtrlMessage::Layout::size == 1, "CtrlMessage wire size");
+static_assert(PingCtrlMessage::Layout::size == 9, "PingCtrlMessage wire size");
+static_assert(DeviceListReqMessage::Layout::size == 1,
+              "DeviceListReqMessage wire size");
+static_assert(SlaveConfigMessage::SlaveInfo::Layout::size == 9,
+              "SlaveInfo wire size");
+static_assert(RstMessage::SlaveRstInfo::Layout::size == 7,
+              "SlaveRstInfo wire size");
+
 // SlaveConfigMessage 实现
-std::vector<uint8_t> SlaveConfigMessage::serialize() const {
-    std::vector<uint8_t> result;
-    result.push_back(slaveNum);
+size_t SlaveConfigMessage::serializedSize() const {
+    return 1 + Codec::arraySize(slaves);
+}
 
-    for (const auto &slave : slaves) {
-        // Write slave ID (4 bytes, little endian)
-        ByteUtils::writeUint32LE(result, slave.id);
-        result.push_back(slave.conductionNum);
-        result.push_back(slave.resistanceNum);
-        result.push_back(slave.clipMode);
-        // Write clip status (2 bytes, little endian)
-        ByteUtils::writeUint16LE(result, slave.clipStatus);
-    }
+size_t SlaveConfigMessage::serializeInto(uint8_t *out, size_t capacity) const {
+    size_t size = serializedSize();
+    if (capacity < size)
+        return 0;
 
-    return result;
+    out[0] = slaveNum;
+    Codec::storeArray(slaves, out + 1);
+    return size;
 }
 
-bool SlaveConfigMessage::deserialize(const std::vector<uint8_t> &data) {
+bool SlaveConfigMessage::deserialize(ByteView data) {
     if (data.size() < 1)
         return false;
 
     slaveNum = data[0];
-    slaves.clear();
-
-    size_t offset = 1;
-    for (uint8_t i = 0; i < slaveNum; ++i) {
-        if (offset + 9 > data.size())
-            return false; // Each slave info is 9 bytes
-
-        SlaveInfo slave;
-        slave.id = ByteUtils::readUint32LE(data, offset);
-        slave.conductionNum = data[offset + 4];
-        slave.resistanceNum = data[offset + 5];
-        slave.clipMode = data[offset + 6];
-        slave.clipStatus = ByteUtils::readUint16LE(data, offset + 7);
-
-        slaves.push_back(slave);
-        offset += 9;
-    }
-
-    return true;
-}
-
-// ModeConfigMessage 实现
-std::vector<uint8_t> ModeConfigMessage::serialize() const { return {mode}; }
-
-bool ModeConfigMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 1)
-        return false;
-    mode = data[0];
-    return true;
+    return Codec::loadArray(data.subview(1), slaveNum, slaves);
 }
 
 // RstMessage 实现
-std::vector<uint8_t> RstMessage::serialize() const {
-    std::vector<uint8_t> result;
-    result.push_back(slaveNum);
-
-    for (const auto &slave : slaves) {
-        // Write slave ID (4 bytes, little endian)
-        ByteUtils::writeUint32LE(result, slave.id);
-        result.push_back(slave.lock);
-        // Write clip status (2 bytes, little endian)
-        ByteUtils::writeUint16LE(result, slave.clipStatus);
-    }
-
-    return result;
+size_t RstMessage::serializedSize() const {
+    return 1 + Codec::arraySize(slaves);
 }
 
-bool RstMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 1)
-        return false;
-
-    slaveNum = data[0];
-    slaves.clear();
-
-    size_t offset = 1;
-    for (uint8_t i = 0; i < slaveNum; ++i) {
-        if (offset + 7 > data.size())
-            return false; // Each slave rst info is 7 bytes
-
-        SlaveRstInfo slave;
-        slave.id = ByteUtils::readUint32LE(data, offset);
-        slave.lock = data[offset + 4];
-        slave.clipStatus = ByteUtils::readUint16LE(data, offset + 5);
+size_t RstMessage::serializeInto(uint8_t *out, size_t capacity) const {
+    size_t size = serializedSize();
+    if (capacity < size)
+        return 0;
 
-        slaves.push_back(slave);
-        offset += 7;
-    }
-
-    return true;
+    out[0] = slaveNum;
+    Codec::storeArray(slaves, out + 1);
+    return size;
 }
 
-// CtrlMessage 实现
-std::vector<uint8_t> CtrlMessage::serialize() const { return {runningStatus}; }
-
-bool CtrlMessage::deserialize(const std::vector<uint8_t> &data) {
+bool RstMessage::deserialize(ByteView data) {
     if (data.size() < 1)
         return false;
-    runningStatus = data[0];
-    return true;
-}
-
-// PingCtrlMessage 实现
-std::vector<uint8_t> PingCtrlMessage::serialize() const {
-    std::vector<uint8_t> result;
-    result.push_back(pingMode);
-
-    // Write ping count (2 bytes, little endian)
-    ByteUtils::writeUint16LE(result, pingCount);
 
-    // Write interval (2 bytes, little endian)
-    ByteUtils::writeUint16LE(result, interval);
-
-    // Write destination ID (4 bytes, little endian)
-    ByteUtils::writeUint32LE(result, destinationId);
-
-    return result;
-}
-
-bool PingCtrlMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 9)
-        return false;
-
-    pingMode = data[0];
-    pingCount = ByteUtils::readUint16LE(data, 1);
-    interval = ByteUtils::readUint16LE(data, 3);
-    destinationId = ByteUtils::readUint32LE(data, 5);
-
-    return true;
-}
-
-// DeviceListReqMessage 实现
-std::vector<uint8_t> DeviceListReqMessage::serialize() const {
-    return {reserve};
-}
-
-bool DeviceListReqMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 1)
-        return false;
-    reserve = data[0];
-    return true;
+    slaveNum = data[0];
+    return Codec::loadArray(data.subview(1), slaveNum, slaves);
 }
 
 } // namespace Backend2Master
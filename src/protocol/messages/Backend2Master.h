@@ -16,24 +16,32 @@ class SlaveConfigMessage : public Message {
         uint8_t resistanceNum;
         uint8_t clipMode;
         uint16_t clipStatus;
+
+        using Layout = Codec::Layout<
+            Codec::Field<&SlaveInfo::id>,
+            Codec::Field<&SlaveInfo::conductionNum>,
+            Codec::Field<&SlaveInfo::resistanceNum>,
+            Codec::Field<&SlaveInfo::clipMode>,
+            Codec::Field<&SlaveInfo::clipStatus>>;
     };
 
     uint8_t slaveNum;
     std::vector<SlaveInfo> slaves;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    size_t serializedSize() const override;
+    size_t serializeInto(uint8_t *out, size_t capacity) const override;
+    bool deserialize(ByteView data) override;
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Backend2MasterMessageId::SLAVE_CFG_MSG);
     }
 };
 
-class ModeConfigMessage : public Message {
+class ModeConfigMessage : public FixedLayoutMessage<ModeConfigMessage> {
   public:
     uint8_t mode;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<Codec::Field<&ModeConfigMessage::mode>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Backend2MasterMessageId::MODE_CFG_MSG);
     }
@@ -45,49 +53,59 @@ class RstMessage : public Message {
         uint32_t id;
         uint8_t lock;
         uint16_t clipStatus;
+
+        using Layout = Codec::Layout<
+            Codec::Field<&SlaveRstInfo::id>,
+            Codec::Field<&SlaveRstInfo::lock>,
+            Codec::Field<&SlaveRstInfo::clipStatus>>;
     };
 
     uint8_t slaveNum;
     std::vector<SlaveRstInfo> slaves;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    size_t serializedSize() const override;
+    size_t serializeInto(uint8_t *out, size_t capacity) const override;
+    bool deserialize(ByteView data) override;
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Backend2MasterMessageId::SLAVE_RST_MSG);
     }
 };
 
-class CtrlMessage : public Message {
+class CtrlMessage : public FixedLayoutMessage<CtrlMessage> {
   public:
     uint8_t runningStatus;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<Codec::Field<&CtrlMessage::runningStatus>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Backend2MasterMessageId::CTRL_MSG);
     }
 };
 
-class PingCtrlMessage : public Message {
+class PingCtrlMessage : public FixedLayoutMessage<PingCtrlMessage> {
   public:
     uint8_t pingMode;
     uint16_t pingCount;
     uint16_t interval;
     uint32_t destinationId;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&PingCtrlMessage::pingMode>,
+        Codec::Field<&PingCtrlMessage::pingCount>,
+        Codec::Field<&PingCtrlMessage::interval>,
+        Codec::Field<&PingCtrlMessage::destinationId>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Backend2MasterMessageId::PING_CTRL_MSG);
     }
 };
 
-class DeviceListReqMessage : public Message {
+class DeviceListReqMessage : public FixedLayoutMessage<DeviceListReqMessage> {
   public:
     uint8_t reserve;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<Codec::Field<&DeviceListReqMessage::reserve>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(
             Backend2MasterMessageId::DEVICE_LIST_REQ_MSG);
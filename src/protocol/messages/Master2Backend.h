@@ -16,26 +16,37 @@ class SlaveConfigResponseMessage : public Message {
         uint8_t resistanceNum;
         uint8_t clipMode;
         uint16_t clipStatus;
+
+        using Layout = Codec::Layout<
+            Codec::Field<&SlaveInfo::id>,
+            Codec::Field<&SlaveInfo::conductionNum>,
+            Codec::Field<&SlaveInfo::resistanceNum>,
+            Codec::Field<&SlaveInfo::clipMode>,
+            Codec::Field<&SlaveInfo::clipStatus>>;
     };
 
     uint8_t status;
     uint8_t slaveNum;
     std::vector<SlaveInfo> slaves;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    size_t serializedSize() const override;
+    size_t serializeInto(uint8_t *out, size_t capacity) const override;
+    bool deserialize(ByteView data) override;
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2BackendMessageId::SLAVE_CFG_RSP_MSG);
     }
 };
 
-class ModeConfigResponseMessage : public Message {
+class ModeConfigResponseMessage
+    : public FixedLayoutMessage<ModeConfigResponseMessage> {
   public:
     uint8_t status;
     uint8_t mode;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&ModeConfigResponseMessage::status>,
+        Codec::Field<&ModeConfigResponseMessage::mode>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2BackendMessageId::MODE_CFG_RSP_MSG);
     }
@@ -47,40 +58,52 @@ class RstResponseMessage : public Message {
         uint32_t id;
         uint8_t lock;
         uint16_t clipStatus;
+
+        using Layout = Codec::Layout<
+            Codec::Field<&SlaveRstInfo::id>,
+            Codec::Field<&SlaveRstInfo::lock>,
+            Codec::Field<&SlaveRstInfo::clipStatus>>;
     };
 
     uint8_t status;
     uint8_t slaveNum;
     std::vector<SlaveRstInfo> slaves;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    size_t serializedSize() const override;
+    size_t serializeInto(uint8_t *out, size_t capacity) const override;
+    bool deserialize(ByteView data) override;
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2BackendMessageId::RST_RSP_MSG);
     }
 };
 
-class CtrlResponseMessage : public Message {
+class CtrlResponseMessage : public FixedLayoutMessage<CtrlResponseMessage> {
   public:
     uint8_t status;
     uint8_t runningStatus;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&CtrlResponseMessage::status>,
+        Codec::Field<&CtrlResponseMessage::runningStatus>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2BackendMessageId::CTRL_RSP_MSG);
     }
 };
 
-class PingResponseMessage : public Message {
+class PingResponseMessage : public FixedLayoutMessage<PingResponseMessage> {
   public:
     uint8_t pingMode;
     uint16_t totalCount;
     uint16_t successCount;
     uint32_t destinationId;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&PingResponseMessage::pingMode>,
+        Codec::Field<&PingResponseMessage::totalCount>,
+        Codec::Field<&PingResponseMessage::successCount>,
+        Codec::Field<&PingResponseMessage::destinationId>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2BackendMessageId::PING_RES_MSG);
     }
@@ -95,13 +118,22 @@ class DeviceListResponseMessage : public Message {
         uint8_t versionMajor;
         uint8_t versionMinor;
         uint16_t versionPatch;
+
+        using Layout = Codec::Layout<
+            Codec::Field<&DeviceInfo::deviceId>,
+            Codec::Field<&DeviceInfo::shortId>,
+            Codec::Field<&DeviceInfo::online>,
+            Codec::Field<&DeviceInfo::versionMajor>,
+            Codec::Field<&DeviceInfo::versionMinor>,
+            Codec::Field<&DeviceInfo::versionPatch>>;
     };
 
     uint8_t deviceCount;
     std::vector<DeviceInfo> devices;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    size_t serializedSize() const override;
+    size_t serializeInto(uint8_t *out, size_t capacity) const override;
+    bool deserialize(ByteView data) override;
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(
             Master2BackendMessageId::DEVICE_LIST_RSP_MSG);
@@ -7,19 +7,22 @@
 namespace WhtsProtocol {
 namespace Master2Slave {
 
-class SyncMessage : public Message {
+class SyncMessage : public FixedLayoutMessage<SyncMessage> {
   public:
     uint8_t mode;
     uint32_t timestamp;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&SyncMessage::mode>,
+        Codec::Field<&SyncMessage::timestamp>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::SYNC_MSG);
     }
 };
 
-class ConductionConfigMessage : public Message {
+class ConductionConfigMessage
+    : public FixedLayoutMessage<ConductionConfigMessage> {
   public:
     uint8_t timeSlot;
     uint8_t interval;
@@ -27,14 +30,20 @@ class ConductionConfigMessage : public Message {
     uint16_t startConductionNum;
     uint16_t conductionNum;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&ConductionConfigMessage::timeSlot>,
+        Codec::Field<&ConductionConfigMessage::interval>,
+        Codec::Field<&ConductionConfigMessage::totalConductionNum>,
+        Codec::Field<&ConductionConfigMessage::startConductionNum>,
+        Codec::Field<&ConductionConfigMessage::conductionNum>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::CONDUCTION_CFG_MSG);
     }
 };
 
-class ResistanceConfigMessage : public Message {
+class ResistanceConfigMessage
+    : public FixedLayoutMessage<ResistanceConfigMessage> {
   public:
     uint8_t timeSlot;
     uint8_t interval;
@@ -42,89 +51,118 @@ class ResistanceConfigMessage : public Message {
     uint16_t startNum;
     uint16_t num;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&ResistanceConfigMessage::timeSlot>,
+        Codec::Field<&ResistanceConfigMessage::interval>,
+        Codec::Field<&ResistanceConfigMessage::totalNum>,
+        Codec::Field<&ResistanceConfigMessage::startNum>,
+        Codec::Field<&ResistanceConfigMessage::num>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::RESISTANCE_CFG_MSG);
     }
 };
 
-class ClipConfigMessage : public Message {
+class ClipConfigMessage : public FixedLayoutMessage<ClipConfigMessage> {
   public:
     uint8_t interval;
     uint8_t mode;
     uint16_t clipPin;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&ClipConfigMessage::interval>,
+        Codec::Field<&ClipConfigMessage::mode>,
+        Codec::Field<&ClipConfigMessage::clipPin>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::CLIP_CFG_MSG);
     }
 };
 
-class ReadConductionDataMessage : public Message {
+class ReadConductionDataMessage
+    : public FixedLayoutMessage<ReadConductionDataMessage> {
   public:
-    uint8_t reserve;
+    // 数据压缩确认 (见 utils/DataCodec.h): 0 为原始格式 (旧版本)，
+    // 0xFF 请求完整数据，其余为主机已解码的最近周期序号
+    uint8_t ackSequence;
+
+    using Layout =
+        Codec::Layout<Codec::Field<&ReadConductionDataMessage::ackSequence>>;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::READ_COND_DATA_MSG);
     }
 };
 
-class ReadResistanceDataMessage : public Message {
+class ReadResistanceDataMessage
+    : public FixedLayoutMessage<ReadResistanceDataMessage> {
   public:
-    uint8_t reserve;
+    // 数据压缩确认 (见 utils/DataCodec.h): 0 为原始格式 (旧版本)，
+    // 0xFF 请求完整数据，其余为主机已解码的最近周期序号
+    uint8_t ackSequence;
+
+    using Layout =
+        Codec::Layout<Codec::Field<&ReadResistanceDataMessage::ackSequence>>;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::READ_RES_DATA_MSG);
     }
 };
 
-class ReadClipDataMessage : public Message {
+class ReadClipDataMessage : public FixedLayoutMessage<ReadClipDataMessage> {
   public:
     uint8_t reserve;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<Codec::Field<&ReadClipDataMessage::reserve>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::READ_CLIP_DATA_MSG);
     }
 };
 
-class RstMessage : public Message {
+class RstMessage : public FixedLayoutMessage<RstMessage> {
   public:
     uint8_t lockStatus;
     uint16_t clipLed;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&RstMessage::lockStatus>,
+        Codec::Field<&RstMessage::clipLed>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::RST_MSG);
     }
 };
 
-class PingReqMessage : public Message {
+class PingReqMessage : public FixedLayoutMessage<PingReqMessage> {
   public:
     uint16_t sequenceNumber;
     uint32_t timestamp;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&PingReqMessage::sequenceNumber>,
+        Codec::Field<&PingReqMessage::timestamp>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::PING_REQ_MSG);
     }
 };
 
-class ShortIdAssignMessage : public Message {
+class ShortIdAssignMessage
+    : public ExtensibleLayoutMessage<ShortIdAssignMessage> {
   public:
     uint8_t shortId;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    // 能力协商结果 (见 Capabilities.h)，仅回复给携带扩展的 Announce
+    bool hasExtension = false;
+    uint16_t capabilities = 0;  // 双方都支持的能力
+    uint16_t maxReceiveMtu = 0; // 主机能接收的最大帧长
+
+    using Layout = Codec::Layout<Codec::Field<&ShortIdAssignMessage::shortId>>;
+    using Extension =
+        Codec::Layout<Codec::Field<&ShortIdAssignMessage::capabilities>,
+                      Codec::Field<&ShortIdAssignMessage::maxReceiveMtu>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::SHORT_ID_ASSIGN_MSG);
     }
@@ -1,6 +1,9 @@
 #ifndef WHTS_PROTOCOL_MESSAGE_H
 #define WHTS_PROTOCOL_MESSAGE_H
 
+#include "../utils/ByteView.h"
+#include "../utils/FieldCodec.h"
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -10,11 +13,77 @@ namespace WhtsProtocol {
 class Message {
   public:
     virtual ~Message() = default;
-    virtual std::vector<uint8_t> serialize() const = 0;
-    virtual bool deserialize(const std::vector<uint8_t> &data) = 0;
+
+    // 序列化后的字节数
+    virtual size_t serializedSize() const = 0;
+
+    // 直接序列化到调用方提供的缓冲区，返回写入的字节数
+    // 缓冲区不足 serializedSize() 时不写入并返回0
+    virtual size_t serializeInto(uint8_t *out, size_t capacity) const = 0;
+
+    // 序列化为新分配的 vector (基于 serializeInto 实现)
+    std::vector<uint8_t> serialize() const {
+        std::vector<uint8_t> result(serializedSize());
+        serializeInto(result.data(), result.size());
+        return result;
+    }
+
+    // 从字节视图反序列化，std::vector 可隐式转换为 ByteView
+    virtual bool deserialize(ByteView data) = 0;
     virtual uint8_t getMessageId() const = 0;
 };
 
+// 固定长度消息基类
+// 派生类以 Layout 声明字段布局，序列化、反序列化和线上长度
+// 均由布局在编译期生成
+template <typename Derived> class FixedLayoutMessage : public Message {
+  public:
+    size_t serializedSize() const override { return Derived::Layout::size; }
+
+    size_t serializeInto(uint8_t *out, size_t capacity) const override {
+        return Derived::Layout::write(static_cast<const Derived &>(*this), out,
+                                      capacity);
+    }
+
+    bool deserialize(ByteView data) override {
+        return Derived::Layout::read(static_cast<Derived &>(*this), data);
+    }
+};
+
+// 带可选扩展字段的定长消息基类
+// 派生类以 Layout 声明基本字段、以 Extension 声明追加在其后的扩展字段，
+// 并提供 bool hasExtension 成员。旧版本接收方只读取基本字段 (忽略尾部数据)；
+// 新版本接收方在数据足够时读取扩展字段，否则将 hasExtension 置为false
+template <typename Derived> class ExtensibleLayoutMessage : public Message {
+  public:
+    size_t serializedSize() const override {
+        return Derived::Layout::size +
+               (self().hasExtension ? Derived::Extension::size : 0);
+    }
+
+    size_t serializeInto(uint8_t *out, size_t capacity) const override {
+        size_t size = serializedSize();
+        if (capacity < size)
+            return 0;
+        Derived::Layout::store(self(), out);
+        if (self().hasExtension)
+            Derived::Extension::store(self(), out + Derived::Layout::size);
+        return size;
+    }
+
+    bool deserialize(ByteView data) override {
+        Derived &derived = static_cast<Derived &>(*this);
+        if (!Derived::Layout::read(derived, data))
+            return false;
+        derived.hasExtension = Derived::Extension::read(
+            derived, data.subview(Derived::Layout::size));
+        return true;
+    }
+
+  private:
+    const Derived &self() const { return static_cast<const Derived &>(*this); }
+};
+
 } // namespace WhtsProtocol
 
 #endif // WHTS_PROTOCOL_MESSAGE_H
\ No newline at end of file
@@ -1,61 +1,115 @@
 #include "Slave2Backend.h"
+#include "../utils/ByteUtils.h"
+#include <cstring>
 
 namespace WhtsProtocol {
 namespace Slave2Backend {
 
-// ConductionDataMessage 实现
-std::vector<uint8_t> ConductionDataMessage::serialize() const {
-    std::vector<uint8_t> result;
-    result.push_back(conductionLength & 0xFF);
-    result.push_back((conductionLength >> 8) & 0xFF);
-    result.insert(result.end(), conductionData.begin(), conductionData.end());
-    return result;
+// 线上长度校验: 字段布局变化时在编译期报错
+static_assert(ClipDataMessage::Layout::size == 2, "ClipDataMessage wire size");
+
+namespace {
+
+// 原始格式: u16 长度 + 数据
+// 编码格式: u16 (解码后长度 | ENCODED_LENGTH_FLAG) + 编码字节 + 周期序号 +
+//           参考序号 + u16 载荷长度 + 编码载荷
+constexpr size_t RAW_PREFIX_SIZE = 2;
+constexpr size_t ENCODED_PREFIX_SIZE = 7;
+
+size_t dataSerializedSize(bool encoded, const std::vector<uint8_t> &data) {
+    return (encoded ? ENCODED_PREFIX_SIZE : RAW_PREFIX_SIZE) + data.size();
+}
+
+size_t serializeData(bool encoded, const DataCodec::EncodedHeader &encoding,
+                     uint16_t length, const std::vector<uint8_t> &data,
+                     uint8_t *out, size_t capacity) {
+    size_t size = dataSerializedSize(encoded, data);
+    if (capacity < size)
+        return 0;
+
+    size_t prefix = RAW_PREFIX_SIZE;
+    if (encoded) {
+        uint16_t lengthField =
+            static_cast<uint16_t>(length | DataCodec::ENCODED_LENGTH_FLAG);
+        ByteUtils::storeUint16LE(out, lengthField);
+        out[2] = encoding.encoding;
+        out[3] = encoding.sequence;
+        out[4] = encoding.baseSequence;
+        ByteUtils::storeUint16LE(out + 5, static_cast<uint16_t>(data.size()));
+        prefix = ENCODED_PREFIX_SIZE;
+    } else {
+        ByteUtils::storeUint16LE(out, length);
+    }
+    if (!data.empty())
+        std::memcpy(out + prefix, data.data(), data.size());
+    return size;
 }
 
-bool ConductionDataMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 2)
+bool deserializeData(ByteView in, bool &encoded,
+                     DataCodec::EncodedHeader &encoding, uint16_t &length,
+                     std::vector<uint8_t> &data) {
+    if (in.size() < RAW_PREFIX_SIZE)
+        return false;
+    uint16_t lengthField = in[0] | (in[1] << 8);
+    encoded = (lengthField & DataCodec::ENCODED_LENGTH_FLAG) != 0;
+
+    if (!encoded) {
+        length = lengthField;
+        if (in.size() < RAW_PREFIX_SIZE + length)
+            return false;
+        data.assign(in.begin() + RAW_PREFIX_SIZE,
+                    in.begin() + RAW_PREFIX_SIZE + length);
+        encoding = DataCodec::EncodedHeader();
+        return true;
+    }
+
+    if (in.size() < ENCODED_PREFIX_SIZE)
         return false;
-    conductionLength = data[0] | (data[1] << 8);
-    if (data.size() < 2 + conductionLength)
+    length = static_cast<uint16_t>(lengthField &
+                                   ~DataCodec::ENCODED_LENGTH_FLAG);
+    encoding.encoding = in[2];
+    encoding.sequence = in[3];
+    encoding.baseSequence = in[4];
+    size_t bodySize = in[5] | (in[6] << 8);
+    if (in.size() < ENCODED_PREFIX_SIZE + bodySize)
         return false;
-    conductionData.assign(data.begin() + 2,
-                          data.begin() + 2 + conductionLength);
+    data.assign(in.begin() + ENCODED_PREFIX_SIZE,
+                in.begin() + ENCODED_PREFIX_SIZE + bodySize);
     return true;
 }
 
-// ResistanceDataMessage 实现
-std::vector<uint8_t> ResistanceDataMessage::serialize() const {
-    std::vector<uint8_t> result;
-    result.push_back(resistanceLength & 0xFF);
-    result.push_back((resistanceLength >> 8) & 0xFF);
-    result.insert(result.end(), resistanceData.begin(), resistanceData.end());
-    return result;
+} // namespace
+
+// ConductionDataMessage 实现
+size_t ConductionDataMessage::serializedSize() const {
+    return dataSerializedSize(encoded, conductionData);
 }
 
-bool ResistanceDataMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 2)
-        return false;
-    resistanceLength = data[0] | (data[1] << 8);
-    if (data.size() < 2 + resistanceLength)
-        return false;
-    resistanceData.assign(data.begin() + 2,
-                          data.begin() + 2 + resistanceLength);
-    return true;
+size_t ConductionDataMessage::serializeInto(uint8_t *out,
+                                            size_t capacity) const {
+    return serializeData(encoded, encoding, conductionLength, conductionData,
+                         out, capacity);
 }
 
-// ClipDataMessage 实现
-std::vector<uint8_t> ClipDataMessage::serialize() const {
-    std::vector<uint8_t> result;
-    result.push_back(clipData & 0xFF);
-    result.push_back((clipData >> 8) & 0xFF);
-    return result;
+bool ConductionDataMessage::deserialize(ByteView data) {
+    return deserializeData(data, encoded, encoding, conductionLength,
+                           conductionData);
 }
 
-bool ClipDataMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 2)
-        return false;
-    clipData = data[0] | (data[1] << 8);
-    return true;
+// ResistanceDataMessage 实现
+size_t ResistanceDataMessage::serializedSize() const {
+    return dataSerializedSize(encoded, resistanceData);
+}
+
+size_t ResistanceDataMessage::serializeInto(uint8_t *out,
+                                            size_t capacity) const {
+    return serializeData(encoded, encoding, resistanceLength, resistanceData,
+                         out, capacity);
+}
+
+bool ResistanceDataMessage::deserialize(ByteView data) {
+    return deserializeData(data, encoded, encoding, resistanceLength,
+                           resistanceData);
 }
 
 } // namespace Slave2Backend
@@ -2,6 +2,7 @@
 #define WHTS_PROTOCOL_SLAVE2BACKEND_H
 
 #include "../Common.h"
+#include "../utils/DataCodec.h"
 #include "Message.h"
 
 namespace WhtsProtocol {
@@ -12,8 +13,14 @@ class ConductionDataMessage : public Message {
     uint16_t conductionLength;
     std::vector<uint8_t> conductionData;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    // 压缩编码 (见 utils/DataCodec.h)
+    // encoded 为 true 时 conductionData 为编码载荷，conductionLength 为解码后长度
+    bool encoded = false;
+    DataCodec::EncodedHeader encoding;
+
+    size_t serializedSize() const override;
+    size_t serializeInto(uint8_t *out, size_t capacity) const override;
+    bool deserialize(ByteView data) override;
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(
             Slave2BackendMessageId::CONDUCTION_DATA_MSG);
@@ -25,20 +32,26 @@ class ResistanceDataMessage : public Message {
     uint16_t resistanceLength;
     std::vector<uint8_t> resistanceData;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    // 压缩编码 (见 utils/DataCodec.h)
+    // encoded 为 true 时 resistanceData 为编码载荷，resistanceLength 为解码后长度
+    bool encoded = false;
+    DataCodec::EncodedHeader encoding;
+
+    size_t serializedSize() const override;
+    size_t serializeInto(uint8_t *out, size_t capacity) const override;
+    bool deserialize(ByteView data) override;
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(
             Slave2BackendMessageId::RESISTANCE_DATA_MSG);
     }
 };
 
-class ClipDataMessage : public Message {
+class ClipDataMessage : public FixedLayoutMessage<ClipDataMessage> {
   public:
     uint16_t clipData;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<Codec::Field<&ClipDataMessage::clipData>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Slave2BackendMessageId::CLIP_DATA_MSG);
     }
@@ -7,7 +7,8 @@
 namespace WhtsProtocol {
 namespace Slave2Master {
 
-class ConductionConfigResponseMessage : public Message {
+class ConductionConfigResponseMessage
+    : public FixedLayoutMessage<ConductionConfigResponseMessage> {
   public:
     uint8_t status;
     uint8_t timeSlot;
@@ -16,15 +17,22 @@ class ConductionConfigResponseMessage : public Message {
     uint16_t startConductionNum;
     uint16_t conductionNum;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&ConductionConfigResponseMessage::status>,
+        Codec::Field<&ConductionConfigResponseMessage::timeSlot>,
+        Codec::Field<&ConductionConfigResponseMessage::interval>,
+        Codec::Field<&ConductionConfigResponseMessage::totalConductionNum>,
+        Codec::Field<&ConductionConfigResponseMessage::startConductionNum>,
+        Codec::Field<&ConductionConfigResponseMessage::conductionNum>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(
             Slave2MasterMessageId::CONDUCTION_CFG_RSP_MSG);
     }
 };
 
-class ResistanceConfigResponseMessage : public Message {
+class ResistanceConfigResponseMessage
+    : public FixedLayoutMessage<ResistanceConfigResponseMessage> {
   public:
     uint8_t status;
     uint8_t timeSlot;
@@ -33,74 +41,104 @@ class ResistanceConfigResponseMessage : public Message {
     uint16_t startConductionNum;
     uint16_t conductionNum;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&ResistanceConfigResponseMessage::status>,
+        Codec::Field<&ResistanceConfigResponseMessage::timeSlot>,
+        Codec::Field<&ResistanceConfigResponseMessage::interval>,
+        Codec::Field<&ResistanceConfigResponseMessage::totalConductionNum>,
+        Codec::Field<&ResistanceConfigResponseMessage::startConductionNum>,
+        Codec::Field<&ResistanceConfigResponseMessage::conductionNum>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(
             Slave2MasterMessageId::RESISTANCE_CFG_RSP_MSG);
     }
 };
 
-class ClipConfigResponseMessage : public Message {
+class ClipConfigResponseMessage
+    : public FixedLayoutMessage<ClipConfigResponseMessage> {
   public:
     uint8_t status;
     uint8_t interval;
     uint8_t mode;
     uint16_t clipPin;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&ClipConfigResponseMessage::status>,
+        Codec::Field<&ClipConfigResponseMessage::interval>,
+        Codec::Field<&ClipConfigResponseMessage::mode>,
+        Codec::Field<&ClipConfigResponseMessage::clipPin>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Slave2MasterMessageId::CLIP_CFG_RSP_MSG);
     }
 };
 
-class RstResponseMessage : public Message {
+class RstResponseMessage : public FixedLayoutMessage<RstResponseMessage> {
   public:
     uint8_t status;
     uint8_t lockStatus;
     uint16_t clipLed;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&RstResponseMessage::status>,
+        Codec::Field<&RstResponseMessage::lockStatus>,
+        Codec::Field<&RstResponseMessage::clipLed>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Slave2MasterMessageId::RST_RSP_MSG);
     }
 };
 
-class PingRspMessage : public Message {
+class PingRspMessage : public FixedLayoutMessage<PingRspMessage> {
   public:
     uint16_t sequenceNumber;
     uint32_t timestamp;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&PingRspMessage::sequenceNumber>,
+        Codec::Field<&PingRspMessage::timestamp>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Slave2MasterMessageId::PING_RSP_MSG);
     }
 };
 
-class AnnounceMessage : public Message {
+class AnnounceMessage : public ExtensibleLayoutMessage<AnnounceMessage> {
   public:
     uint32_t deviceId;
     uint8_t versionMajor;
     uint8_t versionMinor;
     uint16_t versionPatch;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    // 能力协商扩展 (见 Capabilities.h)，旧版本固件不携带
+    bool hasExtension = false;
+    uint16_t capabilities = 0;  // Capability 位图
+    uint16_t maxReceiveMtu = 0; // 能接收的最大帧长，0表示默认
+
+    using Layout = Codec::Layout<
+        Codec::Field<&AnnounceMessage::deviceId>,
+        Codec::Field<&AnnounceMessage::versionMajor>,
+        Codec::Field<&AnnounceMessage::versionMinor>,
+        Codec::Field<&AnnounceMessage::versionPatch>>;
+    using Extension =
+        Codec::Layout<Codec::Field<&AnnounceMessage::capabilities>,
+                      Codec::Field<&AnnounceMessage::maxReceiveMtu>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Slave2MasterMessageId::ANNOUNCE_MSG);
     }
 };
 
-class ShortIdConfirmMessage : public Message {
+class ShortIdConfirmMessage : public FixedLayoutMessage<ShortIdConfirmMessage> {
   public:
     uint8_t status;
     uint8_t shortId;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Layout = Codec::Layout<
+        Codec::Field<&ShortIdConfirmMessage::status>,
+        Codec::Field<&ShortIdConfirmMessage::shortId>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(
             Slave2MasterMessageId::SHORT_ID_CONFIRM_MSG);
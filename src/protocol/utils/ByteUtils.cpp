@@ -16,15 +16,13 @@ void ByteUtils::writeUint32LE(std::vector<uint8_t> &buffer, uint32_t value) {
     buffer.push_back((value >> 24) & 0xFF);
 }
 
-uint16_t ByteUtils::readUint16LE(const std::vector<uint8_t> &buffer,
-                                 size_t offset) {
+uint16_t ByteUtils::readUint16LE(ByteView buffer, size_t offset) {
     if (offset + 1 >= buffer.size())
         return 0;
     return buffer[offset] | (buffer[offset + 1] << 8);
 }
 
-uint32_t ByteUtils::readUint32LE(const std::vector<uint8_t> &buffer,
-                                 size_t offset) {
+uint32_t ByteUtils::readUint32LE(ByteView buffer, size_t offset) {
     if (offset + 3 >= buffer.size())
         return 0;
     return buffer[offset] | (buffer[offset + 1] << 8) |
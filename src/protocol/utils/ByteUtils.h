@@ -1,6 +1,7 @@
 #ifndef WHTS_PROTOCOL_BYTE_UTILS_H
 #define WHTS_PROTOCOL_BYTE_UTILS_H
 
+#include "ByteView.h"
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -14,11 +15,21 @@ class ByteUtils {
     static void writeUint16LE(std::vector<uint8_t> &buffer, uint16_t value);
     static void writeUint32LE(std::vector<uint8_t> &buffer, uint32_t value);
 
+    // 写入小端序数据到原始缓冲区 (调用方保证空间足够)
+    static void storeUint16LE(uint8_t *out, uint16_t value) {
+        out[0] = static_cast<uint8_t>(value & 0xFF);
+        out[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+    }
+    static void storeUint32LE(uint8_t *out, uint32_t value) {
+        out[0] = static_cast<uint8_t>(value & 0xFF);
+        out[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+        out[2] = static_cast<uint8_t>((value >> 16) & 0xFF);
+        out[3] = static_cast<uint8_t>((value >> 24) & 0xFF);
+    }
+
     // 读取小端序数据
-    static uint16_t readUint16LE(const std::vector<uint8_t> &buffer,
-                                 size_t offset);
-    static uint32_t readUint32LE(const std::vector<uint8_t> &buffer,
-                                 size_t offset);
+    static uint16_t readUint16LE(ByteView buffer, size_t offset);
+    static uint32_t readUint32LE(ByteView buffer, size_t offset);
 
     // 字节数组转十六进制字符串
     static std::string bytesToHexString(const std::vector<uint8_t> &data,
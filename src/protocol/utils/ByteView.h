@@ -0,0 +1,54 @@
+#ifndef WHTS_PROTOCOL_BYTE_VIEW_H
+#define WHTS_PROTOCOL_BYTE_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WhtsProtocol {
+
+// 非拥有的只读字节视图 (指针 + 长度)
+// 用于在接收缓冲区上直接解析帧和消息，避免中间拷贝。
+// 视图不延长底层数据的生命周期，调用方需保证数据在使用期间有效。
+class ByteView {
+  public:
+    constexpr ByteView() : data_(nullptr), size_(0) {}
+    constexpr ByteView(const uint8_t *data, size_t size)
+        : data_(data), size_(size) {}
+
+    // 允许从 std::vector 隐式构造，兼容旧的 vector 接口调用方
+    ByteView(const std::vector<uint8_t> &buffer)
+        : data_(buffer.data()), size_(buffer.size()) {}
+
+    constexpr const uint8_t *data() const { return data_; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+
+    constexpr const uint8_t *begin() const { return data_; }
+    constexpr const uint8_t *end() const { return data_ + size_; }
+
+    constexpr uint8_t operator[](size_t index) const { return data_[index]; }
+
+    // 截取子视图，超出范围的部分会被截断
+    constexpr ByteView subview(size_t offset,
+                               size_t count = static_cast<size_t>(-1)) const {
+        if (offset >= size_)
+            return ByteView(data_ + size_, 0);
+        size_t remaining = size_ - offset;
+        return ByteView(data_ + offset,
+                        count < remaining ? count : remaining);
+    }
+
+    // 拷贝为拥有所有权的 vector (仅在确实需要保存数据时使用)
+    std::vector<uint8_t> toVector() const {
+        return std::vector<uint8_t>(begin(), end());
+    }
+
+  private:
+    const uint8_t *data_;
+    size_t size_;
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_BYTE_VIEW_H
@@ -0,0 +1,137 @@
+#include "Crc.h"
+#include "FieldCodec.h"
+
+#if defined(WHTS_CRC_IMPL_HW) &&                                               \
+    (defined(__SSE4_2__) || (defined(_MSC_VER) && defined(_M_X64)))
+#define WHTS_CRC_USE_SSE42 1
+#include <nmmintrin.h>
+#elif defined(WHTS_CRC_IMPL_HW) && defined(__ARM_FEATURE_CRC32)
+#define WHTS_CRC_USE_ARM_CRC32 1
+#include <arm_acle.h>
+#elif defined(WHTS_CRC_IMPL_HW) || defined(WHTS_CRC_IMPL_SLICE8)
+// 指令集不可用时硬件实现回退到切片查表
+#define WHTS_CRC_USE_SLICE8 1
+#endif
+
+namespace WhtsProtocol {
+namespace Crc {
+
+namespace {
+
+constexpr uint16_t CRC16_POLY = 0x1021;
+constexpr uint32_t CRC32C_POLY = 0x82F63B78; // 反射形式
+
+struct Crc16Table {
+    uint16_t entries[256];
+};
+
+struct Crc32Tables {
+    uint32_t entries[8][256];
+};
+
+constexpr Crc16Table makeCrc16Table() {
+    Crc16Table table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint16_t crc = static_cast<uint16_t>(i << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000)
+                      ? static_cast<uint16_t>((crc << 1) ^ CRC16_POLY)
+                      : static_cast<uint16_t>(crc << 1);
+        }
+        table.entries[i] = crc;
+    }
+    return table;
+}
+
+// entries[0] 为逐字节表，entries[k] 为其后第k个字节位置的切片表
+constexpr Crc32Tables makeCrc32Tables() {
+    Crc32Tables tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+        tables.entries[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (int k = 1; k < 8; ++k) {
+            uint32_t prev = tables.entries[k - 1][i];
+            tables.entries[k][i] = (prev >> 8) ^ tables.entries[0][prev & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr Crc16Table CRC16_TABLE = makeCrc16Table();
+
+#if !defined(WHTS_CRC_USE_SSE42) && !defined(WHTS_CRC_USE_ARM_CRC32)
+constexpr Crc32Tables CRC32C_TABLES = makeCrc32Tables();
+
+inline uint32_t crc32cBytes(uint32_t crc, const uint8_t *data, size_t size) {
+    const auto &table = CRC32C_TABLES.entries[0];
+    for (size_t i = 0; i < size; ++i)
+        crc = (crc >> 8) ^ table[(crc ^ data[i]) & 0xFF];
+    return crc;
+}
+#endif
+
+} // namespace
+
+uint16_t crc16(const uint8_t *data, size_t size, uint16_t crc) {
+    for (size_t i = 0; i < size; ++i) {
+        crc = static_cast<uint16_t>(
+            (crc << 8) ^ CRC16_TABLE.entries[((crc >> 8) ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+uint32_t crc32c(const uint8_t *data, size_t size, uint32_t crc) {
+    crc = ~crc;
+
+#if defined(WHTS_CRC_USE_SSE42)
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t crc64 = crc;
+    for (; size >= 8; size -= 8, data += 8)
+        crc64 = _mm_crc32_u64(crc64, Codec::loadLE<uint64_t>(data));
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    for (; size >= 4; size -= 4, data += 4)
+        crc = _mm_crc32_u32(crc, Codec::loadLE<uint32_t>(data));
+    for (; size > 0; --size, ++data)
+        crc = _mm_crc32_u8(crc, *data);
+#elif defined(WHTS_CRC_USE_ARM_CRC32)
+    for (; size >= 8; size -= 8, data += 8)
+        crc = __crc32cd(crc, Codec::loadLE<uint64_t>(data));
+    for (; size > 0; --size, ++data)
+        crc = __crc32cb(crc, *data);
+#elif defined(WHTS_CRC_USE_SLICE8)
+    const auto &t = CRC32C_TABLES.entries;
+    for (; size >= 8; size -= 8, data += 8) {
+        uint32_t lo = Codec::loadLE<uint32_t>(data) ^ crc;
+        uint32_t hi = Codec::loadLE<uint32_t>(data + 4);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+              t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^ t[3][hi & 0xFF] ^
+              t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^
+              t[0][hi >> 24];
+    }
+    crc = crc32cBytes(crc, data, size);
+#else
+    crc = crc32cBytes(crc, data, size);
+#endif
+
+    return ~crc;
+}
+
+const char *crc32cImplementation() {
+#if defined(WHTS_CRC_USE_SSE42)
+    return "sse4.2";
+#elif defined(WHTS_CRC_USE_ARM_CRC32)
+    return "armv8-crc32";
+#elif defined(WHTS_CRC_USE_SLICE8)
+    return "slice-by-8";
+#else
+    return "table";
+#endif
+}
+
+} // namespace Crc
+} // namespace WhtsProtocol
@@ -0,0 +1,29 @@
+#ifndef WHTS_PROTOCOL_CRC_H
+#define WHTS_PROTOCOL_CRC_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace WhtsProtocol {
+namespace Crc {
+
+// CRC-16/CCITT-FALSE (多项式 0x1021，初值 0xFFFF，无结果异或)
+// 单张256项查找表，适合资源受限的嵌入式端
+constexpr uint16_t CRC16_INIT = 0xFFFF;
+uint16_t crc16(const uint8_t *data, size_t size, uint16_t crc = CRC16_INIT);
+
+// CRC-32C (Castagnoli，反射多项式 0x82F63B78)
+// 实现在编译期选择 (见 protocol/utils/CMakeLists.txt 中的 WHTS_CRC_IMPL):
+//   WHTS_CRC_IMPL_HW     SSE4.2 / ARMv8 CRC32 指令，不可用时回退到切片查表
+//   WHTS_CRC_IMPL_SLICE8 8表切片，每次处理8字节
+//   其他                 单表逐字节
+// crc 传入上一次的结果即可分段计算
+uint32_t crc32c(const uint8_t *data, size_t size, uint32_t crc = 0);
+
+// 当前编译所用 CRC-32C 实现的名称 (用于日志)
+const char *crc32cImplementation();
+
+} // namespace Crc
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_CRC_H
@@ -0,0 +1,242 @@
+#include "DataCodec.h"
+#include "ByteUtils.h"
+#include <cstring>
+
+namespace WhtsProtocol {
+namespace DataCodec {
+
+namespace {
+
+constexpr size_t MAX_RUN = 128;
+constexpr uint8_t ZERO_RUN_FLAG = 0x80;
+constexpr size_t SPARSE_ENTRY_SIZE = 3;
+
+void encodeZeroRle(ByteView data, std::vector<uint8_t> &out) {
+    size_t size = data.size();
+    size_t i = 0;
+    while (i < size) {
+        size_t run = 0;
+        while (i + run < size && data[i + run] == 0 && run < MAX_RUN)
+            ++run;
+
+        // 两个及以上的0 (或末尾的单个0) 编码为游程
+        if (run >= 2 || (run == 1 && i + 1 == size)) {
+            out.push_back(static_cast<uint8_t>(ZERO_RUN_FLAG | (run - 1)));
+            i += run;
+            continue;
+        }
+
+        // 原样字节一直延续到下一对0
+        size_t start = i;
+        while (i < size && i - start < MAX_RUN &&
+               !(data[i] == 0 && i + 1 < size && data[i + 1] == 0))
+            ++i;
+        out.push_back(static_cast<uint8_t>(i - start - 1));
+        out.insert(out.end(), data.begin() + start, data.begin() + i);
+    }
+}
+
+bool decodeZeroRle(ByteView body, uint8_t *out, size_t size) {
+    size_t pos = 0;
+    size_t i = 0;
+    while (i < body.size()) {
+        uint8_t control = body[i++];
+        size_t count = (control & 0x7F) + 1;
+        if (pos + count > size)
+            return false;
+        if (control & ZERO_RUN_FLAG) {
+            std::memset(out + pos, 0, count);
+        } else {
+            if (i + count > body.size())
+                return false;
+            std::memcpy(out + pos, body.data() + i, count);
+            i += count;
+        }
+        pos += count;
+    }
+    return pos == size;
+}
+
+size_t countNonZero(ByteView data) {
+    size_t count = 0;
+    for (uint8_t byte : data)
+        count += byte != 0;
+    return count;
+}
+
+void encodeSparse(ByteView data, std::vector<uint8_t> &out) {
+    size_t start = out.size();
+    out.resize(start + 2);
+    uint16_t count = 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (data[i] == 0)
+            continue;
+        uint8_t entry[SPARSE_ENTRY_SIZE];
+        ByteUtils::storeUint16LE(entry, static_cast<uint16_t>(i));
+        entry[2] = data[i];
+        out.insert(out.end(), entry, entry + SPARSE_ENTRY_SIZE);
+        ++count;
+    }
+    ByteUtils::storeUint16LE(out.data() + start, count);
+}
+
+bool decodeSparse(ByteView body, uint8_t *out, size_t size) {
+    if (body.size() < 2)
+        return false;
+    size_t count = ByteUtils::readUint16LE(body, 0);
+    if (body.size() != 2 + count * SPARSE_ENTRY_SIZE)
+        return false;
+
+    std::memset(out, 0, size);
+    for (size_t i = 0; i < count; ++i) {
+        size_t entry = 2 + i * SPARSE_ENTRY_SIZE;
+        size_t offset = ByteUtils::readUint16LE(body, entry);
+        if (offset >= size)
+            return false;
+        out[offset] = body[entry + 2];
+    }
+    return true;
+}
+
+} // namespace
+
+void encode(Method method, ByteView data, std::vector<uint8_t> &out) {
+    switch (method) {
+    case Method::ZERO_RLE:
+        encodeZeroRle(data, out);
+        break;
+    case Method::SPARSE:
+        encodeSparse(data, out);
+        break;
+    default:
+        out.insert(out.end(), data.begin(), data.end());
+        break;
+    }
+}
+
+Method encodeBest(ByteView data, std::vector<uint8_t> &out) {
+    size_t start = out.size();
+    size_t sparseSize = 2 + countNonZero(data) * SPARSE_ENTRY_SIZE;
+
+    // 游程编码的长度只能实际编码后得到，不是最短时回退
+    encodeZeroRle(data, out);
+    size_t rleSize = out.size() - start;
+    if (rleSize <= sparseSize && rleSize <= data.size())
+        return Method::ZERO_RLE;
+
+    out.resize(start);
+    Method method = sparseSize < data.size() ? Method::SPARSE : Method::RAW;
+    encode(method, data, out);
+    return method;
+}
+
+bool decode(Method method, ByteView body, uint8_t *out, size_t size) {
+    switch (method) {
+    case Method::RAW:
+        if (body.size() != size)
+            return false;
+        if (size > 0)
+            std::memcpy(out, body.data(), size);
+        return true;
+    case Method::ZERO_RLE:
+        return decodeZeroRle(body, out, size);
+    case Method::SPARSE:
+        return decodeSparse(body, out, size);
+    default:
+        return false;
+    }
+}
+
+// DeltaEncoder 实现
+DeltaEncoder::DeltaEncoder() : nextSlot_(0), nextSequence_(1) {}
+
+const DeltaEncoder::Entry *DeltaEncoder::find(uint8_t sequence) const {
+    for (const auto &entry : history_) {
+        if (entry.sequence != 0 && entry.sequence == sequence)
+            return &entry;
+    }
+    return nullptr;
+}
+
+bool DeltaEncoder::encode(ByteView data, uint8_t ack, EncodedHeader &header,
+                          std::vector<uint8_t> &body) {
+    if (ack == ACK_LEGACY || data.size() > MAX_LENGTH)
+        return false;
+
+    header.sequence = nextSequence_;
+    nextSequence_ = nextSequence_ >= MAX_SEQUENCE
+                        ? 1
+                        : static_cast<uint8_t>(nextSequence_ + 1);
+    body.clear();
+
+    // 主机确认的周期仍在历史中且长度相同时做差分，否则发送完整数据
+    const Entry *base = ack != ACK_NONE ? find(ack) : nullptr;
+    if (base && base->data.size() == data.size()) {
+        delta_.resize(data.size());
+        for (size_t i = 0; i < data.size(); ++i)
+            delta_[i] = static_cast<uint8_t>(data[i] ^ base->data[i]);
+        Method method = encodeBest(ByteView(delta_), body);
+        header.encoding = static_cast<uint8_t>(DELTA_FLAG |
+                                               static_cast<uint8_t>(method));
+        header.baseSequence = ack;
+    } else {
+        header.encoding = static_cast<uint8_t>(encodeBest(data, body));
+        header.baseSequence = 0;
+    }
+
+    // 本周期覆盖最旧的历史槽位
+    Entry &slot = history_[nextSlot_];
+    slot.sequence = header.sequence;
+    slot.data.assign(data.begin(), data.end());
+    nextSlot_ = (nextSlot_ + 1) % HISTORY;
+    return true;
+}
+
+void DeltaEncoder::reset() {
+    for (auto &entry : history_) {
+        entry.sequence = 0;
+        entry.data.clear();
+    }
+    nextSlot_ = 0;
+    nextSequence_ = 1;
+}
+
+// DeltaDecoder 实现
+DeltaDecoder::DeltaDecoder() : sequence_(0) {}
+
+bool DeltaDecoder::decode(const EncodedHeader &header, ByteView body,
+                          size_t length, std::vector<uint8_t> &data) {
+    bool valid = (header.encoding & RESERVED_MASK) == 0 &&
+                 header.method() <= Method::SPARSE && length <= MAX_LENGTH &&
+                 header.sequence != 0 && header.sequence <= MAX_SEQUENCE;
+    // 差分必须基于当前参考周期
+    if (valid && header.isDelta()) {
+        valid = sequence_ != 0 && header.baseSequence == sequence_ &&
+                reference_.size() == length;
+    }
+
+    decoded_.resize(length);
+    if (!valid || !DataCodec::decode(header.method(), body, decoded_.data(),
+                                     length)) {
+        reset();
+        return false;
+    }
+
+    if (header.isDelta()) {
+        for (size_t i = 0; i < length; ++i)
+            decoded_[i] ^= reference_[i];
+    }
+
+    data.assign(decoded_.begin(), decoded_.end());
+    reference_.swap(decoded_);
+    sequence_ = header.sequence;
+    return true;
+}
+
+void DeltaDecoder::reset() {
+    sequence_ = 0;
+    reference_.clear();
+}
+
+} // namespace DataCodec
+} // namespace WhtsProtocol
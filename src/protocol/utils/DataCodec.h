@@ -0,0 +1,113 @@
+#ifndef WHTS_PROTOCOL_DATA_CODEC_H
+#define WHTS_PROTOCOL_DATA_CODEC_H
+
+#include "ByteView.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WhtsProtocol {
+namespace DataCodec {
+
+// 采集数据 (导通/阻值矩阵) 的压缩编码
+// 相邻周期的数据通常只有少数位不同，因此先与主机已确认的参考周期异或，
+// 再对以0为主的差分结果做游程或稀疏索引编码。
+
+// 编码方法 (编码字节 bit0-1)
+enum class Method : uint8_t {
+    RAW = 0,      // 原样存放
+    ZERO_RLE = 1, // 控制字节 c: c < 0x80 时后跟 c+1 个原样字节，
+                  // 否则表示 (c & 0x7F)+1 个0
+    SPARSE = 2,   // u16 非零字节数 + 每个非零字节的 (u16 偏移, u8 值)
+};
+
+constexpr uint8_t METHOD_MASK = 0x03;
+constexpr uint8_t DELTA_FLAG = 0x80; // 编码字节 bit7: 载荷为与参考周期的异或
+constexpr uint8_t RESERVED_MASK = 0x7C;
+
+// 数据消息长度字段最高位为1表示编码载荷，旧版本接收方会因长度越界而拒绝
+constexpr uint16_t ENCODED_LENGTH_FLAG = 0x8000;
+// 编码数据最大长度
+constexpr size_t MAX_LENGTH = 0x7FFF;
+
+// 读取请求中的确认字节
+// 旧版本主机固定发送0，从机据此继续发送原始格式
+constexpr uint8_t ACK_LEGACY = 0;
+// 主机支持编码但没有可用的参考周期，从机发送完整数据
+constexpr uint8_t ACK_NONE = 0xFF;
+// 周期序号在 [1, 254] 内循环，与上面两个值不冲突
+constexpr uint8_t MAX_SEQUENCE = 0xFE;
+
+// 编码载荷头
+struct EncodedHeader {
+    uint8_t encoding = 0;     // DELTA_FLAG | Method
+    uint8_t sequence = 0;     // 本次数据的周期序号
+    uint8_t baseSequence = 0; // 差分参考周期序号，非差分时为0
+
+    bool isDelta() const { return (encoding & DELTA_FLAG) != 0; }
+    Method method() const {
+        return static_cast<Method>(encoding & METHOD_MASK);
+    }
+};
+
+// 按指定方法编码 (追加到 out)
+void encode(Method method, ByteView data, std::vector<uint8_t> &out);
+// 选出编码后最短的方法并编码 (追加到 out)
+Method encodeBest(ByteView data, std::vector<uint8_t> &out);
+// 解码到 out[0, size)，载荷与长度不一致时返回false
+bool decode(Method method, ByteView body, uint8_t *out, size_t size);
+
+// 从机端差分编码器，每种数据一个实例
+// 保存最近发送的若干周期，主机确认的周期仍在其中时以它为参考做差分
+class DeltaEncoder {
+  public:
+    static constexpr size_t HISTORY = 4;
+
+    DeltaEncoder();
+
+    // 按主机读取请求中的确认字节编码 data
+    // 主机不支持编码 (ACK_LEGACY) 或数据过长时返回false，调用方发送原始格式
+    bool encode(ByteView data, uint8_t ack, EncodedHeader &header,
+                std::vector<uint8_t> &body);
+
+    void reset();
+
+  private:
+    struct Entry {
+        uint8_t sequence = 0; // 0表示空槽
+        std::vector<uint8_t> data;
+    };
+
+    const Entry *find(uint8_t sequence) const;
+
+    Entry history_[HISTORY];
+    size_t nextSlot_;
+    uint8_t nextSequence_;
+    std::vector<uint8_t> delta_;
+};
+
+// 主机端差分解码器，每个从机的每种数据一个实例
+class DeltaDecoder {
+  public:
+    DeltaDecoder();
+
+    // 解码编码载荷，成功后 data 为完整数据并成为新的参考周期
+    // 参考周期不匹配或载荷非法时返回false，并清除参考周期
+    bool decode(const EncodedHeader &header, ByteView body, size_t length,
+                std::vector<uint8_t> &data);
+
+    // 下一次读取请求中应携带的确认字节
+    uint8_t ackSequence() const { return sequence_ ? sequence_ : ACK_NONE; }
+
+    void reset();
+
+  private:
+    uint8_t sequence_; // 0表示没有参考周期
+    std::vector<uint8_t> reference_;
+    std::vector<uint8_t> decoded_;
+};
+
+} // namespace DataCodec
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_DATA_CODEC_H
@@ -0,0 +1,140 @@
+#include "DelimiterScan.h"
+#include <cstdint>
+#include <cstring>
+
+// 未显式指定实现时按目标平台自动选择
+#if !defined(WHTS_SCAN_IMPL_AVX2) && !defined(WHTS_SCAN_IMPL_SSE2) &&          \
+    !defined(WHTS_SCAN_IMPL_NEON) && !defined(WHTS_SCAN_IMPL_MEMCHR) &&        \
+    !defined(WHTS_SCAN_IMPL_SCALAR)
+#if defined(__AVX2__)
+#define WHTS_SCAN_IMPL_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#define WHTS_SCAN_IMPL_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define WHTS_SCAN_IMPL_NEON 1
+#else
+#define WHTS_SCAN_IMPL_MEMCHR 1
+#endif
+#endif
+
+#if defined(WHTS_SCAN_IMPL_AVX2) || defined(WHTS_SCAN_IMPL_SSE2)
+#include <immintrin.h>
+#elif defined(WHTS_SCAN_IMPL_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace WhtsProtocol {
+namespace Scan {
+
+namespace {
+
+#if defined(WHTS_SCAN_IMPL_AVX2) || defined(WHTS_SCAN_IMPL_SSE2) ||            \
+    defined(WHTS_SCAN_IMPL_NEON)
+// 最低位1的位置 (调用方保证 mask 非零)
+inline unsigned lowestBit(uint64_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+#endif
+
+} // namespace
+
+size_t findBytePairScalar(const uint8_t *data, size_t size, uint8_t first,
+                          uint8_t second) {
+    for (size_t i = 0; i + 1 < size; ++i) {
+        if (data[i] == first && data[i + 1] == second)
+            return i;
+    }
+    return SIZE_MAX;
+}
+
+size_t findBytePair(const uint8_t *data, size_t size, uint8_t first,
+                    uint8_t second) {
+    size_t i = 0;
+
+#if defined(WHTS_SCAN_IMPL_AVX2)
+    // 比较 data[i..i+31] 与 first、data[i+1..i+32] 与 second，两者按位与
+    const __m256i v1 = _mm256_set1_epi8(static_cast<char>(first));
+    const __m256i v2 = _mm256_set1_epi8(static_cast<char>(second));
+    for (; i + 32 < size; i += 32) {
+        __m256i a = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(data + i));
+        __m256i b = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(data + i + 1));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(a, v1),
+                             _mm256_cmpeq_epi8(b, v2))));
+        if (mask)
+            return i + lowestBit(mask);
+    }
+#endif
+
+#if defined(WHTS_SCAN_IMPL_AVX2) || defined(WHTS_SCAN_IMPL_SSE2)
+    const __m128i w1 = _mm_set1_epi8(static_cast<char>(first));
+    const __m128i w2 = _mm_set1_epi8(static_cast<char>(second));
+    for (; i + 16 < size; i += 16) {
+        __m128i a =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i b =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 1));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(a, w1), _mm_cmpeq_epi8(b, w2))));
+        if (mask)
+            return i + lowestBit(mask);
+    }
+#elif defined(WHTS_SCAN_IMPL_NEON)
+    const uint8x16_t v1 = vdupq_n_u8(first);
+    const uint8x16_t v2 = vdupq_n_u8(second);
+    for (; i + 16 < size; i += 16) {
+        uint8x16_t eq = vandq_u8(vceqq_u8(vld1q_u8(data + i), v1),
+                                 vceqq_u8(vld1q_u8(data + i + 1), v2));
+        // 每个字节压缩为4位，得到64位掩码
+        uint64_t mask = vget_lane_u64(
+            vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        if (mask)
+            return i + lowestBit(mask) / 4;
+    }
+#elif defined(WHTS_SCAN_IMPL_MEMCHR)
+    // memchr 跳到下一个首字节候选位置，再检查其后一个字节
+    while (i + 1 < size) {
+        const void *hit = std::memchr(data + i, first, size - 1 - i);
+        if (!hit)
+            return SIZE_MAX;
+        i = static_cast<size_t>(static_cast<const uint8_t *>(hit) - data);
+        if (data[i + 1] == second)
+            return i;
+        ++i;
+    }
+    return SIZE_MAX;
+#endif
+
+    // 向量宽度之外的尾部逐字节处理
+    size_t pos = findBytePairScalar(data + i, size - i, first, second);
+    return pos == SIZE_MAX ? SIZE_MAX : i + pos;
+}
+
+const char *implementation() {
+#if defined(WHTS_SCAN_IMPL_AVX2)
+    return "avx2";
+#elif defined(WHTS_SCAN_IMPL_SSE2)
+    return "sse2";
+#elif defined(WHTS_SCAN_IMPL_NEON)
+    return "neon";
+#elif defined(WHTS_SCAN_IMPL_MEMCHR)
+    return "memchr";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace Scan
+} // namespace WhtsProtocol
@@ -0,0 +1,28 @@
+#ifndef WHTS_PROTOCOL_DELIMITER_SCAN_H
+#define WHTS_PROTOCOL_DELIMITER_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace WhtsProtocol {
+namespace Scan {
+
+// 查找第一个满足 data[i] == first && data[i + 1] == second 的位置 i
+// 未找到时返回 SIZE_MAX
+// 实现在编译期选择 (见 protocol/utils/CMakeLists.txt 中的 WHTS_SCAN_IMPL):
+//   AVX2 / SSE2 (x86)、NEON (ARM) 每次比较一个向量宽度的相邻字节对，
+//   MEMCHR 用 memchr 跳到首字节候选位置，SCALAR 为逐字节比较
+size_t findBytePair(const uint8_t *data, size_t size, uint8_t first,
+                    uint8_t second);
+
+// 逐字节参考实现，与 findBytePair 语义完全一致 (用于基准与校验)
+size_t findBytePairScalar(const uint8_t *data, size_t size, uint8_t first,
+                          uint8_t second);
+
+// 当前编译所用实现的名称 (用于日志)
+const char *implementation();
+
+} // namespace Scan
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_DELIMITER_SCAN_H
@@ -0,0 +1,140 @@
+#ifndef WHTS_PROTOCOL_FIELD_CODEC_H
+#define WHTS_PROTOCOL_FIELD_CODEC_H
+
+#include "ByteView.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// 主机字节序检测: 小端主机上字段直接 memcpy，其余情况逐字节移位
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define WHTS_LITTLE_ENDIAN_HOST 1
+#endif
+#elif defined(_WIN32)
+#define WHTS_LITTLE_ENDIAN_HOST 1
+#endif
+
+namespace WhtsProtocol {
+namespace Codec {
+
+// 小端序存取 (调用方保证缓冲区空间足够)
+template <typename T> inline void storeLE(uint8_t *out, T value) {
+    static_assert(std::is_unsigned<T>::value, "field must be unsigned");
+#ifdef WHTS_LITTLE_ENDIAN_HOST
+    std::memcpy(out, &value, sizeof(T));
+#else
+    for (size_t i = 0; i < sizeof(T); ++i)
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+#endif
+}
+
+template <typename T> inline T loadLE(const uint8_t *in) {
+    static_assert(std::is_unsigned<T>::value, "field must be unsigned");
+    T value;
+#ifdef WHTS_LITTLE_ENDIAN_HOST
+    std::memcpy(&value, in, sizeof(T));
+#else
+    value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+        value |= static_cast<T>(static_cast<T>(in[i]) << (8 * i));
+#endif
+    return value;
+}
+
+template <typename M> struct MemberTraits;
+template <typename C, typename T> struct MemberTraits<T C::*> {
+    using Class = C;
+    using Type = T;
+};
+
+// 字段描述符: 指向数据成员的指针，线上按小端序、sizeof(成员类型) 字节编码
+template <auto Member> struct Field {
+    using Type = typename MemberTraits<decltype(Member)>::Type;
+    static_assert(std::is_unsigned<Type>::value,
+                  "only unsigned integer fields are supported");
+
+    static constexpr size_t size = sizeof(Type);
+
+    template <typename T> static void store(const T &obj, uint8_t *out) {
+        storeLE<Type>(out, obj.*Member);
+    }
+
+    template <typename T> static void load(T &obj, const uint8_t *in) {
+        obj.*Member = loadLE<Type>(in);
+    }
+};
+
+// 字段布局: 按声明顺序紧密排列的字段列表
+// 线上长度在编译期确定，读写在编译期展开为固定偏移的存取
+template <typename... Fields> struct Layout {
+    static constexpr size_t size = (Fields::size + ... + 0);
+
+    // 不做边界检查的写入/读取，调用方保证至少有 size 字节
+    template <typename T> static void store(const T &obj, uint8_t *out) {
+        size_t offset = 0;
+        ((Fields::store(obj, out + offset), offset += Fields::size), ...);
+        (void)offset;
+    }
+
+    template <typename T> static void load(T &obj, const uint8_t *in) {
+        size_t offset = 0;
+        ((Fields::load(obj, in + offset), offset += Fields::size), ...);
+        (void)offset;
+    }
+
+    // 带边界检查的写入，返回写入字节数，空间不足返回0
+    template <typename T>
+    static size_t write(const T &obj, uint8_t *out, size_t capacity) {
+        if (capacity < size)
+            return 0;
+        store(obj, out);
+        return size;
+    }
+
+    // 带边界检查的读取，数据不足返回false (多余的尾部数据被忽略)
+    template <typename T> static bool read(T &obj, ByteView data) {
+        if (data.size() < size)
+            return false;
+        load(obj, data.data());
+        return true;
+    }
+};
+
+// 定长元素数组 (元素类型以 T::Layout 描述字段布局)
+template <typename T> size_t arraySize(const std::vector<T> &items) {
+    return items.size() * T::Layout::size;
+}
+
+// 写入全部元素，返回写入后的位置 (调用方保证空间足够)
+template <typename T>
+uint8_t *storeArray(const std::vector<T> &items, uint8_t *out) {
+    for (const auto &item : items) {
+        T::Layout::store(item, out);
+        out += T::Layout::size;
+    }
+    return out;
+}
+
+// 读取 count 个元素，数据不足时返回false
+template <typename T>
+bool loadArray(ByteView data, size_t count, std::vector<T> &items) {
+    items.clear();
+    if (data.size() < count * T::Layout::size)
+        return false;
+
+    items.resize(count);
+    const uint8_t *in = data.data();
+    for (auto &item : items) {
+        T::Layout::load(item, in);
+        in += T::Layout::size;
+    }
+    return true;
+}
+
+} // namespace Codec
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_FIELD_CODEC_H
@@ -0,0 +1,85 @@
+#include "RingBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace WhtsProtocol {
+
+namespace {
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+} // namespace
+
+ByteRingBuffer::ByteRingBuffer(size_t capacity)
+    : storage_(roundUpToPowerOfTwo(capacity > 0 ? capacity : 1)),
+      mask_(storage_.size() - 1), head_(0), count_(0) {}
+
+size_t ByteRingBuffer::write(ByteView data) {
+    size_t toWrite = std::min(data.size(), available());
+    if (toWrite == 0)
+        return 0;
+
+    size_t tail = (head_ + count_) & mask_;
+    size_t firstPart = std::min(toWrite, storage_.size() - tail);
+    std::memcpy(storage_.data() + tail, data.data(), firstPart);
+    if (toWrite > firstPart) {
+        std::memcpy(storage_.data(), data.data() + firstPart,
+                    toWrite - firstPart);
+    }
+
+    count_ += toWrite;
+    return toWrite;
+}
+
+void ByteRingBuffer::consume(size_t count) {
+    count = std::min(count, count_);
+    head_ = (head_ + count) & mask_;
+    count_ -= count;
+    if (count_ == 0) {
+        // 空时复位读指针，使后续数据尽量保持连续
+        head_ = 0;
+    }
+}
+
+void ByteRingBuffer::clear() {
+    head_ = 0;
+    count_ = 0;
+}
+
+void ByteRingBuffer::segments(size_t offset, ByteView &first,
+                              ByteView &second) const {
+    if (offset >= count_) {
+        first = ByteView();
+        second = ByteView();
+        return;
+    }
+
+    size_t start = (head_ + offset) & mask_;
+    size_t length = count_ - offset;
+    size_t firstPart = std::min(length, storage_.size() - start);
+    first = ByteView(storage_.data() + start, firstPart);
+    second = ByteView(storage_.data(), length - firstPart);
+}
+
+ByteView ByteRingBuffer::peekContiguous(size_t offset, size_t length,
+                                        uint8_t *scratch) const {
+    if (offset >= count_ || length == 0)
+        return ByteView();
+    length = std::min(length, count_ - offset);
+
+    size_t start = (head_ + offset) & mask_;
+    size_t firstPart = std::min(length, storage_.size() - start);
+    if (firstPart == length) {
+        return ByteView(storage_.data() + start, length);
+    }
+
+    // 跨越回绕点，拼接到调用方提供的临时缓冲区
+    std::memcpy(scratch, storage_.data() + start, firstPart);
+    std::memcpy(scratch + firstPart, storage_.data(), length - firstPart);
+    return ByteView(scratch, length);
+}
+
+} // namespace WhtsProtocol
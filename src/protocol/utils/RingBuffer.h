@@ -0,0 +1,55 @@
+#ifndef WHTS_PROTOCOL_RING_BUFFER_H
+#define WHTS_PROTOCOL_RING_BUFFER_H
+
+#include "ByteView.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WhtsProtocol {
+
+// 固定容量的环形字节缓冲区
+// 写入与消费均为常数时间 (不做整体搬移)，容量向上取整为2的幂。
+// 缓冲区满时 write 只写入能放下的部分，由调用方决定如何处理剩余数据。
+class ByteRingBuffer {
+  public:
+    explicit ByteRingBuffer(size_t capacity);
+
+    size_t capacity() const { return storage_.size(); }
+    size_t size() const { return count_; }
+    size_t available() const { return storage_.size() - count_; }
+    bool empty() const { return count_ == 0; }
+
+    // 追加数据，返回实际写入的字节数
+    size_t write(ByteView data);
+
+    // 读取相对读指针偏移 offset 处的字节 (调用方保证 offset < size())
+    uint8_t at(size_t offset) const {
+        return storage_[(head_ + offset) & mask_];
+    }
+
+    // 丢弃前 count 个字节
+    void consume(size_t count);
+
+    void clear();
+
+    // 获取从 offset 开始的全部数据，分为最多两段连续视图
+    // 数据未跨越回绕点时 second 为空
+    void segments(size_t offset, ByteView &first, ByteView &second) const;
+
+    // 获取 [offset, offset + length) 的连续视图
+    // 数据未跨越回绕点时直接指向内部存储，否则拷贝到 scratch
+    // (scratch 至少需要 length 字节)
+    ByteView peekContiguous(size_t offset, size_t length,
+                            uint8_t *scratch) const;
+
+  private:
+    std::vector<uint8_t> storage_;
+    size_t mask_;
+    size_t head_;  // 读指针
+    size_t count_; // 当前数据量
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_RING_BUFFER_H
@@ -0,0 +1,79 @@
+#ifndef WHTS_PROTOCOL_SPSC_QUEUE_H
+#define WHTS_PROTOCOL_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace WhtsProtocol {
+
+// 单生产者单消费者无锁队列
+// 一个线程只调用 tryPush，另一个线程只调用 tryPop，无需互斥锁。
+// 槽位在构造时一次性创建且不会析构，入队与出队都通过 swap 交换对象:
+// 生产者交出数据并取回一个已被消费的旧对象，消费者取出数据并把手中的
+// 旧对象留在槽位中。对于 Frame 这类带 vector 的对象，载荷容量在两个
+// 线程之间循环复用，稳态下不再分配内存。
+// 容量向上取整为2的幂。
+template <typename T> class SpscQueue {
+  public:
+    explicit SpscQueue(size_t capacity)
+        : slots_(roundUpPowerOfTwo(capacity)), mask_(slots_.size() - 1),
+          head_(0), tail_(0) {}
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    size_t capacity() const { return slots_.size(); }
+
+    // 生产者线程调用，队列满时返回false且 item 不变
+    // 成功时 item 换回一个旧对象 (内容未定义，保留其容量)
+    bool tryPush(T &item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == slots_.size())
+            return false;
+        using std::swap;
+        swap(slots_[tail & mask_], item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者线程调用，队列空时返回false
+    // 成功时 item 原有的对象留在槽位中，供生产者复用
+    bool tryPop(T &item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+        using std::swap;
+        swap(item, slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似值，仅供统计使用
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) -
+               head_.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+
+  private:
+    static size_t roundUpPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    // 两个索引分别只由一端写入，放在不同缓存行避免伪共享
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    std::vector<T> slots_;
+    size_t mask_;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_; // 消费者写
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_; // 生产者写
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_SPSC_QUEUE_H